@@ -3,6 +3,8 @@
 
 #include "virtualization/screen/onionskin.hpp"
 
+#include "wormhole/socket.hpp"
+
 using namespace Plteen;
 
 /*************************************************************************************************/
@@ -155,6 +157,11 @@ void Plteen::Cosmos::on_game_start() {
 void Plteen::Cosmos::on_elapse(uint64_t count, uint32_t interval, uint64_t uptime) {
     this->begin_update_sequence();
 
+    // network datagrams are handled in the game thread, and before the world moves on
+    for (auto daemon : this->socket_daemons) {
+        daemon.first->deliver_mails(daemon.second);
+    }
+
     /**
      * By designe, the `Plane`s are abstracted as world chunks,
      *   As such, no need to update other planes here.
@@ -171,6 +178,22 @@ void Plteen::Cosmos::on_elapse(uint64_t count, uint32_t interval, uint64_t uptim
     this->end_update_sequence();
 }
 
+void Plteen::Cosmos::on_wakeup(SDL_UserEvent& wakeup) {
+    if (wakeup.code == socket_mailbox_wakeup_code) {
+        /**
+         * Only the timerless universe is woken up,
+         *   otherwise, mails are delivered in `on_elapse` with bounded cost per frame.
+         */
+        for (auto daemon : this->socket_daemons) {
+            if (daemon.first == wakeup.data1) {
+                this->begin_update_sequence();
+                daemon.first->deliver_mails(daemon.second);
+                this->end_update_sequence();
+            }
+        }
+    }
+}
+
 void Plteen::Cosmos::draw(dc_t* dc, int x, int y, int width, int height) {
     float flx = float(x);
     float fly = float(y);
@@ -256,6 +279,14 @@ const char* Plteen::Cosmos::usrdata_extension() {
     }
 }
 
+/*************************************************************************************************/
+void Plteen::Cosmos::bind_socket_daemon(SocketDaemon* daemon, size_t mails_per_frame) {
+    // NOTE: bind the daemon before starting its loop
+    if (daemon->enable_mailbox(mails_per_frame * 4U, (this->frame_rate() == 0U))) {
+        this->socket_daemons.push_back({ daemon, mails_per_frame });
+    }
+}
+
 /*************************************************************************************************/
 const char* Plteen::Cosmos::plane_name(int idx) {
     const char* pname = nullptr;
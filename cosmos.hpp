@@ -4,6 +4,8 @@
 #include "plane.hpp"
 #include "virtualization/screen.hpp"
 
+#include <vector>
+
 namespace Plteen {
     class __lambda__ Cosmos : public Plteen::IUniverse {
     public:
@@ -25,6 +27,10 @@ namespace Plteen {
         void transfer_to_next_plane() { this->transfer(1); }
         void transfer_to_prev_plane() { this->transfer(-1); }
 
+    public:
+        /* 网络线程收到的数据报在每帧开始时交给当前游戏世界处理，每帧最多处理 mails_per_frame 个 */
+        void bind_socket_daemon(Plteen::SocketDaemon* daemon, size_t mails_per_frame = 256U);
+
     public:
         size_t plane_count() { return this->chunk_count; }
         const char* plane_name(int idx);
@@ -46,6 +52,7 @@ namespace Plteen {
         void on_big_bang(int width, int height) override;
         void on_game_start() override;
         void on_elapse(uint64_t count, uint32_t interval, uint64_t uptime) override;
+        void on_wakeup(SDL_UserEvent& wakeup) override;
         const char* usrdata_extension() override;
 
     protected:
@@ -65,5 +72,8 @@ namespace Plteen {
 
     private:
         Plteen::IPlane* from_plane = nullptr;
+
+    private:
+        std::vector<std::pair<Plteen::SocketDaemon*, size_t>> socket_daemons;
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <sstream>
+#include <type_traits>
 
 #include "flonum.hpp"
 #include "except.hpp"
@@ -741,12 +742,17 @@ namespace Plteen {
 
     template<typename S, typename Lhs, typename Rhs>
     void array2d_multiply(S& self, const Lhs& lhs, const Rhs& rhs, size_t M, size_t N, size_t P) noexcept {
+        // the i-k-j order walks `rhs` by rows, every entry still sums its products in the order of `n`
         for (size_t r = 0; r < M; ++ r) {
             for (size_t c = 0; c < P; ++ c) {
                 self[r][c] = 0;
+            }
+
+            for (size_t n = 0; n < N; ++ n) {
+                auto x = lhs[r][n];
 
-                for (size_t n = 0; n < N; ++ n) {
-                    self[r][c] += lhs[r][n] * rhs[n][c];
+                for (size_t c = 0; c < P; ++ c) {
+                    self[r][c] += x * rhs[n][c];
                 }
             }
         }
@@ -904,6 +910,146 @@ namespace Plteen {
         return true;
     }
 
+    /**
+     * In-place LUP factorization with partial pivoting, O(n^3)
+     *   `self` keeps both triangles, the unit diagonal of `L` is implied,
+     *   row `r` of `PA` is row `P[r]` of `A`, and `sign` is that of the permutation.
+     *
+     * Rows are swapped entry by entry, so that they stay where they are in memory.
+     */
+    template<typename S, typename I>
+    bool array2d_lup_factorize(S& self, size_t N, I& P, int* sign) noexcept {
+        int parity = 1;
+
+        array1d_permutation_initialize(P, N);
+
+        for (size_t k = 0; k < N; ++ k) {
+            auto pivot = flabs(self[k][k]);
+            size_t tk = k;
+
+            for (size_t r = k + 1; r < N; ++ r) {
+                auto a = flabs(self[r][k]);
+
+                if (a > pivot) {
+                    pivot = a;
+                    tk = r;
+                }
+            }
+
+            // singular(non-invertible) matrix
+            if (pivot == 0) return false;
+
+            if (k != tk) {
+                using std::swap;
+
+                for (size_t c = 0; c < N; ++ c) {
+                    swap(self[k][c], self[tk][c]);
+                }
+
+                swap(P[k], P[tk]);
+                parity = -parity;
+            }
+
+            for (size_t r = k + 1; r < N; ++ r) {
+                auto l = self[r][k] / self[k][k];
+
+                self[r][k] = l;
+                for (size_t c = k + 1; c < N; ++ c) {
+                    self[r][c] -= l * self[k][c];
+                }
+            }
+        }
+
+        if (sign != nullptr) {
+            (*sign) = parity;
+        }
+
+        return true;
+    }
+
+    template<typename T, typename S>
+    T array2d_lup_determinant(const S& self, size_t N, int sign) noexcept {
+        T det = T(sign);
+
+        for (size_t k = 0; k < N; ++ k) {
+            det *= self[k][k];
+        }
+
+        return det;
+    }
+
+    /**
+     * Solves `AX = B` for the `N x C` matrix `X` with the factorization of `A`,
+     *   `X` must not be `B`, as the permutation reads `B` out of order.
+     */
+    template<typename S, typename I, typename B, typename X>
+    void array2d_lup_solve(const S& self, size_t N, const I& P, const B& b, X& x, size_t C) noexcept {
+        using Fl = std::decay_t<decltype(x[0][0])>;
+
+        for (size_t c = 0; c < C; ++ c) {
+            // forward substitution, Ly = Pb
+            for (size_t r = 0; r < N; ++ r) {
+                Fl y = Fl(b[P[r]][c]);
+
+                for (size_t k = 0; k < r; ++ k) {
+                    y -= self[r][k] * x[k][c];
+                }
+
+                x[r][c] = y;
+            }
+
+            // backward substitution, Ux = y
+            for (size_t r = N; r > 0; -- r) {
+                Fl y = x[r - 1][c];
+
+                for (size_t k = r; k < N; ++ k) {
+                    y -= self[r - 1][k] * x[k][c];
+                }
+
+                x[r - 1][c] = y / self[r - 1][r - 1];
+            }
+        }
+    }
+
+    /**
+     * Fraction-free Gaussian elimination (Bareiss), O(n^3)
+     *   every division is exact, so that integer determinants stay exact,
+     *   `self` is destroyed.
+     */
+    template<typename T, typename S>
+    T array2d_bareiss_determinant(S& self, size_t N) noexcept {
+        T sign = 1;
+        T prev = 1;
+
+        if (N == 0) return 1;
+
+        for (size_t k = 0; k + 1 < N; ++ k) {
+            if (self[k][k] == 0) {
+                size_t tk = k + 1;
+
+                while ((tk < N) && (self[tk][k] == 0)) ++ tk;
+                if (tk == N) return 0;
+
+                for (size_t c = k; c < N; ++ c) {
+                    using std::swap;
+                    swap(self[k][c], self[tk][c]);
+                }
+
+                sign = -sign;
+            }
+
+            for (size_t r = k + 1; r < N; ++ r) {
+                for (size_t c = k + 1; c < N; ++ c) {
+                    self[r][c] = (self[r][c] * self[k][k] - self[r][k] * self[k][c]) / prev;
+                }
+            }
+
+            prev = self[k][k];
+        }
+
+        return sign * self[N - 1][N - 1];
+    }
+
     /*********************************************************************************************/
     inline void array2d_check_bounds(size_t R, size_t C, size_t r, size_t c) {
         raise_range_error_if(R, r, "row");
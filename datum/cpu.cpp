@@ -0,0 +1,64 @@
+#include "cpu.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define __cpu_x86__
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+using namespace Plteen;
+
+/*************************************************************************************************/
+bool Plteen::cpu_supports_sse2() {
+    bool okay = false;
+
+#if defined(__cpu_x86__)
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuid(info, 0);
+
+    if (info[0] >= 1) {
+        __cpuid(info, 1);
+        okay = ((info[3] & (1 << 26)) != 0);
+    }
+#else
+    __builtin_cpu_init();
+    okay = __builtin_cpu_supports("sse2");
+#endif
+#endif
+
+    return okay;
+}
+
+bool Plteen::cpu_supports_avx2() {
+    bool okay = false;
+
+#if defined(__cpu_x86__)
+#if defined(_MSC_VER)
+    int info[4];
+    int max_leaf = 0;
+
+    __cpuid(info, 0);
+    max_leaf = info[0];
+
+    if (max_leaf >= 7) {
+        __cpuid(info, 1);
+
+        // OSXSAVE and AVX, and then XMM and YMM states enabled by the OS
+        if (((info[2] & (1 << 27)) != 0) && ((info[2] & (1 << 28)) != 0) && ((_xgetbv(0) & 0x6) == 0x6)) {
+            __cpuidex(info, 7, 0);
+            okay = ((info[1] & (1 << 5)) != 0);
+        }
+    }
+#else
+    __builtin_cpu_init();
+    okay = __builtin_cpu_supports("avx2");
+#endif
+#endif
+
+    return okay;
+}
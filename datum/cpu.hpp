@@ -0,0 +1,10 @@
+#pragma once
+
+namespace Plteen {
+    /**
+     * Runtime detection of SIMD extensions, for kernels that are dispatched at runtime.
+     * Both are `false` on non-x86 architectures.
+     */
+    __lambda__ bool cpu_supports_sse2();
+    __lambda__ bool cpu_supports_avx2(); // the OS must save the YMM registers as well
+}
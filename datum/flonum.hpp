@@ -11,6 +11,8 @@
 // check: https://www-pequan.lip6.fr/~graillat/papers/nolta07.pdf
 
 namespace Plteen {
+    typedef double Flonum; // as Racket's flonums
+
     // for non-flonums
     template<typename T> bool inline flisnan(T fx) { return false; }
     template<typename T> bool inline flisinfinity(T fx) { return false; }
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace Plteen {
+    /**
+     * Bounded lock-free queue for exactly one producer thread and one consumer thread,
+     *   the capacity is rounded up to a power of 2.
+     *
+     * The slot is reset to `T()` once popped, so that handles such as leases are released
+     *   on the consumer side right away.
+     */
+    template<typename T>
+    class SPSCQueue {
+    public:
+        SPSCQueue(size_t capacity) {
+            size_t n = 1U;
+
+            while (n < capacity) {
+                n <<= 1U;
+            }
+
+            this->mask = n - 1U;
+            this->slots = new T[n];
+        }
+
+        ~SPSCQueue() noexcept {
+            delete [] this->slots;
+        }
+
+        SPSCQueue(const SPSCQueue<T>&) = delete;
+        SPSCQueue<T>& operator=(const SPSCQueue<T>&) = delete;
+
+    public: /* producer side */
+        bool push(const T& datum) {
+            size_t tail = this->tail.load(std::memory_order_relaxed);
+            bool okay = this->has_room(tail);
+
+            if (okay) {
+                this->slots[tail & this->mask] = datum;
+                this->tail.store(tail + 1U, std::memory_order_release);
+            }
+
+            return okay;
+        }
+
+        bool push(T&& datum) {
+            size_t tail = this->tail.load(std::memory_order_relaxed);
+            bool okay = this->has_room(tail);
+
+            if (okay) {
+                this->slots[tail & this->mask] = std::move(datum);
+                this->tail.store(tail + 1U, std::memory_order_release);
+            }
+
+            return okay;
+        }
+
+    public: /* consumer side */
+        bool pop(T* datum) {
+            size_t head = this->head.load(std::memory_order_relaxed);
+            bool okay = true;
+
+            if (head == this->tail_cache) {
+                this->tail_cache = this->tail.load(std::memory_order_acquire);
+                okay = (head != this->tail_cache);
+            }
+
+            if (okay) {
+                T& slot = this->slots[head & this->mask];
+
+                (*datum) = std::move(slot);
+                slot = T();
+                this->head.store(head + 1U, std::memory_order_release);
+            }
+
+            return okay;
+        }
+
+    public: /* approximate if called by neither side */
+        size_t capacity() const { return this->mask + 1U; }
+        bool empty() const { return this->size() == 0U; }
+
+        size_t size() const {
+            size_t tail = this->tail.load(std::memory_order_acquire);
+            size_t head = this->head.load(std::memory_order_acquire);
+
+            return (tail >= head) ? (tail - head) : 0U;
+        }
+
+    private:
+        bool has_room(size_t tail) {
+            if (tail - this->head_cache > this->mask) {
+                this->head_cache = this->head.load(std::memory_order_acquire);
+            }
+
+            return (tail - this->head_cache <= this->mask);
+        }
+
+    private:
+        T* slots;
+        size_t mask;
+
+    private: // on separate cache lines to avoid false sharing between the two sides
+        alignas(64) std::atomic<size_t> head { 0U };
+        size_t tail_cache = 0U;
+        alignas(64) std::atomic<size_t> tail { 0U };
+        size_t head_cache = 0U;
+    };
+}
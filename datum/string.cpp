@@ -3,8 +3,20 @@
 #include "fixnum.hpp"
 #include "bytes.hpp"
 #include "char.hpp"
+#include "cpu.hpp"
 
 #include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define __utf8_x86__
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define __utf8_neon__
+#include <arm_neon.h>
+#endif
 
 using namespace Plteen;
 
@@ -412,6 +424,251 @@ size_t Plteen::scan_skip_this_line(const char* src, size_t* pos, size_t end) {
 }
 
 /************************************************************************************************/
+/**
+ * UTF-8 kernels, chosen at runtime as the color batch kernels are
+ *   `count_leading` counts the bytes that are not `10xx xxxx`, which is the number of codepoints for valid UTF-8,
+ *   `ascii_prefix` skips ASCII bytes in whole vectors, it might stop before the first non-ASCII byte.
+ */
+namespace {
+    struct UTF8Kernels {
+        size_t (*count_leading)(const uint8_t*, size_t);
+        size_t (*ascii_prefix)(const uint8_t*, size_t);
+    };
+
+    static const size_t utf8_block_size = 64U;
+    static const size_t utf8_index_stride = 64U;
+}
+
+namespace scalar {
+    static size_t count_leading(const uint8_t* s, size_t n) {
+        size_t count = 0;
+
+        for (size_t i = 0; i < n; ++ i) {
+            count += ((s[i] & 0b11000000U) != 0b10000000U);
+        }
+
+        return count;
+    }
+
+    static size_t ascii_prefix(const uint8_t* s, size_t n) {
+        size_t i = 0;
+
+        while ((i < n) && (s[i] < 0x80U)) ++ i;
+
+        return i;
+    }
+
+    static const UTF8Kernels kernels = { count_leading, ascii_prefix };
+}
+
+#if defined(__utf8_x86__)
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace sse2 {
+    static size_t count_leading(const uint8_t* s, size_t n) {
+        const __m128i continuation = _mm_set1_epi8(-65); // 1011 1111, as signed bytes, continuation bytes are not greater
+        const __m128i zero = _mm_setzero_si128();
+        size_t count = 0;
+        size_t i = 0;
+
+        while (i + 16U <= n) {
+            size_t stop = std::min(n, i + 16U * 255U); // before the bytewise counters overflow
+            __m128i acc = zero;
+
+            for (; i + 16U <= stop; i += 16U) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+
+                acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(v, continuation));
+            }
+
+            acc = _mm_sad_epu8(acc, zero);
+            count += size_t(_mm_cvtsi128_si32(acc)) + size_t(_mm_extract_epi16(acc, 4));
+        }
+
+        return count + scalar::count_leading(s + i, n - i);
+    }
+
+    static size_t ascii_prefix(const uint8_t* s, size_t n) {
+        size_t i = 0;
+
+        for (; i + 16U <= n; i += 16U) {
+            if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i))) != 0) break;
+        }
+
+        return i + scalar::ascii_prefix(s + i, n - i);
+    }
+
+    static const UTF8Kernels kernels = { count_leading, ascii_prefix };
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+    static size_t count_leading(const uint8_t* s, size_t n) {
+        const __m256i continuation = _mm256_set1_epi8(-65);
+        const __m256i zero = _mm256_setzero_si256();
+        size_t count = 0;
+        size_t i = 0;
+
+        while (i + 32U <= n) {
+            size_t stop = std::min(n, i + 32U * 255U);
+            __m256i acc = zero;
+            uint64_t sums[4];
+
+            for (; i + 32U <= stop; i += 32U) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+
+                acc = _mm256_sub_epi8(acc, _mm256_cmpgt_epi8(v, continuation));
+            }
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums), _mm256_sad_epu8(acc, zero));
+            count += size_t(sums[0] + sums[1] + sums[2] + sums[3]);
+        }
+
+        return count + sse2::count_leading(s + i, n - i);
+    }
+
+    static size_t ascii_prefix(const uint8_t* s, size_t n) {
+        size_t i = 0;
+
+        for (; i + 32U <= n; i += 32U) {
+            if (_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i))) != 0) break;
+        }
+
+        return i + sse2::ascii_prefix(s + i, n - i);
+    }
+
+    static const UTF8Kernels kernels = { count_leading, ascii_prefix };
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
+
+#if defined(__utf8_neon__)
+namespace neon {
+    static size_t count_leading(const uint8_t* s, size_t n) {
+        const int8x16_t continuation = vdupq_n_s8(-65);
+        size_t count = 0;
+        size_t i = 0;
+
+        while (i + 16U <= n) {
+            size_t stop = std::min(n, i + 16U * 255U);
+            uint8x16_t acc = vdupq_n_u8(0);
+
+            for (; i + 16U <= stop; i += 16U) {
+                int8x16_t v = vreinterpretq_s8_u8(vld1q_u8(s + i));
+
+                acc = vsubq_u8(acc, vcgtq_s8(v, continuation));
+            }
+
+            count += size_t(vaddlvq_u8(acc));
+        }
+
+        return count + scalar::count_leading(s + i, n - i);
+    }
+
+    static size_t ascii_prefix(const uint8_t* s, size_t n) {
+        size_t i = 0;
+
+        for (; i + 16U <= n; i += 16U) {
+            if (vmaxvq_u8(vld1q_u8(s + i)) >= 0x80U) break;
+        }
+
+        return i + scalar::ascii_prefix(s + i, n - i);
+    }
+
+    static const UTF8Kernels kernels = { count_leading, ascii_prefix };
+}
+#endif
+
+static const UTF8Kernels* utf8_kernels_best() {
+    const UTF8Kernels* best = &scalar::kernels;
+
+#if defined(__utf8_x86__)
+    if (cpu_supports_avx2()) {
+        best = &avx2::kernels;
+    } else if (cpu_supports_sse2()) {
+        best = &sse2::kernels;
+    }
+#elif defined(__utf8_neon__)
+    best = &neon::kernels;
+#endif
+
+    return best;
+}
+
+static inline const UTF8Kernels* utf8_kernels() {
+    static const UTF8Kernels* kernels = utf8_kernels_best();
+
+    return kernels;
+}
+
+static inline size_t utf8_extent(const char* src, int max0) { // stops at the first '\0' as well
+    const char* eos = nullptr;
+    size_t max = 0;
+
+    if (max0 >= 0) {
+        eos = static_cast<const char*>(memchr(src, '\0', size_t(max0)));
+        max = (eos == nullptr) ? size_t(max0) : size_t(eos - src);
+    } else {
+        max = strlen(src);
+    }
+
+    return max;
+}
+
+static uint32_t utf8_decode(const char* src, size_t code_idx, size_t max) {
+    unsigned char c = static_cast<unsigned char>(src[code_idx]);
+    uint32_t codepoint = 0;
+
+    if (c < 0b10000000U) {
+        codepoint = c;
+    } else if (c >= 0b11110000U) {
+        if (code_idx + 3 < max) {
+            uint32_t b1 = c & 0b00000111U;
+            uint32_t b2 = static_cast<unsigned char>(src[code_idx + 1]) & 0b00111111U;
+            uint32_t b3 = static_cast<unsigned char>(src[code_idx + 2]) & 0b00111111U;
+            uint32_t b4 = static_cast<unsigned char>(src[code_idx + 3]) & 0b00111111U;
+
+            codepoint = (b1 << 18) | (b2 << 12) | (b3 << 6) | b4;
+        }
+    } else if (c >= 0b11100000U) {
+        if (code_idx + 2 < max) {
+            uint32_t b1 = c & 0b00001111U;
+            uint32_t b2 = static_cast<unsigned char>(src[code_idx + 1]) & 0b00111111U;
+            uint32_t b3 = static_cast<unsigned char>(src[code_idx + 2]) & 0b00111111U;
+
+            codepoint = (b1 << 12) | (b2 << 6) | b3;
+        }
+    } else {
+        if (code_idx + 1 < max) {
+            uint32_t b1 = c & 0b00011111U;
+            uint32_t b2 = static_cast<unsigned char>(src[code_idx + 1]) & 0b00111111U;
+
+            codepoint = (b1 << 6) | b2;
+        }
+    }
+
+    return codepoint;
+}
+
+/*************************************************************************************************/
 /**
  * UTF-8 encodes characters in 1 to 4 bytes, and their binary forms are:
  *   0xxx xxxx
@@ -421,27 +678,9 @@ size_t Plteen::scan_skip_this_line(const char* src, size_t* pos, size_t end) {
  */
 
 size_t Plteen::string_utf8_length(const char* src, int max0) {
-    size_t max = (max0 >= 0) ? max0 : strlen(src);
-    size_t idx = 0;
-    size_t n = 0;
-
-    while ((idx < max) && (src[idx] != '\0')) {
-        unsigned char c = static_cast<unsigned char>(src[idx]);
-
-        n++;
-
-        if (c < 0b10000000U) {
-            idx ++;
-        } else if (c >= 0b11110000U) {
-            idx += 4;
-        } else if (c >= 0b11100000U) {
-            idx += 3;
-        } else {
-            idx += 2;
-        }
-    }
+    size_t max = utf8_extent(src, max0);
     
-    return n;
+    return utf8_kernels()->count_leading(reinterpret_cast<const uint8_t*>(src), max);
 }
 
 size_t Plteen::string_utf8_length(const std::string& src) {
@@ -449,30 +688,34 @@ size_t Plteen::string_utf8_length(const std::string& src) {
 }
 
 int Plteen::string_utf8_index(const char* src, int idx, int max0) {
-    size_t max = (max0 >= 0) ? max0 : strlen(src);
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+    const UTF8Kernels* kernels = utf8_kernels();
+    size_t max = utf8_extent(src, max0);
     size_t it = 0;
     int cidx = -1;
     int n = 0;
 
-    while ((it < max) && (src[it] != '\0')) {
-        if (n < idx) {
-            unsigned char c = static_cast<unsigned char>(src[it]);
+    // skips whole blocks whose leading bytes all come before the target
+    while ((it + utf8_block_size <= max) && (idx > n)) {
+        int c = int(kernels->count_leading(s + it, utf8_block_size));
 
-            if (c < 0b10000000U) {
-                it ++;
-            } else if (c >= 0b11110000U) {
-                it += 4;
-            } else if (c >= 0b11100000U) {
-                it += 3;
-            } else {
-                it += 2;
+        if (n + c > idx) break;
+        n += c;
+        it += utf8_block_size;
+    }
+
+    // the target is a leading byte, continuation bytes are skipped one by one
+    while (it < max) {
+        if ((s[it] & 0b11000000U) != 0b10000000U) {
+            if (n >= idx) {
+                cidx = int(it);
+                break;
             }
 
             n++;
-        } else {
-            cidx = int(it);
-            break;
         }
+
+        it ++;
     }
     
     return cidx;
@@ -483,47 +726,95 @@ int Plteen::string_utf8_index(const std::string& src, int char_idx) {
 }
 
 uint32_t Plteen::string_utf8_ref(const char* src, int idx, int max0) {
-    size_t max = (max0 >= 0) ? max0 : strlen(src);
-    size_t codepoint = 0;
-    int code_idx = string_utf8_index(src, idx, max0);
-
-    if (code_idx >= 0) {
-        unsigned char c = static_cast<unsigned char>(src[code_idx]);
-
-        if (c < 0b10000000U) {
-            codepoint = c;
-        } else if (c >= 0b11110000U) {
-            if (code_idx + 3 < max) {
-                size_t b1 = c & 0b00000111U;
-                size_t b2 = static_cast<unsigned char>(src[code_idx + 1]) & 0b00111111U;
-                size_t b3 = static_cast<unsigned char>(src[code_idx + 2]) & 0b00111111U;
-                size_t b4 = static_cast<unsigned char>(src[code_idx + 4]) & 0b00111111U;
-
-                codepoint = (b1 << 18) | (b2 << 12) | (b3 << 6) | b4;
-            }
-        } else if (c >= 0b11100000U) {
-            if (code_idx + 2 < max) {
-                size_t b1 = c & 0b00001111U;
-                size_t b2 = static_cast<unsigned char>(src[code_idx + 1]) & 0b00111111U;
-                size_t b3 = static_cast<unsigned char>(src[code_idx + 2]) & 0b00111111U;
- 
-                codepoint = (b1 << 12) | (b2 << 6) | b3;
-            }
+    size_t max = utf8_extent(src, max0);
+    int code_idx = string_utf8_index(src, idx, int(max));
+
+    return (code_idx >= 0) ? utf8_decode(src, size_t(code_idx), max) : 0U;
+}
+
+uint32_t Plteen::string_utf8_ref(const std::string& src, int idx) {
+    return string_utf8_ref(src.c_str(), idx, int(src.size()));
+}
+
+bool Plteen::string_utf8_validate(const char* src, size_t size) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+    const UTF8Kernels* kernels = utf8_kernels();
+    size_t idx = 0;
+
+    while (idx < size) {
+        uint8_t c = s[idx];
+        uint8_t lo = 0x80U;
+        uint8_t hi = 0xBFU;
+        size_t n = 0;
+
+        if (c < 0x80U) {
+            idx += kernels->ascii_prefix(s + idx, size - idx);
+            idx += (idx < size) && (s[idx] < 0x80U);
+            continue;
+        }
+
+        // the second byte has narrower ranges for overlongs, surrogates and codepoints beyond U+10FFFF
+        if ((c >= 0xC2U) && (c <= 0xDFU)) {
+            n = 2;
+        } else if ((c >= 0xE0U) && (c <= 0xEFU)) {
+            n = 3;
+            if (c == 0xE0U) lo = 0xA0U;
+            if (c == 0xEDU) hi = 0x9FU;
+        } else if ((c >= 0xF0U) && (c <= 0xF4U)) {
+            n = 4;
+            if (c == 0xF0U) lo = 0x90U;
+            if (c == 0xF4U) hi = 0x8FU;
         } else {
-            if (code_idx + 1 < max) {
-                size_t b1 = c & 0b00011111U;
-                size_t b2 = static_cast<unsigned char>(src[code_idx + 1]) & 0b00111111U; 
-                
-                codepoint = (b1 << 5) | b2;
-            }
+            return false;
         }
+
+        if (idx + n > size) return false;
+        if ((s[idx + 1] < lo) || (s[idx + 1] > hi)) return false;
+
+        for (size_t i = 2; i < n; ++ i) {
+            if ((s[idx + i] & 0b11000000U) != 0b10000000U) return false;
+        }
+
+        idx += n;
     }
 
-    return static_cast<uint32_t>(codepoint);
+    return true;
 }
 
-uint32_t Plteen::string_utf8_ref(const std::string& src, int idx) {
-    return string_utf8_ref(src.c_str(), idx, int(src.size()));
+bool Plteen::string_utf8_validate(const std::string& src) {
+    return string_utf8_validate(src.c_str(), src.size());
+}
+
+uint32_t Plteen::string_utf8_scan(const char* src, size_t* pos, size_t end) {
+    size_t idx = (*pos);
+    unsigned char c = static_cast<unsigned char>(src[idx]);
+    uint32_t codepoint = 0xFFFDU;
+    size_t size = 1;
+
+    if (c < 0b10000000U) {
+        codepoint = c;
+    } else if ((c >= 0b11000000U) && (c < 0b11111000U)) {
+        size_t n = (c >= 0b11110000U) ? 4 : ((c >= 0b11100000U) ? 3 : 2);
+        uint32_t cp = c & (0b01111111U >> n);
+        size_t i = 1;
+
+        while ((i < n) && (idx + i < end)) {
+            unsigned char b = static_cast<unsigned char>(src[idx + i]);
+
+            if ((b & 0b11000000U) != 0b10000000U) break;
+            cp = (cp << 6) | (b & 0b00111111U);
+            i ++;
+        }
+
+        if (i == n) {
+            codepoint = cp;
+            size = n;
+        }
+    }
+
+    (*pos) = idx + size;
+
+    return codepoint;
 }
 
 size_t Plteen::string_character_size(const char* src, int idx) {
@@ -545,6 +836,64 @@ size_t Plteen::string_character_size(const std::string& src, int idx) {
     return string_character_size(src.c_str(), idx);
 }
 
+/*************************************************************************************************/
+Plteen::UTF8Index::UTF8Index(const char* src, size_t size) : src(src) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(src);
+    const UTF8Kernels* kernels = utf8_kernels();
+    size_t it = 0;
+
+    this->size = utf8_extent(src, int(size));
+
+    // blocks are counted in bulk, unless the next 64th codepoint starts within them
+    while (it < this->size) {
+        size_t n = std::min(utf8_block_size, this->size - it);
+        size_t c = kernels->count_leading(s + it, n);
+        size_t r = this->count % utf8_index_stride;
+
+        if ((c == 0U) || ((r > 0U) && (r + c <= utf8_index_stride))) {
+            this->count += c;
+        } else {
+            for (size_t i = it; i < it + n; ++ i) {
+                if ((s[i] & 0b11000000U) != 0b10000000U) {
+                    if ((this->count % utf8_index_stride) == 0U) {
+                        this->offsets.push_back(i);
+                    }
+
+                    this->count ++;
+                }
+            }
+        }
+
+        it += n;
+    }
+}
+
+int Plteen::UTF8Index::index(int char_idx) const {
+    int cidx = -1;
+
+    if ((char_idx >= 0) && (size_t(char_idx) < this->count)) {
+        size_t offset = this->offsets[size_t(char_idx) / utf8_index_stride];
+        int idx = int(size_t(char_idx) % utf8_index_stride);
+
+        size_t window = std::min(this->size - offset, utf8_index_stride * 4U); // at most 4 bytes per codepoint
+
+        int widx = string_utf8_index(this->src + offset, idx, int(window));
+
+        // malformed bytes might not be found within the window
+        if (widx >= 0) {
+            cidx = int(offset) + widx;
+        }
+    }
+
+    return cidx;
+}
+
+uint32_t Plteen::UTF8Index::ref(int char_idx) const {
+    int code_idx = this->index(char_idx);
+
+    return (code_idx >= 0) ? utf8_decode(this->src, size_t(code_idx), this->size) : 0U;
+}
+
 bool Plteen::string_popback_utf8_char(std::string& src) {
     size_t size = src.size();
     bool okay = false;
@@ -566,6 +915,24 @@ bool Plteen::string_popback_utf8_char(std::string& src) {
     return okay;
 }
 
+void Plteen::string_pushback_utf8_char(std::string& dest, uint32_t ch) {
+    if (ch < 0x80U) {
+        dest.push_back(char(ch));
+    } else if (ch < 0x800U) {
+        dest.push_back(char(0xC0U | (ch >> 6U)));
+        dest.push_back(char(0x80U | (ch & 0x3FU)));
+    } else if (ch < 0x10000U) {
+        dest.push_back(char(0xE0U | (ch >> 12U)));
+        dest.push_back(char(0x80U | ((ch >> 6U) & 0x3FU)));
+        dest.push_back(char(0x80U | (ch & 0x3FU)));
+    } else {
+        dest.push_back(char(0xF0U | (ch >> 18U)));
+        dest.push_back(char(0x80U | ((ch >> 12U) & 0x3FU)));
+        dest.push_back(char(0x80U | ((ch >> 6U) & 0x3FU)));
+        dest.push_back(char(0x80U | (ch & 0x3FU)));
+    }
+}
+
 std::string Plteen::string_add_between(const char* s, char ch) {
     std::string vstr;
     int idx = 0;
@@ -663,6 +1030,18 @@ bool Plteen::string_suffix(const std::string& src, const std::string& sub) {
 }
 
 /************************************************************************************************/
+std::string Plteen::string_ascii_lowercase(const std::string& src) {
+    std::string dest(src);
+
+    for (size_t idx = 0; idx < dest.size(); idx ++) {
+        if ((dest[idx] >= 'A') && (dest[idx] <= 'Z')) {
+            dest[idx] = char(dest[idx] - 'A' + 'a');
+        }
+    }
+
+    return dest;
+}
+
 bool Plteen::string_ci_equal(const char* s1, const char* s2) {
     return string_equal_ci(s1, s2, strlen(s1), strlen(s2));
 }
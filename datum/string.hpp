@@ -67,11 +67,80 @@ namespace Plteen {
     __lambda__ int string_utf8_index(const std::string& src, int idx);
     __lambda__ uint32_t string_utf8_ref(const char* src, int char_idx, int max = -1);
     __lambda__ uint32_t string_utf8_ref(const std::string& src, int char_idx);
+    __lambda__ uint32_t string_utf8_scan(const char* src, size_t* pos, size_t end); // decodes and advances, U+FFFD for malformed bytes
     __lambda__ size_t string_character_size(const char* src, int byte_idx);
     __lambda__ size_t string_character_size(const std::string& src, int byte_idx);
     __lambda__ bool string_popback_utf8_char(std::string& src);
+    __lambda__ void string_pushback_utf8_char(std::string& dest, uint32_t ch);
     __lambda__ std::string string_add_between(const char* s, char ch = '\n');
 
+    // rejects overlongs, surrogates, codepoints beyond U+10FFFF and truncated sequences
+    __lambda__ bool string_utf8_validate(const char* src, size_t size);
+    __lambda__ bool string_utf8_validate(const std::string& src);
+
+    /**
+     * Walks codepoints as `string_utf8_scan` does, say,
+     *   `for (uint32_t ch : string_utf8_codepoints(src)) { ... }`
+     */
+    class __lambda__ UTF8Iterator {
+    public:
+        UTF8Iterator(const char* src, size_t pos, size_t end) : src(src), pos(pos), end(end) { this->decode(); }
+
+    public:
+        uint32_t operator*() const { return this->codepoint; }
+        UTF8Iterator& operator++() { this->pos = this->next; this->decode(); return (*this); }
+        bool operator==(const UTF8Iterator& rhs) const { return this->pos == rhs.pos; }
+        bool operator!=(const UTF8Iterator& rhs) const { return this->pos != rhs.pos; }
+
+    public:
+        size_t byte_position() const { return this->pos; }
+
+    private:
+        void decode() {
+            this->next = this->pos;
+            this->codepoint = (this->pos < this->end) ? string_utf8_scan(this->src, &this->next, this->end) : 0U;
+        }
+
+    private:
+        const char* src;
+        size_t pos;
+        size_t next = 0U;
+        size_t end;
+        uint32_t codepoint = 0U;
+    };
+
+    struct __lambda__ UTF8Codepoints {
+        const char* src;
+        size_t size;
+
+        Plteen::UTF8Iterator begin() const { return Plteen::UTF8Iterator(this->src, 0U, this->size); }
+        Plteen::UTF8Iterator end() const { return Plteen::UTF8Iterator(this->src, this->size, this->size); }
+    };
+
+    inline Plteen::UTF8Codepoints string_utf8_codepoints(const char* src, size_t size) { return { src, size }; }
+    inline Plteen::UTF8Codepoints string_utf8_codepoints(const std::string& src) { return { src.c_str(), src.size() }; }
+
+    /**
+     * Byte offsets of every 64th codepoint, random access only scans from the nearest one.
+     * The string is not copied, it must outlive the index and stay unchanged.
+     */
+    class __lambda__ UTF8Index {
+    public:
+        UTF8Index(const char* src, size_t size);
+        UTF8Index(const std::string& src) : UTF8Index(src.c_str(), src.size()) {}
+
+    public:
+        size_t length() const { return this->count; }
+        int index(int char_idx) const; // the byte offset, or -1
+        uint32_t ref(int char_idx) const;
+
+    private:
+        const char* src;
+        size_t size;
+        size_t count = 0U;
+        std::vector<size_t> offsets;
+    };
+
     /************************************************************************************************/
     __lambda__ bool string_equal(const char* s1, const char* s2);
     __lambda__ bool string_equal(const std::string& s1, const char* s2);
@@ -83,6 +152,7 @@ namespace Plteen {
     __lambda__ bool string_suffix(const std::string& src, const char* sub);
     __lambda__ bool string_suffix(const std::string& src, const std::string& sub);
     
+    __lambda__ std::string string_ascii_lowercase(const std::string& src);
     __lambda__ bool string_ci_equal(const char* s1, const char* s2);
     __lambda__ bool string_ci_equal(const std::string& s1, const char* s2);
     __lambda__ bool string_ci_equal(const std::string& s1, const std::string& s2);
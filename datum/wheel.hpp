@@ -0,0 +1,257 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace Plteen {
+    /**
+     * Hierarchical timer wheel, Varghese & Lauck, Hashed and Hierarchical Timing Wheels, 1987.
+     *
+     * The clock is whatever the owner advances it with, say, milliseconds,
+     *   6 levels of 64 slots cover 2^36 ticks, further timers wait in the overflow list till the next span.
+     * Advancing skips empty slots, so that the cost depends on the number of due timers, rather than the elapsed ticks.
+     *
+     * Nodes are intrusive and unlink themselves without touching the wheel,
+     *   owners could be destroyed even when their timers are being fired.
+     */
+    template<typename T>
+    class TimerWheel {
+    public:
+        struct Node {
+            ~Node() noexcept { this->unlink(); }
+
+            bool armed() const { return this->next != nullptr; }
+
+            void unlink() {
+                if (this->next != nullptr) {
+                    this->prev->next = this->next;
+                    this->next->prev = this->prev;
+                    this->prev = nullptr;
+                    this->next = nullptr;
+                }
+            }
+
+            T* datum = nullptr;
+            uint64_t expiry = 0U; // never earlier than the tick after the one it's scheduled at
+            Node* prev = nullptr;
+            Node* next = nullptr;
+        };
+
+    public:
+        TimerWheel(uint64_t now = 0U) : now(now) {
+            for (size_t l = 0U; l < levels; l ++) {
+                for (size_t s = 0U; s < slots; s ++) {
+                    this->heads[l][s].prev = &this->heads[l][s];
+                    this->heads[l][s].next = &this->heads[l][s];
+                }
+
+                this->occupied[l] = 0U;
+            }
+
+            this->overflow.prev = &this->overflow;
+            this->overflow.next = &this->overflow;
+        }
+
+        ~TimerWheel() noexcept {
+            for (size_t l = 0U; l < levels; l ++) {
+                for (size_t s = 0U; s < slots; s ++) {
+                    while (this->heads[l][s].next != &this->heads[l][s]) {
+                        this->heads[l][s].next->unlink();
+                    }
+
+                    // sentinels are not armed
+                    this->heads[l][s].prev = nullptr;
+                    this->heads[l][s].next = nullptr;
+                }
+            }
+
+            while (this->overflow.next != &this->overflow) {
+                this->overflow.next->unlink();
+            }
+
+            this->overflow.prev = nullptr;
+            this->overflow.next = nullptr;
+        }
+
+        TimerWheel(const TimerWheel<T>&) = delete;
+        TimerWheel<T>& operator=(const TimerWheel<T>&) = delete;
+
+    public:
+        uint64_t current() const { return this->now; }
+
+        // past expiries are due at the next tick
+        void schedule(Node* node, uint64_t expiry) {
+            node->unlink();
+            node->expiry = (expiry > this->now) ? expiry : (this->now + 1U);
+            this->place(node);
+        }
+
+        void cancel(Node* node) {
+            node->unlink();
+        }
+
+        /**
+         * Fires all timers expired by `to` in the order of their expiries, nodes are unlinked before `fire` is applied,
+         *   `fire` is free to reschedule them, or to cancel any other node.
+         */
+        template<typename F>
+        void advance(uint64_t to, F fire) {
+            while (this->now < to) {
+                uint64_t t = this->next_event();
+
+                if (t > to) {
+                    this->now = to;
+                } else {
+                    this->now = t;
+                    this->cascade();
+                    this->fire_slot(fire);
+                }
+            }
+        }
+
+    private:
+        void place(Node* node) {
+            uint64_t diff = node->expiry ^ this->now;
+            Node* head = &this->overflow;
+
+            if ((diff >> (bits * levels)) == 0U) {
+                size_t l = 0U;
+
+                while ((diff >> (bits * (l + 1U))) > 0U) {
+                    l ++;
+                }
+
+                size_t s = size_t((node->expiry >> (bits * l)) & (slots - 1U));
+                
+                head = &this->heads[l][s];
+                this->occupied[l] |= (uint64_t(1U) << s);
+            }
+
+            node->prev = head->prev;
+            node->next = head;
+            head->prev->next = node;
+            head->prev = node;
+        }
+
+        uint64_t next_event() {
+            uint64_t t = UINT64_MAX;
+
+            /**
+             * Slots behind the clock hand are empty by construction,
+             *   bits of slots emptied by `Node::unlink` are cleared when they are visited.
+             */
+            for (size_t l = 0U; l < levels; l ++) {
+                size_t shift = bits * l;
+                size_t hand = size_t((this->now >> shift) & (slots - 1U));
+                uint64_t ahead = (hand < slots - 1U) ? (this->occupied[l] & (~uint64_t(0U) << (hand + 1U))) : 0U;
+
+                if (ahead > 0U) {
+                    uint64_t span = shift + bits;
+                    uint64_t base = (span < 64U) ? ((this->now >> span) << span) : 0U;
+                    uint64_t when = base + (uint64_t(lowest_bit(ahead)) << shift);
+
+                    if (when < t) {
+                        t = when;
+                    }
+                }
+            }
+
+            if (this->overflow.next != &this->overflow) {
+                uint64_t span = bits * levels;
+                uint64_t when = ((this->now >> span) + 1U) << span;
+
+                if (when < t) {
+                    t = when;
+                }
+            }
+
+            return t;
+        }
+
+        void cascade() {
+            size_t top = 0U;
+
+            if ((this->now & ((uint64_t(1U) << (bits * levels)) - 1U)) == 0U) {
+                Node* head = &this->overflow;
+
+                // the new span, the overflow list must be emptied before its nodes are placed
+                Node* first = head->next;
+                Node* last = head->prev;
+
+                if (first != head) {
+                    head->prev = head;
+                    head->next = head;
+                    first->prev = nullptr;
+                    last->next = nullptr;
+
+                    while (first != nullptr) {
+                        Node* node = first;
+
+                        first = node->next;
+                        node->prev = nullptr;
+                        node->next = nullptr;
+                        this->place(node);
+                    }
+                }
+            }
+
+            while ((top + 1U < levels) && ((this->now & ((uint64_t(1U) << (bits * (top + 1U))) - 1U)) == 0U)) {
+                top ++;
+            }
+
+            // from the farthest level, nodes may fall into the slots of nearer levels that are cascaded right after,
+            //   nodes due right now fall into the current slot of level 0
+            for (size_t l = top; l > 0U; l --) {
+                size_t s = size_t((this->now >> (bits * l)) & (slots - 1U));
+                Node* head = &this->heads[l][s];
+
+                while (head->next != head) {
+                    Node* node = head->next;
+
+                    node->unlink();
+                    this->place(node);
+                }
+
+                this->occupied[l] &= ~(uint64_t(1U) << s);
+            }
+        }
+
+        template<typename F>
+        void fire_slot(F& fire) {
+            size_t s = size_t(this->now & (slots - 1U));
+            Node* head = &this->heads[0][s];
+
+            // rescheduled nodes never fall into the current slot
+            while (head->next != head) {
+                Node* node = head->next;
+
+                node->unlink();
+                fire(node);
+            }
+
+            this->occupied[0] &= ~(uint64_t(1U) << s);
+        }
+
+        static size_t lowest_bit(uint64_t x) {
+            size_t idx = 0U;
+
+            while ((x & 1U) == 0U) {
+                x >>= 1U;
+                idx ++;
+            }
+
+            return idx;
+        }
+
+    private:
+        static const size_t bits = 6U;
+        static const size_t slots = size_t(1U) << bits;
+        static const size_t levels = 6U;
+
+    private:
+        Node heads[levels][slots];
+        uint64_t occupied[levels];
+        Node overflow;
+        uint64_t now;
+    };
+}
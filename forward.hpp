@@ -8,6 +8,7 @@ namespace Plteen {
     class Cosmos;
     class Planelet;
     class RGBA;
+    class SocketDaemon;
 
     enum class SpeechBubble { Default, Thought };
     enum class BorderEdge { TOP, RIGHT, BOTTOM, LEFT, NONE };
@@ -64,6 +64,9 @@
 #include "physics/geometry/margin.hpp"
 #include "physics/motion/platformer.hpp"
 #include "physics/motion/map2d.hpp"
+#include "physics/motion/passability.hpp"
+#include "physics/motion/pathfinder.hpp"
+#include "physics/motion/flowfield.hpp"
 
 #include "datum/flonum.hpp"
 #include "datum/fixnum.hpp"
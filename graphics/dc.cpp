@@ -7,6 +7,8 @@
 #include "../datum/box.hpp"
 
 #include "image.hpp"
+#include "label.hpp"
+#include "layout.hpp"
 
 // https://www.ferzkopp.net/Software/SDL2_gfx/Docs/html/_s_d_l2__gfx_primitives_8h.html
 #include <SDL2/SDL2_gfxPrimitives.h>
@@ -228,24 +230,28 @@ static inline void safe_render_text_surface(dc_t* dc, SDL_Surface* message, T x,
     }
 }
 
+template<typename T>
+static inline void safe_render_text_texture(dc_t* dc, SDL_Texture* message, T x, T y) {
+    if (message != nullptr) {
+        dc->stamp(message, x, y);
+        SDL_DestroyTexture(message);
+    }
+}
+
 static inline void setup_for_text(const std::string& text, const RGBA& rgb, SDL_Color& c) {
     rgb.unbox(&c.r, &c.g, &c.b, &c.a);
 }
 
 static TTF_Font* select_font(const shared_font_t& sfont, const std::string& text) {
-    shared_font_t f = sfont;
-
-    if (!f->is_suitable(text)) {
-        f = f->try_fallback_for_unicode();
-    }
-
-    if (!f->okay()) {
-        f = GameFont::Default();
-    }
+    shared_font_t f = sfont->fallback_for(text);
 
-    return f->self();
+    return (f == nullptr) ? sfont->self() : f->self();
 }
 
+/**
+ * Blended text comes in opaque white, it's the shared layout of all colors,
+ *   the textures made from it take the color as their color and alpha mods.
+ */
 static SDL_Surface* game_text_surface(bool disable_font_selection, const std::string& text, const shared_font_t& sfont, TextRenderMode mode, const RGBA& fg, const RGBA& bg, int wrap) {
     SDL_Surface* surface = nullptr;
     TTF_Font* font = (disable_font_selection) ? sfont->self() : select_font(sfont, text);
@@ -260,7 +266,7 @@ static SDL_Surface* game_text_surface(bool disable_font_selection, const std::st
             switch (mode) {
                 case ::TextRenderMode::Solid: surface = TTF_RenderUTF8_Solid_Wrapped(font, text.c_str(), fgc, wrap); break;
                 case ::TextRenderMode::Shaded: surface = TTF_RenderUTF8_Shaded_Wrapped(font, text.c_str(), fgc, bgc, wrap); break;
-                case ::TextRenderMode::Blender: surface = TTF_RenderUTF8_Blended_Wrapped(font, text.c_str(), fgc, wrap); break;
+                case ::TextRenderMode::Blender: surface = game_text_layouts()->ref_layout(font, text, wrap); break;
                 case ::TextRenderMode::LCD: surface = TTF_RenderUTF8_LCD_Wrapped(font, text.c_str(), fgc, bgc, wrap); break;
             }
         } else {
@@ -268,7 +274,7 @@ static SDL_Surface* game_text_surface(bool disable_font_selection, const std::st
             switch (mode) {
                 case ::TextRenderMode::Solid: surface = TTF_RenderUTF8_Solid(font, text.c_str(), fgc); break;
                 case ::TextRenderMode::Shaded: surface = TTF_RenderUTF8_Shaded(font, text.c_str(), fgc, bgc); break;
-                case ::TextRenderMode::Blender: surface = TTF_RenderUTF8_Blended(font, text.c_str(), fgc); break;
+                case ::TextRenderMode::Blender: surface = game_text_layouts()->ref_layout(font, text, wrap); break;
 #ifndef __windows__
                 case ::TextRenderMode::LCD: surface = TTF_RenderUTF8_LCD(font, text.c_str(), fgc, bgc); break;
 #endif
@@ -291,9 +297,13 @@ DrawingContext::DrawingContext(SDL_Renderer* device) : device(device) {
     // TODO: ensure that the device is not a nullptr.
 
     SDL_GetRendererInfo(this->device, &info);
+    this->labels = new LabelCache();
 }
 
 DrawingContext::~DrawingContext() noexcept {
+    // textures must go before the renderer
+    delete this->labels;
+
     if (this->device != nullptr) {
         SDL_DestroyRenderer(this->device);
     }
@@ -304,7 +314,7 @@ SDL_Surface* DrawingContext::snapshot(int width, int height) {
     SDL_Surface* photograph = game_formatted_surface(width, height, format);
 
     if (photograph != nullptr) {
-        if (SDL_RenderReadPixels(this->device, NULL, format, photograph->pixels, photograph->pitch) < 0) {
+        if (!this->read_pixels(width, height, format, photograph->pixels, photograph->pitch)) {
             SDL_FreeSurface(photograph);
             photograph = nullptr;
         }
@@ -313,6 +323,12 @@ SDL_Surface* DrawingContext::snapshot(int width, int height) {
     return photograph;
 }
 
+bool DrawingContext::read_pixels(int width, int height, uint32_t format, void* pixels, int pitch) {
+    SDL_Rect region = { 0, 0, width, height }; // never reads more than the buffer holds
+
+    return SDL_RenderReadPixels(this->device, &region, format, pixels, pitch) == 0;
+}
+
 /*************************************************************************************************/
 void Plteen::DrawingContext::clear(const RGBA& color) {
     // the `alpha` might not affect the underline window instance
@@ -938,6 +954,14 @@ SDL_Texture* Plteen::DrawingContext::create_text_texture(const std::string& text
     if (surface != nullptr) {
         texture = SDL_CreateTextureFromSurface(this->device, surface);
         SDL_FreeSurface(surface);
+
+        if ((texture != nullptr) && (mode == TextRenderMode::Blender)) {
+            uint8_t r, g, b, a;
+
+            fgc.unbox(&r, &g, &b, &a);
+            SDL_SetTextureColorMod(texture, r, g, b);
+            SDL_SetTextureAlphaMod(texture, a);
+        }
     }
 
     return texture;
@@ -959,6 +983,22 @@ SDL_Texture* Plteen::DrawingContext::create_blended_text(const std::string& text
     return this->create_text_texture(text, font, TextRenderMode::Blender, fgc, fgc, wrap);
 }
 
+shared_texture_t Plteen::DrawingContext::cached_blended_text(const std::string& text, const shared_font_t& font, const RGBA& fgc) {
+    return this->labels->ref(this, text, font, fgc, this->_disable_font_selection);
+}
+
+void Plteen::DrawingContext::draw_cached_text(const std::string& text, const shared_font_t& font, float x, float y, const RGBA& rgb) {
+    shared_texture_t label = this->cached_blended_text(text, font, rgb);
+
+    if (label->okay()) {
+        this->stamp(label->self(), x, y);
+    }
+}
+
+void Plteen::DrawingContext::set_label_cache_capacity(size_t n) {
+    this->labels->set_capacity(n);
+}
+
 void Plteen::DrawingContext::draw_solid_text(const std::string& text, const shared_font_t& font, int x, int y, const RGBA& rgb, int wrap) {
     SDL_Surface* message = game_text_surface(this->_disable_font_selection, text, font, ::TextRenderMode::Solid, rgb, rgb, wrap);
     safe_render_text_surface(this, message, x, y);
@@ -975,8 +1015,8 @@ void Plteen::DrawingContext::draw_lcd_text(const std::string& text, const shared
 }
 
 void Plteen::DrawingContext::draw_blended_text(const std::string& text, const shared_font_t& font, int x, int y, const RGBA& rgb, int wrap) {
-    SDL_Surface* message = game_text_surface(this->_disable_font_selection, text, font, ::TextRenderMode::Blender, rgb, rgb, wrap);
-    safe_render_text_surface(this, message, x, y);
+    SDL_Texture* message = this->create_blended_text(text, font, rgb, wrap);
+    safe_render_text_texture(this, message, x, y);
 }
 
 void Plteen::DrawingContext::draw_solid_text(const std::string& text, const shared_font_t& font, float x, float y, const RGBA& rgb, int wrap) {
@@ -995,6 +1035,6 @@ void Plteen::DrawingContext::draw_lcd_text(const std::string& text, const shared
 }
 
 void Plteen::DrawingContext::draw_blended_text(const std::string& text, const shared_font_t& font, float x, float y, const RGBA& rgb, int wrap) {
-    SDL_Surface* message = game_text_surface(this->_disable_font_selection, text, font, ::TextRenderMode::Blender, rgb, rgb, wrap);
-    safe_render_text_surface(this, message, x, y);
+    SDL_Texture* message = this->create_blended_text(text, font, rgb, wrap);
+    safe_render_text_texture(this, message, x, y);
 }
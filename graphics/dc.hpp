@@ -8,10 +8,13 @@
 #include <string>
 
 #include "font.hpp"
+#include "texture.hpp"
 
 #include "../physics/color/rgba.hpp"
 
 namespace Plteen {
+    class LabelCache;
+
     enum TextRenderMode { Solid, Shaded, Blender, LCD };
 
     class __lambda__ DrawingContext {
@@ -26,6 +29,7 @@ namespace Plteen {
     public:
         int feed_output_size(int* width, int* height) { return SDL_GetRendererOutputSize(this->device, width, height); }
         SDL_Surface* snapshot(int width, int height);
+        bool read_pixels(int width, int height, uint32_t format, void* pixels, int pitch);
 
     public:
         void clear(const Plteen::RGBA& color);
@@ -300,11 +304,17 @@ namespace Plteen {
         void draw_lcd_text(const std::string& text, const shared_font_t& font, int x, int y, const Plteen::RGBA& fgc, const Plteen::RGBA& bgc, int wrap = 0);
         void draw_blended_text(const std::string& text, const shared_font_t& font, int x, int y, const Plteen::RGBA& rgb, int wrap = 0);
 
+    public: // blended text textures reused across frames, do not alter their color or alpha mods
+        Plteen::shared_texture_t cached_blended_text(const std::string& text, const shared_font_t& font, const Plteen::RGBA& fgc);
+        void draw_cached_text(const std::string& text, const shared_font_t& font, float x, float y, const Plteen::RGBA& rgb);
+        void set_label_cache_capacity(size_t n);
+
     private:
         SDL_Texture* create_text_texture(const std::string& text, const shared_font_t& font, Plteen::TextRenderMode mode, const Plteen::RGBA& fgc, const Plteen::RGBA& bgc, int wrap = 0);
 
     private:
         bool _disable_font_selection = false;
+        Plteen::LabelCache* labels = nullptr;
         SDL_RendererInfo info;
         SDL_Renderer* device = nullptr;
     };
@@ -0,0 +1,397 @@
+#include "encoder.hpp"
+
+#include "../datum/string.hpp"
+#include "../datum/fixnum.hpp"
+
+#include <filesystem>
+
+using namespace Plteen;
+using namespace std::filesystem;
+
+/*************************************************************************************************/
+static inline uint8_t rgb_to_luma(int r, int g, int b) {
+    return uint8_t((77 * r + 150 * g + 29 * b + 128) >> 8);
+}
+
+// saturated blue and red are rounded up to 256, the lower ends never go below 0
+static inline uint8_t rgb_to_cb(int r, int g, int b) {
+    return uint8_t(fxmin(((-43 * r - 85 * g + 128 * b + 128) >> 8) + 128, 255));
+}
+
+static inline uint8_t rgb_to_cr(int r, int g, int b) {
+    return uint8_t(fxmin(((128 * r - 107 * g - 21 * b + 128) >> 8) + 128, 255));
+}
+
+// the number of frames that should have been recorded by now, including the current one
+static inline uint64_t recording_due_slots(uint32_t epoch, uint32_t fps) {
+    return uint64_t(SDL_GetTicks() - epoch) * fps / 1000U + 1U;
+}
+
+/*************************************************************************************************/
+Plteen::FrameEncoder::FrameEncoder(size_t depth, PNGCompression level)
+    : depth((depth > 0U) ? depth : 1U), level(level)
+    , jobs(this->depth * 2U + 4U), recycled(this->depth * 2U), results(16U)
+    , buffers(0U), finished(0U), recorded(0U), dropped(0U) {
+    this->worker = new std::thread(&FrameEncoder::run, this);
+}
+
+Plteen::FrameEncoder::~FrameEncoder() noexcept {
+    this->stop_recording();
+
+    {
+        std::unique_lock<std::mutex> guard(this->lock);
+
+        this->stopping = true;
+    }
+
+    // pending snapshots are still saved
+    this->wakeup.notify_one();
+    this->worker->join();
+    delete this->worker;
+}
+
+/*************************************************************************************************/
+bool Plteen::FrameEncoder::save_snapshot(dc_t* dc, int width, int height, const std::string& pname) {
+    Job job;
+    bool okay = false;
+
+    job.type = JobType::Snapshot;
+    job.path = pname;
+    job.level = this->level;
+
+    if (this->acquire(job.pixels, width, height, false)) {
+        if (dc->read_pixels(width, height, SDL_PIXELFORMAT_RGBA32, job.pixels.data(), width * 4)) {
+            job.width = width;
+            job.height = height;
+
+            if (!this->submit(job)) { // the queue is full of frames
+                this->settled.push_back({ pname, game_save_png(job.pixels.data(), width, height, width * 4, pname.c_str(), job.level) });
+                this->release(job.pixels);
+            }
+
+            okay = true;
+        } else {
+            this->release(job.pixels);
+        }
+    }
+
+    return okay;
+}
+
+bool Plteen::FrameEncoder::poll_snapshot(std::string* pname, bool* okay) {
+    Result result;
+    bool found = false;
+
+    if (!this->settled.empty()) {
+        result = this->settled.front();
+        this->settled.erase(this->settled.begin());
+        found = true;
+    } else {
+        found = this->results.pop(&result);
+    }
+
+    if (found) {
+        if (pname != nullptr) (*pname) = result.path;
+        if (okay != nullptr) (*okay) = result.okay;
+    }
+
+    return found;
+}
+
+void Plteen::FrameEncoder::wait() {
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    this->drained.wait(guard, [this] { return this->finished.load() >= this->queued; });
+}
+
+/*************************************************************************************************/
+void Plteen::FrameEncoder::start_recording(const std::string& path, RecordingFormat format, uint32_t fps) {
+    Job job;
+
+    this->stop_recording();
+
+    job.type = JobType::Start;
+    job.path = path;
+    job.format = format;
+    job.fps = (fps > 0U) ? fps : 60U;
+
+    // control jobs always fit, since frames never take more than `depth` slots
+    this->recording = this->submit(job);
+    this->recording_epoch = SDL_GetTicks();
+    this->recording_fps = job.fps;
+    this->recording_slots = 0U;
+}
+
+bool Plteen::FrameEncoder::record_frame(dc_t* dc, int width, int height) {
+    bool okay = false;
+
+    if (this->recording) {
+        uint64_t due = recording_due_slots(this->recording_epoch, this->recording_fps);
+
+        // frames earlier than their slots are skipped, but not counted as dropped
+        if (due > this->recording_slots) {
+            Job job;
+
+            job.type = JobType::Frame;
+            job.level = this->level;
+            job.repeats = due - this->recording_slots - 1U;
+
+            // dropped before reading the pixels back, so that a busy encoder never slows down the game
+            if (this->acquire(job.pixels, width, height, true)) {
+                if (dc->read_pixels(width, height, SDL_PIXELFORMAT_RGBA32, job.pixels.data(), width * 4)) {
+                    job.width = width;
+                    job.height = height;
+                    okay = this->submit(job);
+                }
+
+                if (!okay) {
+                    this->release(job.pixels);
+                }
+            }
+
+            if (okay) {
+                this->recording_slots = due;
+            } else {
+                this->dropped ++;
+            }
+        }
+    }
+
+    return okay;
+}
+
+void Plteen::FrameEncoder::stop_recording() {
+    if (this->recording) {
+        uint64_t due = recording_due_slots(this->recording_epoch, this->recording_fps);
+        Job job;
+
+        job.type = JobType::Stop;
+        job.repeats = (due > this->recording_slots) ? (due - this->recording_slots) : 0U;
+        this->submit(job);
+        this->recording = false;
+    }
+}
+
+/*************************************************************************************************/
+bool Plteen::FrameEncoder::acquire(std::vector<uint8_t>& buffer, int width, int height, bool droppable) {
+    bool okay = (width > 0) && (height > 0);
+
+    if (okay && !this->recycled.pop(&buffer)) {
+        if (droppable && (this->buffers.load() >= this->depth)) {
+            okay = false;
+        } else {
+            this->buffers ++;
+        }
+    }
+
+    if (okay) {
+        buffer.resize(size_t(width) * size_t(height) * 4U);
+    }
+
+    return okay;
+}
+
+bool Plteen::FrameEncoder::submit(Job& job) {
+    bool okay = this->jobs.push(std::move(job));
+
+    if (okay) {
+        std::unique_lock<std::mutex> guard(this->lock);
+
+        this->queued ++;
+        this->wakeup.notify_one();
+    }
+
+    return okay;
+}
+
+void Plteen::FrameEncoder::release(std::vector<uint8_t>& buffer) {
+    buffer = std::vector<uint8_t>();
+    this->buffers --;
+}
+
+void Plteen::FrameEncoder::recycle(std::vector<uint8_t>& buffer) {
+    if (!this->recycled.push(std::move(buffer))) {
+        this->buffers --;
+    }
+}
+
+/*************************************************************************************************/
+void Plteen::FrameEncoder::run() {
+    Job job;
+
+    while (true) {
+        if (this->jobs.pop(&job)) {
+            this->encode(job);
+
+            std::unique_lock<std::mutex> guard(this->lock);
+
+            this->finished ++;
+            this->drained.notify_all();
+        } else {
+            std::unique_lock<std::mutex> guard(this->lock);
+
+            if (this->stopping && this->jobs.empty()) {
+                break;
+            }
+
+            this->wakeup.wait(guard, [this] { return this->stopping || !this->jobs.empty(); });
+        }
+    }
+
+    this->close_recording();
+}
+
+void Plteen::FrameEncoder::encode(Job& job) {
+    switch (job.type) {
+    case JobType::Snapshot: {
+        bool okay = game_save_png(job.pixels.data(), job.width, job.height, job.width * 4, job.path.c_str(), job.level);
+
+        if (!this->results.push({ job.path, okay })) {
+            fprintf(stderr, "无法报告屏幕截图: %s\n", job.path.c_str());
+        }
+
+        this->recycle(job.pixels);
+    }; break;
+    case JobType::Frame: {
+        this->encode_frame(job);
+        this->recycle(job.pixels);
+    }; break;
+    case JobType::Start: {
+        this->close_recording();
+        this->format = job.format;
+        this->target = job.path;
+        this->fps = job.fps;
+        this->sequence = 0U;
+        this->frame_width = 0;
+        this->frame_height = 0;
+        this->planes.clear();
+
+        if (this->format == RecordingFormat::Y4M) {
+            std::error_code ec;
+
+            create_directories(path(this->target).parent_path(), ec);
+            this->y4m = fopen(this->target.c_str(), "wb");
+
+            if (this->y4m == nullptr) {
+                fprintf(stderr, "无法录制视频 '%s'\n", this->target.c_str());
+            }
+        }
+    }; break;
+    case JobType::Stop: {
+        this->repeat_last_frame(job.repeats);
+        this->close_recording();
+    }; break;
+    }
+}
+
+void Plteen::FrameEncoder::encode_frame(Job& job) {
+    this->repeat_last_frame(job.repeats);
+
+    if (this->format == RecordingFormat::PNG) {
+        path frame = path(this->target) / make_nstring("frame-%08llu.png", (unsigned long long)(this->sequence));
+
+        if (game_save_png(job.pixels.data(), job.width, job.height, job.width * 4, frame.string().c_str(), job.level)) {
+            this->sequence ++;
+            this->recorded ++;
+        } else {
+            this->dropped ++;
+        }
+    } else if (this->y4m != nullptr) {
+        this->write_y4m_frame(job);
+    } else {
+        this->dropped ++;
+    }
+}
+
+void Plteen::FrameEncoder::write_y4m_frame(Job& job) {
+    if (this->frame_width == 0) { // chroma is subsampled by 2, odd edges are cropped
+        this->frame_width = job.width & ~1;
+        this->frame_height = job.height & ~1;
+        fprintf(this->y4m, "YUV4MPEG2 W%d H%d F%u:1 Ip A1:1 C420jpeg\n",
+            this->frame_width, this->frame_height, (unsigned int)(this->fps));
+    }
+
+    if ((job.width < this->frame_width) || (job.height < this->frame_height) || (this->frame_width == 0)) {
+        this->dropped ++;
+    } else {
+        size_t w = size_t(this->frame_width);
+        size_t h = size_t(this->frame_height);
+        size_t pitch = size_t(job.width) * 4U;
+        uint8_t* Y = nullptr;
+        uint8_t* U = nullptr;
+        uint8_t* V = nullptr;
+
+        this->planes.resize(w * h * 3U / 2U);
+        Y = this->planes.data();
+        U = Y + w * h;
+        V = U + (w / 2U) * (h / 2U);
+
+        for (size_t y = 0U; y < h; y += 2U) {
+            const uint8_t* row0 = job.pixels.data() + y * pitch;
+            const uint8_t* row1 = row0 + pitch;
+
+            for (size_t x = 0U; x < w; x += 2U) {
+                const uint8_t* p00 = row0 + x * 4U;
+                const uint8_t* p01 = p00 + 4U;
+                const uint8_t* p10 = row1 + x * 4U;
+                const uint8_t* p11 = p10 + 4U;
+                int r = (p00[0] + p01[0] + p10[0] + p11[0] + 2) >> 2;
+                int g = (p00[1] + p01[1] + p10[1] + p11[1] + 2) >> 2;
+                int b = (p00[2] + p01[2] + p10[2] + p11[2] + 2) >> 2;
+                size_t c = (y / 2U) * (w / 2U) + (x / 2U);
+
+                Y[y * w + x] = rgb_to_luma(p00[0], p00[1], p00[2]);
+                Y[y * w + x + 1U] = rgb_to_luma(p01[0], p01[1], p01[2]);
+                Y[(y + 1U) * w + x] = rgb_to_luma(p10[0], p10[1], p10[2]);
+                Y[(y + 1U) * w + x + 1U] = rgb_to_luma(p11[0], p11[1], p11[2]);
+                U[c] = rgb_to_cb(r, g, b);
+                V[c] = rgb_to_cr(r, g, b);
+            }
+        }
+
+        fputs("FRAME\n", this->y4m);
+
+        if (fwrite(this->planes.data(), 1U, this->planes.size(), this->y4m) == this->planes.size()) {
+            this->recorded ++;
+        } else {
+            this->dropped ++;
+        }
+    }
+}
+
+void Plteen::FrameEncoder::repeat_last_frame(uint64_t n) {
+    if (this->format == RecordingFormat::PNG) {
+        if (this->sequence > 0U) {
+            path last = path(this->target) / make_nstring("frame-%08llu.png", (unsigned long long)(this->sequence - 1U));
+
+            for (uint64_t i = 0U; i < n; i ++) {
+                path frame = path(this->target) / make_nstring("frame-%08llu.png", (unsigned long long)(this->sequence));
+                std::error_code ec;
+
+                if (copy_file(last, frame, copy_options::overwrite_existing, ec)) {
+                    this->sequence ++;
+                    this->recorded ++;
+                } else {
+                    this->dropped ++;
+                }
+            }
+        }
+    } else if ((this->y4m != nullptr) && !this->planes.empty()) {
+        for (uint64_t i = 0U; i < n; i ++) {
+            fputs("FRAME\n", this->y4m);
+
+            if (fwrite(this->planes.data(), 1U, this->planes.size(), this->y4m) == this->planes.size()) {
+                this->recorded ++;
+            } else {
+                this->dropped ++;
+            }
+        }
+    }
+}
+
+void Plteen::FrameEncoder::close_recording() {
+    if (this->y4m != nullptr) {
+        fclose(this->y4m);
+        this->y4m = nullptr;
+    }
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "dc.hpp"
+#include "image.hpp"
+
+#include "../datum/queue.hpp"
+
+namespace Plteen {
+    enum class RecordingFormat { PNG, Y4M };
+
+    /**
+     * Encodes snapshots and recorded frames on a worker thread,
+     *   the main thread only reads the pixels back into a recycled buffer and queues them.
+     *
+     * At most `depth` frames are in flight, frames beyond that are dropped and counted,
+     *   snapshots are never dropped, they fall back to encoding in place if the queue is full.
+     *
+     * Recording streams frames into numbered PNGs in a directory,
+     *   or into a Y4M file (4:2:0, full range BT.601), whose size is that of the first frame.
+     *
+     * Frames are paced by the time they are recorded, so that the output plays back at the declared fps:
+     *   frames that come earlier than their slots are skipped, and slots without frames (idle or dropped)
+     *   are filled with the previous frame, including those before the recording stops.
+     */
+    class __lambda__ FrameEncoder {
+    public:
+        FrameEncoder(size_t depth = 4U, Plteen::PNGCompression level = PNGCompression::Fast);
+        virtual ~FrameEncoder() noexcept;
+
+    public:
+        bool save_snapshot(Plteen::dc_t* dc, int width, int height, const std::string& pname);
+        bool poll_snapshot(std::string* pname, bool* okay); // a finished snapshot, if any
+        void wait(); // until everything queued is encoded
+
+    public:
+        void start_recording(const std::string& path, Plteen::RecordingFormat format, uint32_t fps);
+        bool record_frame(Plteen::dc_t* dc, int width, int height); // `false` if dropped or not due yet
+        void stop_recording();
+        bool is_recording() { return this->recording; }
+
+    public:
+        void set_compression(Plteen::PNGCompression level) { this->level = level; }
+        uint64_t recorded_frame_count() { return this->recorded; }
+        uint64_t dropped_frame_count() { return this->dropped; }
+
+    private:
+        enum class JobType { Snapshot, Frame, Start, Stop };
+
+        struct Job {
+            JobType type = JobType::Frame;
+            std::string path;
+            std::vector<uint8_t> pixels; // in R, G, B, A order
+            int width = 0;
+            int height = 0;
+            Plteen::PNGCompression level = PNGCompression::Fast;
+            Plteen::RecordingFormat format = RecordingFormat::PNG;
+            uint32_t fps = 0U;
+            uint64_t repeats = 0U; // of the previous frame, before this one
+        };
+
+        struct Result {
+            std::string path;
+            bool okay = false;
+        };
+
+    private:
+        bool acquire(std::vector<uint8_t>& buffer, int width, int height, bool droppable);
+        bool submit(Job& job);
+        void run();
+        void encode(Job& job);
+        void encode_frame(Job& job);
+        void write_y4m_frame(Job& job);
+        void repeat_last_frame(uint64_t n);
+        void close_recording();
+        void release(std::vector<uint8_t>& buffer); // by the main thread
+        void recycle(std::vector<uint8_t>& buffer); // by the worker thread
+
+    private: // the main thread
+        size_t depth;
+        Plteen::PNGCompression level;
+        size_t queued = 0U;
+        bool recording = false;
+        uint32_t recording_epoch = 0U;
+        uint32_t recording_fps = 0U;
+        uint64_t recording_slots = 0U;
+        std::vector<Result> settled; // snapshots saved in place
+
+    private: // shared
+        Plteen::SPSCQueue<Job> jobs;
+        Plteen::SPSCQueue<std::vector<uint8_t>> recycled;
+        Plteen::SPSCQueue<Result> results;
+        std::atomic<size_t> buffers;
+        std::atomic<size_t> finished;
+        std::atomic<uint64_t> recorded;
+        std::atomic<uint64_t> dropped;
+        std::mutex lock;
+        std::condition_variable wakeup;
+        std::condition_variable drained;
+        std::thread* worker = nullptr;
+        bool stopping = false;
+
+    private: // the worker thread
+        Plteen::RecordingFormat format = RecordingFormat::PNG;
+        std::string target;
+        FILE* y4m = nullptr;
+        int frame_width = 0;
+        int frame_height = 0;
+        uint32_t fps = 0U;
+        uint64_t sequence = 0U;
+        std::vector<uint8_t> planes;
+    };
+}
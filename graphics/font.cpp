@@ -1,7 +1,8 @@
 #include "font.hpp"
+#include "layout.hpp"
+#include "fontdir.hpp"
 
 #include <unordered_map>
-#include <filesystem>
 
 #include "../datum/flonum.hpp"
 #include "../datum/string.hpp"
@@ -9,7 +10,6 @@
 #include "../datum/box.hpp"
 
 using namespace Plteen;
-using namespace std::filesystem;
 
 /*************************************************************************************************/
 typedef std::tuple<std::string, int> font_key_t;
@@ -31,8 +31,9 @@ namespace {
 static std::unordered_map<font_key_t, shared_font_t, FontKeyHash> fontdb;
 static int medium_fontsize = 16;
 
+static const size_t font_fallback_memo_size = 512U;
+
 /*************************************************************************************************/
-static std::unordered_map<std::string, std::string> system_fonts;
 static std::unordered_map<std::string, std::string> basenames;
 
 static std::string system_fontdirs[] = {
@@ -42,29 +43,81 @@ static std::string system_fontdirs[] = {
     "/usr/share/fonts"
 };
 
-static void game_push_fonts_of_directory(path& root) {
-    for (auto entry : directory_iterator(root)) {
-        path self = entry.path();
+/**
+ * Candidates of generic families, by the family names in the 'name' tables of fonts,
+ *   the filename of the platform goes first, so that defaults stay the same where it is installed,
+ *   otherwise, the first installed candidate wins.
+ */
+static const char* sans_serif_families[] = { "Lucida Grande", "Microsoft YaHei", "Segoe UI", "DejaVu Sans", "Noto Sans", "Liberation Sans", "Nimbus Sans", "Arial", nullptr };
+static const char* serif_families[] = { "Times New Roman", "DejaVu Serif", "Noto Serif", "Liberation Serif", "Nimbus Roman", "Times", nullptr };
+static const char* monospace_families[] = { "Courier New", "Menlo", "Consolas", "DejaVu Sans Mono", "Noto Sans Mono", "Liberation Mono", "Nimbus Mono PS", nullptr };
+static const char* math_families[] = { "STIX Two Math", "Cambria Math", "Latin Modern Math", "DejaVu Math TeX Gyre", nullptr };
+static const char* cursive_families[] = { "Apple Chancery", "Segoe Script", "URW Chancery L", "Z003", "Comic Sans MS", nullptr };
+static const char* fantasy_families[] = { "Comic Sans MS", "Papyrus", "Impact", "Bodoni 72", nullptr };
+static const char* fangsong_families[] = { "PingFang SC", "Microsoft YaHei", "Noto Sans CJK SC", "WenQuanYi Micro Hei", "Arial Unicode MS", nullptr };
+
+static const char* cjk_sans_serif_families[] = { "Hiragino Sans GB", "Microsoft YaHei", "Noto Sans CJK SC", "Source Han Sans SC", "WenQuanYi Micro Hei", nullptr };
+static const char* cjk_serif_families[] = { "Songti SC", "KaiTi", "Noto Serif CJK SC", "Source Han Serif SC", "AR PL UMing CN", nullptr };
+static const char* cjk_monospace_families[] = { "STHeiti", "SimHei", "Noto Sans Mono CJK SC", "WenQuanYi Zen Hei Mono", nullptr };
+static const char* cjk_cursive_families[] = { "STXingkai", "FZShuTi", nullptr };
+static const char* cjk_fantasy_families[] = { "STHupo", nullptr };
+static const char* cjk_fangsong_families[] = { "FangSong", "STFangsong", "Arial Unicode MS", "Noto Sans CJK SC", nullptr };
+
+static const char** generic_font_families(FontFamily family, bool cjk) {
+    switch (family) {
+    case FontFamily::sans_serif: return cjk ? cjk_sans_serif_families : sans_serif_families; break;
+    case FontFamily::serif: return cjk ? cjk_serif_families : serif_families; break;
+    case FontFamily::monospace: return cjk ? cjk_monospace_families : monospace_families; break;
+    case FontFamily::math: return math_families; break;
+    case FontFamily::cursive: return cjk ? cjk_cursive_families : cursive_families; break;
+    case FontFamily::fantasy: return cjk ? cjk_fantasy_families : fantasy_families; break;
+    case FontFamily::fangsong: return cjk ? cjk_fangsong_families : fangsong_families; break;
+    default: return nullptr;
+    }
+}
+
+static std::string generic_font_face(FontFamily family, bool cjk) {
+    const char** families = generic_font_families(family, cjk);
+    const char* face = cjk ? generic_font_family_name_for_chinese(family) : generic_font_family_name_for_ascii(family);
 
-        if (entry.is_directory()) {
-            game_push_fonts_of_directory(self);
-        } else if (entry.is_regular_file()) {
-            system_fonts[self.filename().string()] = self.string();
+    if (game_font_file_path(face, nullptr)) {
+        return face;
+    } else if (families != nullptr) {
+        for (size_t idx = 0; families[idx] != nullptr; idx ++) {
+            if (game_font_family_face(families[idx], "Regular", nullptr)) {
+                return families[idx];
+            }
         }
     }
+
+    return face;
 }
 
-/*************************************************************************************************/
-void Plteen::game_fonts_initialize() {
-    for (unsigned int idx = 0; idx < sizeof(system_fontdirs) / sizeof(std::string); idx++) {
-        path root(system_fontdirs[idx]);
+/**
+ * Faces are filenames of system fonts, family names of system fonts, or paths,
+ *   faces in collections are told apart by their indices.
+ */
+static std::string resolve_font_face(const std::string& face, int* index) {
+    std::string file;
+    FontFace self;
 
-        if (exists(root) && is_directory(root)) {
-            game_push_fonts_of_directory(root);
-        }
+    (*index) = 0;
+
+    if (game_font_file_path(face, &file)) {
+        return file;
+    } else if (game_font_family_face(face, "Regular", &self)) {
+        (*index) = self.index;
+        return self.path;
+    } else {
+        return face;
     }
 }
 
+/*************************************************************************************************/
+void Plteen::game_fonts_initialize() {
+    game_font_directories_initialize(system_fontdirs, sizeof(system_fontdirs) / sizeof(std::string));
+}
+
 void Plteen::game_fonts_destroy() {
     /**
      * Please remeber to clear the fonts
@@ -72,6 +125,8 @@ void Plteen::game_fonts_destroy() {
      * TODO: find out why.
      */
     fontdb.clear();
+    game_text_layouts()->clear();
+    game_font_directories_destroy();
 }
 
 int Plteen::generic_font_size(FontSize size) {
@@ -144,17 +199,12 @@ const char* Plteen::generic_font_family_name_for_chinese(FontFamily family) {
 
 /*************************************************************************************************/
 shared_font_t Plteen::game_create_shared_font(const char* face, int fontsize) {
-    std::string face_key(face);
-    font_key_t font_key;
-    
-    if (system_fonts.find(face_key) == system_fonts.end()) {
-        font_key = std::tuple<std::string, int>(face_key, fontsize);
-    } else {
-        font_key = std::tuple<std::string, int>(system_fonts[face_key], fontsize);
-    }
+    int index = 0;
+    std::string file = resolve_font_face(face, &index);
+    font_key_t font_key((index == 0) ? file : file + "#" + std::to_string(index), fontsize);
 
     if (fontdb.find(font_key) == fontdb.end()) {
-        TTF_Font* font = TTF_OpenFont(std::get<0>(font_key).c_str(), fontsize);
+        TTF_Font* font = TTF_OpenFontIndex(file.c_str(), fontsize, index);
 
         if (font == nullptr) {
             fprintf(stderr, "无法加载字体 '%s': %s\n", face, TTF_GetError());
@@ -173,14 +223,9 @@ shared_font_t Plteen::game_create_shared_font(const char* face, float fontsize)
 }
 
 TTF_Font* Plteen::game_create_font(const char* face, int fontsize) {
-    std::string face_key(face);
-    TTF_Font* font = nullptr;
-    
-    if (system_fonts.find(face_key) == system_fonts.end()) {
-        font = TTF_OpenFont(face, fontsize);
-    } else {
-        font = TTF_OpenFont(system_fonts[face_key].c_str(), fontsize);
-    }
+    int index = 0;
+    std::string file = resolve_font_face(face, &index);
+    TTF_Font* font = TTF_OpenFontIndex(file.c_str(), fontsize, index);
 
     if (font == nullptr) {
         fprintf(stderr, "无法加载字体 '%s': %s\n", face, TTF_GetError());
@@ -202,18 +247,23 @@ void Plteen::game_destory_font(TTF_Font* font) {
 }
 
 const std::string* Plteen::game_fontname_list(int* n, int fontsize) {
-    static std::string* font_list = new std::string[system_fonts.size()];
+    static std::vector<std::string> filenames = game_font_filenames();
+    static std::string* font_list = new std::string[filenames.size()];
     static int i = 0;
 
     if (i == 0) {
-        for (std::pair<std::string, std::string> k_v : system_fonts) {
-            TTF_Font* f = TTF_OpenFont(k_v.second.c_str(), fontsize);
-
-            if (f != nullptr) {
-                font_list[i ++] = k_v.first;
-                
-                // because of insufficient resources to open all fonts
-                TTF_CloseFont(f);
+        for (auto filename : filenames) {
+            std::string file;
+
+            if (game_font_file_path(filename, &file)) {
+                TTF_Font* f = TTF_OpenFont(file.c_str(), fontsize);
+
+                if (f != nullptr) {
+                    font_list[i ++] = filename;
+                    
+                    // because of insufficient resources to open all fonts
+                    TTF_CloseFont(f);
+                }
             }
         }
     }
@@ -305,7 +355,7 @@ std::shared_ptr<GameFont> Plteen::GameFont::Tooltip(FontSize absize) {
 }
 
 std::shared_ptr<GameFont> Plteen::GameFont::create_font(FontFamily family, int ftsize) {
-    std::shared_ptr<GameFont> font = game_create_shared_font(generic_font_family_name_for_ascii(family), ftsize);
+    std::shared_ptr<GameFont> font = game_create_shared_font(generic_font_face(family, false).c_str(), ftsize);
 
     font->family = family;
 
@@ -315,9 +365,45 @@ std::shared_ptr<GameFont> Plteen::GameFont::create_font(FontFamily family, int f
 
 std::shared_ptr<GameFont> Plteen::GameFont::try_fallback_for_unicode() {
     if (this->family != FontFamily::_) {
-        return game_create_shared_font(generic_font_family_name_for_chinese(this->family), this->size);
+        return game_create_shared_font(generic_font_face(this->family, true).c_str(), this->size);
     } else {
-        return game_create_shared_font(generic_font_family_name_for_chinese(FontFamily::fangsong), this->size);
+        return game_create_shared_font(generic_font_face(FontFamily::fangsong, true).c_str(), this->size);
+    }
+}
+
+std::shared_ptr<GameFont> Plteen::GameFont::fallback_for(const std::string& text) {
+    auto it = this->fallbacks.find(text);
+    shared_font_t f = nullptr;
+
+    if ((it != this->fallbacks.end()) && (it->second.self || !it->second.font.expired())) {
+        f = it->second.font.lock();
+    } else {
+        if (!this->is_suitable(text)) {
+            f = this->try_fallback_for_unicode();
+
+            if ((f == nullptr) || !f->okay()) {
+                f = GameFont::Default();
+            }
+
+            if (f.get() == this) {
+                f = nullptr;
+            }
+        }
+
+        if (this->fallbacks.size() >= font_fallback_memo_size) {
+            this->fallbacks.clear();
+        }
+
+        this->fallbacks[text] = { (f == nullptr), f };
+    }
+
+    return f;
+}
+
+Plteen::GameFont::~GameFont() {
+    if (this->okay()) {
+        game_text_layouts()->forget(this->font);
+        TTF_CloseFont(this->font);
     }
 }
 
@@ -337,7 +423,7 @@ const char* Plteen::GameFont::basename() {
 
 void Plteen::GameFont::feed_text_extent(const char* unicode, int* width, int* height) {
     if (this->okay()) {
-        TTF_SizeUTF8(this->font, unicode, width, height);
+        game_text_layouts()->feed_extent(this->font, unicode, width, height);
     }
 }
 
@@ -350,7 +436,7 @@ TextMetrics Plteen::GameFont::get_text_metrics(const char* unicode) {
         int width, height, xmin, xmax, advance;
         int yminf, ymaxf, yminl, ymaxl;
 
-        TTF_SizeUTF8(this->font, unicode, &width, &height);
+        this->feed_text_extent(unicode, &width, &height);
         metrics.width = float(width);
         metrics.height = float(height);
         metrics.ascent = float(TTF_FontAscent(this->font));
@@ -377,35 +463,67 @@ TextMetrics Plteen::GameFont::get_text_metrics(const char* unicode) {
 }
 
 bool Plteen::GameFont::is_suitable(const std::string& text) {
-    bool okay = true;
+    bool okay = this->okay();
     
-    if (this->okay()) {
-        size_t utf8_size = string_utf8_length(text.c_str(), int(text.size()));
+    if (okay) {
+        const char* src = text.c_str();
+        size_t end = text.size();
+        size_t pos = 0U;
 
-        for (size_t idx = 0; idx < utf8_size; idx ++) {
-#ifndef __windows__
-            if (!TTF_GlyphIsProvided32(this->font, string_utf8_ref(text, idx))) {
+        while (pos < end) {
+            if (!this->is_provided(string_utf8_scan(src, &pos, end))) {
                 okay = false;
                 break;
             }
+        }
+    }
+
+    return okay;
+}
+
+bool Plteen::GameFont::is_provided(uint32_t ch) {
+    bool provided = false;
+
+    if (this->okay()) {
+        if (ch < 0x10000U) {
+            size_t word = ch >> 6U;
+            uint64_t bit = uint64_t(1U) << (ch & 0x3FU);
+
+            if (this->bmp_known.empty()) {
+                this->bmp_known.assign(0x10000U >> 6U, 0U);
+                this->bmp_provided.assign(0x10000U >> 6U, 0U);
+            }
+
+            if ((this->bmp_known[word] & bit) == 0U) {
+#ifndef __windows__
+                provided = TTF_GlyphIsProvided32(this->font, ch);
 #else
-            uint32_t utf8_ch = string_utf8_ref(text, int(idx));
+                // TODO: Upgrade the windows version of TTF_Font
+                provided = (ch <= 0xFFU) && TTF_GlyphIsProvided(this->font, uint16_t(ch));
+#endif
+                this->bmp_known[word] |= bit;
 
-            // TODO: Upgrade the windows version of TTF_Font
-            if (utf8_ch > 0xFFU) {
-                okay = false;
-                break;
-            } else if (!TTF_GlyphIsProvided(this->font, utf8_ch)) {
-                okay = false;
-                break;
+                if (provided) {
+                    this->bmp_provided[word] |= bit;
+                }
+            } else {
+                provided = ((this->bmp_provided[word] & bit) != 0U);
             }
+        } else {
+            auto it = this->astral_provided.find(ch);
+
+            if (it == this->astral_provided.end()) {
+#ifndef __windows__
+                provided = TTF_GlyphIsProvided32(this->font, ch);
 #endif
+                this->astral_provided[ch] = provided;
+            } else {
+                provided = it->second;
+            }
         }
-    } else {
-        okay = false;
     }
 
-    return okay;
+    return provided;
 }
 
 int Plteen::GameFont::width(const char* unicode) {
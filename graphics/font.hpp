@@ -4,6 +4,8 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <unordered_map>
 
 namespace Plteen {
     // https://www.w3.org/TR/css-fonts-4
@@ -48,7 +50,7 @@ namespace Plteen {
 
     public:
         GameFont(TTF_Font* raw, int ftsize) : font(raw), size(ftsize) {}
-        virtual ~GameFont() { if (this->okay()) TTF_CloseFont(this->font); }
+        virtual ~GameFont();
 
     public:
         bool okay() { return this->font != nullptr; }
@@ -61,6 +63,7 @@ namespace Plteen {
         Plteen::TextMetrics get_text_metrics(const char* unicode);
 
         bool is_suitable(const std::string& text);
+        bool is_provided(uint32_t codepoint);
         float line_height(float multiple = 1.0F);
         int width(const std::string& unicode) { return this->width(unicode.c_str()); }
         int width(const char* unicode);
@@ -73,6 +76,7 @@ namespace Plteen {
 
     public:
         std::shared_ptr<GameFont> try_fallback_for_unicode();
+        std::shared_ptr<GameFont> fallback_for(const std::string& text); // `nullptr` if this font suits
 
     private:
         static std::shared_ptr<GameFont> create_font(FontFamily family, int ftsize);
@@ -81,6 +85,15 @@ namespace Plteen {
         TTF_Font* font = nullptr;
         FontFamily family = FontFamily::_;
         int size;
+
+    private: // glyph coverage, filled lazily, 2 bits per codepoint of BMP: known and provided
+        std::vector<uint64_t> bmp_known;
+        std::vector<uint64_t> bmp_provided;
+        std::unordered_map<uint32_t, bool> astral_provided;
+
+    private: // text hash => the chosen font, weak since fonts may fall back to each other
+        struct Fallback { bool self; std::weak_ptr<GameFont> font; };
+        std::unordered_map<std::string, Fallback> fallbacks; // by texts, hashes might collide
     };
 
     typedef std::shared_ptr<GameFont> shared_font_t;
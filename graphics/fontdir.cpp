@@ -0,0 +1,659 @@
+#include "fontdir.hpp"
+
+#include "../datum/string.hpp"
+#include "../datum/bytes.hpp"
+#include "../datum/box.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <mutex>
+
+#include <cstring>
+#include <cstdlib>
+
+using namespace Plteen;
+using namespace std::filesystem;
+
+/*************************************************************************************************/
+namespace {
+    struct FontDirectory {
+        std::string path;
+        int64_t mtime;
+        int64_t count; // negative if the directory does not exist
+    };
+
+    struct FontIndex {
+        std::vector<FontDirectory> dirs; // the roots come first, in order
+        std::vector<std::string> files;
+        std::vector<FontFace> faces;
+
+    public: // not persisted
+        std::unordered_map<std::string, size_t> filenames;
+        std::unordered_map<std::string, std::vector<size_t>> families; // by lowercase names
+    };
+
+    enum class FontName { Family, Style, TypographicFamily, TypographicStyle, _ };
+}
+
+static const char font_index_magic[16] = "plteen.fonts.1"; // bump the version once the layout changes
+
+static const char* font_extensions[] = { ".ttf", ".otf", ".ttc", ".otc" };
+static const char* regular_styles[] = { "Regular", "Book", "Roman", "Normal", "Plain" };
+
+static std::vector<std::string> font_roots;
+static FontIndex font_index;
+static std::mutex font_index_lock;
+static std::condition_variable font_index_scanned;
+static std::thread* font_scanner = nullptr;
+static std::atomic<bool> font_scan_stopping(false);
+static bool font_scanning = false;
+
+// filename => path, walked only if fonts are asked for before the very first index is ready
+static std::unordered_map<std::string, std::string> font_fallback_files;
+static bool font_fallback_walked = false;
+
+/*************************************************************************************************/
+static std::string utf16be_to_utf8(const uint8_t* src, size_t size) {
+    std::string dest;
+
+    for (size_t idx = 0; idx + 1 < size; idx += 2) {
+        uint32_t ch = network_uint16_ref(src, idx);
+
+        if ((ch >= 0xD800U) && (ch < 0xDC00U) && (idx + 3 < size)) {
+            uint32_t lo = network_uint16_ref(src, idx + 2);
+
+            if ((lo >= 0xDC00U) && (lo < 0xE000U)) {
+                ch = 0x10000U + ((ch - 0xD800U) << 10U) + (lo - 0xDC00U);
+                idx += 2;
+            }
+        }
+
+        string_pushback_utf8_char(dest, ch);
+    }
+
+    return dest;
+}
+
+static bool is_font_file(const path& file) {
+    std::string ext = file.extension().string();
+
+    for (size_t idx = 0; idx < sizeof(font_extensions) / sizeof(char*); idx ++) {
+        if (string_ci_equal(ext, font_extensions[idx])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool is_regular_style(const std::string& style) {
+    for (size_t idx = 0; idx < sizeof(regular_styles) / sizeof(char*); idx ++) {
+        if (string_ci_equal(style, regular_styles[idx])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*************************************************************************************************/
+static bool font_read(std::ifstream& in, size_t offset, uint8_t* dest, size_t size) {
+    in.clear();
+    in.seekg(std::streamoff(offset));
+    in.read(reinterpret_cast<char*>(dest), std::streamsize(size));
+
+    return size_t(in.gcount()) == size;
+}
+
+static int font_name_score(uint16_t platform, uint16_t language) {
+    int score = 0;
+
+    switch (platform) {
+    case 3: score = (language == 0x0409) ? 4 : 3; break; // Windows, en-US first
+    case 0: score = 2; break; // Unicode
+    case 1: score = (language == 0) ? 1 : 0; break; // Macintosh, English
+    }
+
+    return score;
+}
+
+static bool font_read_names(std::ifstream& in, size_t sfnt, std::string* family, std::string* style) {
+    uint8_t header[12];
+    std::vector<uint8_t> records;
+    std::vector<uint8_t> table;
+    size_t name_offset = 0U;
+    size_t name_size = 0U;
+
+    if (!font_read(in, sfnt, header, sizeof(header))) return false;
+
+    uint16_t ntables = network_uint16_ref(header, 4);
+
+    records.resize(size_t(ntables) * 16U);
+    if (!font_read(in, sfnt + sizeof(header), records.data(), records.size())) return false;
+
+    for (size_t idx = 0; idx < records.size(); idx += 16) {
+        if (memcmp(records.data() + idx, "name", 4) == 0) {
+            name_offset = network_uint32_ref(records.data(), idx + 8);
+            name_size = network_uint32_ref(records.data(), idx + 12);
+            break;
+        }
+    }
+
+    // the 'name' table is small, larger ones are considered broken
+    if ((name_size < 6U) || (name_size > 1024U * 1024U)) return false;
+
+    table.resize(name_size);
+    if (!font_read(in, name_offset, table.data(), table.size())) return false;
+
+    size_t count = network_uint16_ref(table.data(), 2);
+    size_t storage = network_uint16_ref(table.data(), 4);
+    std::string names[size_t(FontName::_)];
+    int scores[size_t(FontName::_)] = { -1, -1, -1, -1 };
+
+    for (size_t idx = 0; idx < count; idx ++) {
+        size_t record = 6U + idx * 12U;
+
+        if (record + 12U > table.size()) break;
+
+        uint16_t platform = network_uint16_ref(table.data(), record + 0);
+        uint16_t language = network_uint16_ref(table.data(), record + 4);
+        uint16_t nid = network_uint16_ref(table.data(), record + 6);
+        size_t size = network_uint16_ref(table.data(), record + 8);
+        size_t start = storage + network_uint16_ref(table.data(), record + 10);
+        int score = font_name_score(platform, language);
+        size_t slot = size_t(FontName::_);
+
+        switch (nid) {
+        case 1: slot = size_t(FontName::Family); break;
+        case 2: slot = size_t(FontName::Style); break;
+        case 16: slot = size_t(FontName::TypographicFamily); break;
+        case 17: slot = size_t(FontName::TypographicStyle); break;
+        }
+
+        if ((slot < size_t(FontName::_)) && (score > scores[slot]) && (start + size <= table.size())) {
+            const uint8_t* raw = table.data() + start;
+
+            if (platform == 1) {
+                names[slot].clear();
+
+                for (size_t i = 0; i < size; i ++) { // MacRoman, only the ASCII part matters
+                    names[slot].push_back((raw[i] < 0x80U) ? char(raw[i]) : '?');
+                }
+            } else {
+                names[slot] = utf16be_to_utf8(raw, size);
+            }
+
+            scores[slot] = score;
+        }
+    }
+
+    (*family) = names[size_t(FontName::TypographicFamily)];
+    (*style) = names[size_t(FontName::TypographicStyle)];
+
+    if (family->empty()) (*family) = names[size_t(FontName::Family)];
+    if (style->empty()) (*style) = names[size_t(FontName::Style)];
+
+    return !family->empty();
+}
+
+static void font_read_faces(const std::string& file, std::vector<FontFace>& faces) {
+    std::ifstream in(file, std::ios::binary);
+    uint8_t header[12];
+
+    if (in && font_read(in, 0U, header, sizeof(header))) {
+        FontFace face = { file, 0, "", "" };
+
+        if (memcmp(header, "ttcf", 4) == 0) {
+            uint32_t n = network_uint32_ref(header, 8);
+            uint8_t offset[4];
+
+            for (uint32_t idx = 0; (idx < n) && (idx < 256U); idx ++) {
+                if (font_read(in, 12U + idx * 4U, offset, sizeof(offset))) {
+                    if (font_read_names(in, network_uint32_ref(offset, 0), &face.family, &face.style)) {
+                        face.index = int(idx);
+                        faces.push_back(face);
+                    }
+                }
+            }
+        } else if (font_read_names(in, 0U, &face.family, &face.style)) {
+            faces.push_back(face);
+        }
+    }
+}
+
+/*************************************************************************************************/
+static int64_t directory_mtime(const path& dir) {
+    std::error_code ec;
+    auto mtime = last_write_time(dir, ec);
+
+    return ec ? 0 : int64_t(mtime.time_since_epoch().count());
+}
+
+static int64_t directory_entry_count(const path& dir) {
+    std::error_code ec;
+    int64_t count = 0;
+
+    for (auto it = directory_iterator(dir, ec); !ec && (it != directory_iterator()); it.increment(ec)) {
+        count ++;
+    }
+
+    return ec ? -1 : count;
+}
+
+static void font_scan_directory(FontIndex& idx, size_t slot) {
+    path dir(idx.dirs[slot].path);
+    std::error_code ec;
+    int64_t count = 0;
+
+    idx.dirs[slot].mtime = directory_mtime(dir);
+
+    for (auto it = directory_iterator(dir, ec); !ec && (it != directory_iterator()); it.increment(ec)) {
+        const directory_entry& entry = (*it);
+        path self = entry.path();
+        std::error_code fec;
+
+        if (font_scan_stopping) break;
+
+        count ++;
+
+        if (entry.is_directory(fec)) {
+            idx.dirs.push_back({ self.string(), 0, 0 });
+            font_scan_directory(idx, idx.dirs.size() - 1U);
+        } else if (entry.is_regular_file(fec)) {
+            idx.files.push_back(self.string());
+
+            if (is_font_file(self)) {
+                font_read_faces(idx.files.back(), idx.faces);
+            }
+        }
+    }
+
+    idx.dirs[slot].count = (ec ? -1 : count);
+}
+
+static void font_index_scan(FontIndex& idx, const std::vector<std::string>& roots) {
+    for (auto root : roots) {
+        idx.dirs.push_back({ root, 0, -1 });
+    }
+
+    for (size_t slot = 0; slot < roots.size(); slot ++) {
+        std::error_code ec;
+
+        if (is_directory(path(roots[slot]), ec)) {
+            font_scan_directory(idx, slot);
+        }
+    }
+}
+
+static bool font_index_fresh(const std::vector<FontDirectory>& dirs, const std::vector<std::string>& roots) {
+    if (dirs.size() < roots.size()) return false;
+
+    for (size_t idx = 0; idx < roots.size(); idx ++) {
+        if (dirs[idx].path != roots[idx]) return false;
+    }
+
+    for (auto dir : dirs) {
+        path self(dir.path);
+        std::error_code ec;
+
+        if (font_scan_stopping) return false;
+
+        if (dir.count < 0) {
+            if (is_directory(self, ec)) return false;
+        } else if (directory_mtime(self) != dir.mtime) {
+            return false;
+        } else if (directory_entry_count(self) != dir.count) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void font_index_build_tables(FontIndex& idx) {
+    idx.filenames.clear();
+    idx.families.clear();
+
+    for (size_t i = 0; i < idx.files.size(); i ++) {
+        idx.filenames[path(idx.files[i]).filename().string()] = i;
+    }
+
+    for (size_t i = 0; i < idx.faces.size(); i ++) {
+        idx.families[string_ascii_lowercase(idx.faces[i].family)].push_back(i);
+    }
+}
+
+/*************************************************************************************************/
+static path font_index_path() {
+    path cachedir;
+
+#if defined(__windows__)
+    const char* local = getenv("LOCALAPPDATA");
+
+    if (local != nullptr) cachedir = path(local);
+#elif defined(__macosx__)
+    const char* home = getenv("HOME");
+
+    if (home != nullptr) cachedir = path(home) / "Library" / "Caches";
+#else
+    const char* xdg = getenv("XDG_CACHE_HOME");
+    const char* home = getenv("HOME");
+
+    if ((xdg != nullptr) && (xdg[0] != '\0')) {
+        cachedir = path(xdg);
+    } else if (home != nullptr) {
+        cachedir = path(home) / ".cache";
+    }
+#endif
+
+    return cachedir.empty() ? cachedir : (cachedir / "plteen" / "fonts.idx");
+}
+
+static void index_write(std::string& dest, const void* src, size_t size) {
+    dest.append(reinterpret_cast<const char*>(src), size);
+}
+
+static void index_write(std::string& dest, int64_t n) {
+    index_write(dest, &n, sizeof(n));
+}
+
+static void index_write(std::string& dest, const std::string& s) {
+    index_write(dest, int64_t(s.size()));
+    index_write(dest, s.data(), s.size());
+}
+
+static bool index_read(const std::string& src, size_t* pos, void* dest, size_t size) {
+    bool okay = ((*pos) + size <= src.size());
+
+    if (okay) {
+        memcpy(dest, src.data() + (*pos), size);
+        (*pos) += size;
+    }
+
+    return okay;
+}
+
+static bool index_read(const std::string& src, size_t* pos, int64_t* n) {
+    return index_read(src, pos, n, sizeof(int64_t));
+}
+
+static bool index_read(const std::string& src, size_t* pos, std::string* s) {
+    int64_t size = 0;
+    bool okay = index_read(src, pos, &size) && (size >= 0) && ((*pos) + size_t(size) <= src.size());
+
+    if (okay) {
+        s->assign(src.data() + (*pos), size_t(size));
+        (*pos) += size_t(size);
+    }
+
+    return okay;
+}
+
+/**
+ * The index is a cache of this machine, in native byte order:
+ *   magic, directories { path, mtime, count }, files { path }, faces { path, index, family, style },
+ *   each sequence is prefixed by its length.
+ */
+static void font_index_save(const FontIndex& idx, const path& file) {
+    std::string raw;
+    std::error_code ec;
+
+    index_write(raw, font_index_magic, sizeof(font_index_magic));
+
+    index_write(raw, int64_t(idx.dirs.size()));
+    for (auto dir : idx.dirs) {
+        index_write(raw, dir.path);
+        index_write(raw, dir.mtime);
+        index_write(raw, dir.count);
+    }
+
+    index_write(raw, int64_t(idx.files.size()));
+    for (auto f : idx.files) {
+        index_write(raw, f);
+    }
+
+    index_write(raw, int64_t(idx.faces.size()));
+    for (auto face : idx.faces) {
+        index_write(raw, face.path);
+        index_write(raw, int64_t(face.index));
+        index_write(raw, face.family);
+        index_write(raw, face.style);
+    }
+
+    create_directories(file.parent_path(), ec);
+
+    if (!ec) { // write aside, then move it in place, so that readers never see a partial index
+        path temp(file.string() + ".tmp");
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+
+        out.write(raw.data(), std::streamsize(raw.size()));
+        out.close();
+
+        if (out.good()) {
+            rename(temp, file, ec);
+        }
+
+        if (ec || !out.good()) {
+            fprintf(stderr, "无法保存字体索引 '%s'\n", file.string().c_str());
+            remove(temp, ec);
+        }
+    }
+}
+
+static bool font_index_load(FontIndex& idx, const path& file) {
+    std::ifstream in(file, std::ios::binary);
+    std::string raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    char magic[sizeof(font_index_magic)];
+    size_t pos = 0U;
+    int64_t n = 0;
+    bool okay = index_read(raw, &pos, magic, sizeof(magic)) && (memcmp(magic, font_index_magic, sizeof(magic)) == 0);
+
+    if (okay && (okay = index_read(raw, &pos, &n))) {
+        for (int64_t i = 0; okay && (i < n); i ++) {
+            FontDirectory dir;
+
+            okay = index_read(raw, &pos, &dir.path) && index_read(raw, &pos, &dir.mtime) && index_read(raw, &pos, &dir.count);
+            if (okay) idx.dirs.push_back(dir);
+        }
+    }
+
+    if (okay && (okay = index_read(raw, &pos, &n))) {
+        for (int64_t i = 0; okay && (i < n); i ++) {
+            std::string f;
+
+            okay = index_read(raw, &pos, &f);
+            if (okay) idx.files.push_back(f);
+        }
+    }
+
+    if (okay && (okay = index_read(raw, &pos, &n))) {
+        for (int64_t i = 0; okay && (i < n); i ++) {
+            FontFace face;
+            int64_t index = 0;
+
+            okay = index_read(raw, &pos, &face.path) && index_read(raw, &pos, &index)
+                    && index_read(raw, &pos, &face.family) && index_read(raw, &pos, &face.style);
+
+            if (okay) {
+                face.index = int(index);
+                idx.faces.push_back(face);
+            }
+        }
+    }
+
+    if (!okay) {
+        idx = FontIndex();
+    }
+
+    return okay;
+}
+
+/*************************************************************************************************/
+static void font_index_refresh(std::vector<std::string> roots, std::vector<FontDirectory> dirs, path file) {
+    if (!font_index_fresh(dirs, roots) && !font_scan_stopping) {
+        FontIndex fresh;
+
+        font_index_scan(fresh, roots);
+
+        if (!font_scan_stopping) {
+            font_index_build_tables(fresh);
+
+            if (!file.empty()) {
+                font_index_save(fresh, file);
+            }
+
+            std::unique_lock<std::mutex> guard(font_index_lock);
+            font_index = std::move(fresh);
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> guard(font_index_lock);
+        font_scanning = false;
+    }
+
+    font_index_scanned.notify_all();
+}
+
+static void font_index_wait(std::unique_lock<std::mutex>& guard) {
+    // a stale index is served as is, only the very first scan is waited for
+    if (font_index.dirs.empty()) {
+        font_index_scanned.wait(guard, [] { return !font_scanning; });
+    }
+}
+
+static void font_fallback_walk(const path& root) {
+    std::error_code ec;
+
+    for (auto it = directory_iterator(root, ec); !ec && (it != directory_iterator()); it.increment(ec)) {
+        const directory_entry& entry = (*it);
+        std::error_code fec;
+
+        if (entry.is_directory(fec)) {
+            font_fallback_walk(entry.path());
+        } else if (entry.is_regular_file(fec)) {
+            font_fallback_files[entry.path().filename().string()] = entry.path().string();
+        }
+    }
+}
+
+template<typename Lookup>
+static bool font_index_lookup(Lookup lookup) {
+    std::unique_lock<std::mutex> guard(font_index_lock);
+
+    // never wait for the first scan, which reads every font file
+    return !font_index.dirs.empty() && lookup(font_index);
+}
+
+/*************************************************************************************************/
+void Plteen::game_font_directories_initialize(const std::string* dirs, size_t n) {
+    if (font_scanner == nullptr) {
+        path file = font_index_path();
+
+        font_roots.assign(dirs, dirs + n);
+
+        if (!file.empty() && font_index_load(font_index, file)) {
+            font_index_build_tables(font_index);
+        }
+
+        font_scan_stopping = false;
+        font_scanning = true;
+        font_scanner = new std::thread(font_index_refresh, font_roots, font_index.dirs, file);
+    }
+}
+
+void Plteen::game_font_directories_destroy() {
+    if (font_scanner != nullptr) {
+        font_scan_stopping = true;
+        font_scanner->join();
+        delete font_scanner;
+        font_scanner = nullptr;
+    }
+}
+
+bool Plteen::game_font_file_path(const std::string& filename, std::string* file) {
+    std::unique_lock<std::mutex> guard(font_index_lock);
+    bool found = false;
+
+    if (!font_index.dirs.empty()) {
+        auto it = font_index.filenames.find(filename);
+        
+        if (it != font_index.filenames.end()) {
+            SET_BOX(file, font_index.files[it->second]);
+            found = true;
+        }
+    } else {
+        // what the startup did before there was an index, filenames are much cheaper than 'name' tables
+        if (!font_fallback_walked) {
+            for (auto root : font_roots) {
+                font_fallback_walk(path(root));
+            }
+
+            font_fallback_walked = true;
+        }
+
+        auto it = font_fallback_files.find(filename);
+
+        if (it != font_fallback_files.end()) {
+            SET_BOX(file, it->second);
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+bool Plteen::game_font_family_face(const std::string& family, const std::string& style, FontFace* face) {
+    std::string key = string_ascii_lowercase(family);
+
+    return font_index_lookup([&](FontIndex& idx) {
+        auto it = idx.families.find(key);
+        const FontFace* self = nullptr;
+
+        if (it != idx.families.end()) {
+            bool regular = is_regular_style(style);
+
+            for (auto i : it->second) {
+                const FontFace& f = idx.faces[i];
+
+                if (string_ci_equal(f.style, style)) {
+                    self = &f;
+                    break;
+                } else if ((self == nullptr) || (regular && is_regular_style(f.style) && !is_regular_style(self->style))) {
+                    self = &f;
+                }
+            }
+        }
+
+        if (self != nullptr) {
+            SET_BOX(face, *self);
+        }
+
+        return (self != nullptr);
+    });
+}
+
+std::vector<std::string> Plteen::game_font_filenames() {
+    std::unique_lock<std::mutex> guard(font_index_lock);
+    std::vector<std::string> filenames;
+
+    font_index_wait(guard);
+
+    for (auto f : font_index.filenames) {
+        filenames.push_back(f.first);
+    }
+
+    return filenames;
+}
+
+std::vector<FontFace> Plteen::game_font_faces() {
+    std::unique_lock<std::mutex> guard(font_index_lock);
+
+    font_index_wait(guard);
+
+    return font_index.faces;
+}
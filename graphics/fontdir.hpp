@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Plteen {
+    struct __lambda__ FontFace {
+        std::string path;
+        int index; // of the face in a collection
+        std::string family;
+        std::string style;
+    };
+
+    /**
+     * Font files under the system font directories,
+     *   and the faces they provide, named by the 'name' tables of the fonts.
+     *
+     * The index persists in the user cache directory,
+     *   so that startup only reads the index file back,
+     *   a background thread then validates it against the mtimes and entry counts of the directories,
+     *   and rescans them only if anything changed.
+     *
+     * Lookups serve the stale index during the rescan.
+     * If there is no index yet, lookups never wait for the scan,
+     *   filenames are found by walking the directories once, and families are not found;
+     *   only the enumerations wait.
+     */
+    __lambda__ void game_font_directories_initialize(const std::string* dirs, size_t n);
+    __lambda__ void game_font_directories_destroy();
+
+    __lambda__ bool game_font_file_path(const std::string& filename, std::string* path);
+    __lambda__ bool game_font_family_face(const std::string& family, const std::string& style, Plteen::FontFace* face);
+    __lambda__ std::vector<std::string> game_font_filenames();
+    __lambda__ std::vector<Plteen::FontFace> game_font_faces();
+}
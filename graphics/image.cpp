@@ -1,8 +1,15 @@
 #include <SDL2/SDL.h>                 // 放最前面以兼容 macOS
 #include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include <cstring>
+#include <cstdlib>
 
 #include "image.hpp"
 #include "../datum/flonum.hpp"
+#include "../datum/bytes.hpp"
+#include "../wormhole/checksum/crc32.hpp"
 
 using namespace Plteen;
 
@@ -60,6 +67,294 @@ void Plteen::game_unload_image(SDL_Texture* image) {
     SDL_DestroyTexture(image);
 }
 
+/*************************************************************************************************/
+static const uint16_t deflate_length_bases[] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const uint8_t deflate_length_extras[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+namespace {
+    /**
+     * Deflate with the fixed Huffman codes, matches are runs of the previous byte or the previous pixel,
+     *   what zlib does with `Z_RLE`, which is fast and good at screenshots once filtered.
+     */
+    class FixedDeflater {
+    public:
+        FixedDeflater(std::vector<uint8_t>& dest) : dest(dest) {}
+
+    public:
+        void begin() {
+            this->write_bits(1U, 1U); // BFINAL, everything goes into one block
+            this->write_bits(1U, 2U); // BTYPE: fixed Huffman codes
+        }
+
+        void deflate(const uint8_t* src, size_t size) {
+            size_t idx = 0U;
+
+            while (idx < size) {
+                size_t run = 0U;
+                size_t distance = 0U;
+
+                if (this->history >= 1U) {
+                    run = this->match(src, idx, size, 1U);
+                    distance = 1U;
+                }
+
+                if ((run < 8U) && (this->history >= 4U)) {
+                    size_t prun = this->match(src, idx, size, 4U);
+
+                    if (prun > run) {
+                        run = prun;
+                        distance = 4U;
+                    }
+                }
+
+                if (run >= 3U) {
+                    this->write_length(run);
+                    this->write_huffman(distance - 1U, 5U); // distance codes 0 and 3 have no extra bits
+                } else {
+                    this->write_literal(src[idx]);
+                    run = 1U;
+                }
+
+                for (size_t i = 0U; i < run; i ++) {
+                    this->window[(this->history + i) & 3U] = src[idx + i];
+                }
+
+                this->history += run;
+                idx += run;
+            }
+        }
+
+        void finish() {
+            this->write_huffman(0U, 7U); // end of block
+            
+            if (this->nbits > 0U) {
+                this->dest.push_back(uint8_t(this->bits));
+            }
+
+            this->bits = 0U;
+            this->nbits = 0U;
+        }
+
+    private:
+        size_t match(const uint8_t* src, size_t idx, size_t size, size_t distance) {
+            size_t run = 0U;
+
+            while ((idx + run < size) && (run < 258U)) {
+                uint8_t prev = (run < distance) ? this->window[(this->history + run - distance) & 3U] : src[idx + run - distance];
+
+                if (src[idx + run] != prev) break;
+                run ++;
+            }
+
+            return run;
+        }
+
+        void write_literal(uint8_t ch) {
+            if (ch < 144U) {
+                this->write_huffman(0x30U + ch, 8U);
+            } else {
+                this->write_huffman(0x190U + (ch - 144U), 9U);
+            }
+        }
+
+        void write_length(size_t length) {
+            size_t code = 28U;
+
+            while (deflate_length_bases[code] > length) {
+                code --;
+            }
+
+            if (code < 23U) { // 257 - 279
+                this->write_huffman(uint32_t(code + 1U), 7U);
+            } else { // 280 - 285
+                this->write_huffman(uint32_t(0xC0U + (code - 23U)), 8U);
+            }
+
+            this->write_bits(uint32_t(length - deflate_length_bases[code]), deflate_length_extras[code]);
+        }
+
+        void write_huffman(uint32_t code, uint32_t length) { // Huffman codes go from the most significant bit
+            uint32_t reversed = 0U;
+
+            for (uint32_t i = 0U; i < length; i ++) {
+                reversed = (reversed << 1U) | ((code >> i) & 1U);
+            }
+
+            this->write_bits(reversed, length);
+        }
+
+        void write_bits(uint32_t value, uint32_t length) {
+            this->bits |= (uint64_t(value) << this->nbits);
+            this->nbits += length;
+
+            while (this->nbits >= 8U) {
+                this->dest.push_back(uint8_t(this->bits));
+                this->bits >>= 8U;
+                this->nbits -= 8U;
+            }
+        }
+
+    private:
+        std::vector<uint8_t>& dest;
+        uint64_t bits = 0U;
+        uint32_t nbits = 0U;
+        uint8_t window[4]; // the last 4 bytes, matches never look further
+        size_t history = 0U;
+    };
+}
+
+static inline uint8_t png_paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = int(a) + int(b) - int(c);
+    int pa = abs(p - int(a));
+    int pb = abs(p - int(b));
+    int pc = abs(p - int(c));
+
+    return ((pa <= pb) && (pa <= pc)) ? a : ((pb <= pc) ? b : c);
+}
+
+static const uint8_t png_filters[] = { 1U, 2U, 4U }; // Sub, Up, Paeth
+
+static void png_filter_row(uint8_t* dest, const uint8_t* row, const uint8_t* prev, size_t size) {
+    // the filter of least sum of absolute differences, as libpng does
+    uint8_t* candidates[3] = { dest, dest + size + 1U, dest + (size + 1U) * 2U };
+    size_t best = 0U;
+    size_t best_cost = SIZE_MAX;
+
+    for (size_t f = 0U; f < 3U; f ++) {
+        uint8_t* self = candidates[f];
+        size_t cost = 0U;
+
+        self[0] = png_filters[f];
+
+        for (size_t i = 0U; i < size; i ++) {
+            uint8_t a = (i >= 4U) ? row[i - 4U] : 0U;
+            uint8_t b = (prev != nullptr) ? prev[i] : 0U;
+            uint8_t c = ((i >= 4U) && (prev != nullptr)) ? prev[i - 4U] : 0U;
+            uint8_t d = 0U;
+
+            switch (f) {
+            case 0: d = uint8_t(row[i] - a); break;
+            case 1: d = uint8_t(row[i] - b); break;
+            default: d = uint8_t(row[i] - png_paeth(a, b, c));
+            }
+
+            self[i + 1U] = d;
+            cost += size_t((d < 128U) ? d : (256U - d));
+        }
+
+        if (cost < best_cost) {
+            best_cost = cost;
+            best = f;
+        }
+    }
+
+    if (best != 0U) {
+        memcpy(dest, candidates[best], size + 1U);
+    }
+}
+
+static void png_write_chunk(std::vector<uint8_t>& png, const char* type, const uint8_t* data, size_t size) {
+    uint8_t u32[4];
+    size_t start = png.size() + 4U;
+
+    network_uint32_set(u32, 0, uint32_t(size));
+    png.insert(png.end(), u32, u32 + 4);
+    png.insert(png.end(), type, type + 4);
+
+    if (size > 0U) {
+        png.insert(png.end(), data, data + size);
+    }
+
+    network_uint32_set(u32, 0, checksum_crc32(png.data(), start, png.size()));
+    png.insert(png.end(), u32, u32 + 4);
+}
+
+static void png_encode(std::vector<uint8_t>& png, const uint8_t* rgba, size_t width, size_t height, size_t pitch, bool compressed) {
+    static const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    size_t rowsize = width * 4U;
+    std::vector<uint8_t> filtered((rowsize + 1U) * 3U);
+    std::vector<uint8_t> zlib = { 0x78, 0x01 };
+    uint8_t ihdr[13];
+    uint32_t adler_a = 1U;
+    uint32_t adler_b = 0U;
+
+    png.insert(png.end(), signature, signature + sizeof(signature));
+    network_uint32_set(ihdr, 0, uint32_t(width));
+    network_uint32_set(ihdr, 4, uint32_t(height));
+    ihdr[8] = 8U;  // bit depth
+    ihdr[9] = 6U;  // RGBA
+    ihdr[10] = ihdr[11] = ihdr[12] = 0U;
+    png_write_chunk(png, "IHDR", ihdr, sizeof(ihdr));
+
+    zlib.reserve(compressed ? (rowsize * height / 4U) : ((rowsize + 6U) * height + 16U));
+
+    {
+        FixedDeflater deflater(zlib);
+
+        if (compressed) {
+            deflater.begin();
+        }
+
+        for (size_t y = 0U; y < height; y ++) {
+            const uint8_t* row = rgba + y * pitch;
+
+            if (compressed) {
+                png_filter_row(filtered.data(), row, (y > 0U) ? (row - pitch) : nullptr, rowsize);
+            } else {
+                filtered[0] = 0U;
+                memcpy(filtered.data() + 1U, row, rowsize);
+            }
+
+            for (size_t i = 0U; i < rowsize + 1U; i ++) { // the sums never overflow within 5552 bytes
+                adler_a += filtered[i];
+                adler_b += adler_a;
+
+                if ((i & 0xFFFU) == 0xFFFU) {
+                    adler_a %= 65521U;
+                    adler_b %= 65521U;
+                }
+            }
+
+            adler_a %= 65521U;
+            adler_b %= 65521U;
+
+            if (compressed) {
+                deflater.deflate(filtered.data(), rowsize + 1U);
+            } else { // one stored block per row, as long as a row fits in 65535 bytes
+                size_t offset = 0U;
+
+                do {
+                    size_t size = std::min(rowsize + 1U - offset, size_t(0xFFFFU));
+                    bool final = ((y + 1U == height) && (offset + size == rowsize + 1U));
+                    
+                    zlib.push_back(final ? 1U : 0U);
+                    zlib.push_back(uint8_t(size));
+                    zlib.push_back(uint8_t(size >> 8U));
+                    zlib.push_back(uint8_t(~size));
+                    zlib.push_back(uint8_t(~size >> 8U));
+                    zlib.insert(zlib.end(), filtered.data() + offset, filtered.data() + offset + size);
+                    offset += size;
+                } while (offset < rowsize + 1U);
+            }
+        }
+
+        if (compressed) {
+            deflater.finish();
+        }
+    }
+
+    zlib.resize(zlib.size() + 4U);
+    network_uint32_set(zlib.data(), zlib.size() - 4U, (adler_b << 16U) | adler_a);
+
+    png_write_chunk(png, "IDAT", zlib.data(), zlib.size());
+    png_write_chunk(png, "IEND", nullptr, 0U);
+}
+
 /*************************************************************************************************/
 bool Plteen::game_save_image(SDL_Surface* png, const std::string& pname) {
     return game_save_image(png, pname.c_str());
@@ -77,3 +372,55 @@ bool Plteen::game_save_image(SDL_Surface* png, const char* pname) {
 
     return okay;
 }
+
+bool Plteen::game_save_image(SDL_Surface* png, const char* pname, PNGCompression level) {
+    bool okay = false;
+
+    if (level == PNGCompression::Default) {
+        okay = game_save_image(png, pname);
+    } else if (png != nullptr) {
+        SDL_Surface* rgba = png;
+
+        if (png->format->format != SDL_PIXELFORMAT_RGBA32) {
+            rgba = SDL_ConvertSurfaceFormat(png, SDL_PIXELFORMAT_RGBA32, 0);
+        }
+
+        if (rgba != nullptr) {
+            okay = game_save_png(reinterpret_cast<const uint8_t*>(rgba->pixels), rgba->w, rgba->h, rgba->pitch, pname, level);
+
+            if (rgba != png) {
+                SDL_FreeSurface(rgba);
+            }
+        }
+    }
+
+    return okay;
+}
+
+bool Plteen::game_save_png(const uint8_t* rgba, int width, int height, int pitch, const char* pname, PNGCompression level) {
+    std::vector<uint8_t> png;
+    bool okay = false;
+
+    if ((rgba != nullptr) && (width > 0) && (height > 0)) {
+        if (level == PNGCompression::Default) {
+            SDL_Surface* self = SDL_CreateRGBSurfaceWithFormatFrom(const_cast<uint8_t*>(rgba), width, height, 32, pitch, SDL_PIXELFORMAT_RGBA32);
+
+            if (self != nullptr) {
+                okay = game_save_image(self, pname);
+                SDL_FreeSurface(self);
+            }
+        } else {
+            png_encode(png, rgba, size_t(width), size_t(height), size_t(pitch), (level == PNGCompression::Fast));
+            std::error_code ec;
+
+            create_directories(std::filesystem::path(pname).parent_path(), ec);
+
+            std::ofstream out(pname, std::ios::binary | std::ios::trunc);
+
+            out.write(reinterpret_cast<const char*>(png.data()), std::streamsize(png.size()));
+            okay = out.good();
+        }
+    }
+
+    return okay;
+}
@@ -6,6 +6,12 @@
 #include <string>
 
 namespace Plteen {
+    /**
+     * `Store` and `Fast` are encoded in place, by stored blocks and run-length matches respectively,
+     *   `Default` is whatever `IMG_SavePNG` does, the smallest but the slowest.
+     */
+    enum class PNGCompression { Store, Fast, Default };
+
     __lambda__ SDL_Texture* game_blank_image(SDL_Renderer* renderer, int width, int height);
     __lambda__ SDL_Texture* game_blank_image(SDL_Renderer* renderer, float width, float height);
 
@@ -19,4 +25,7 @@ namespace Plteen {
 
     __lambda__ bool game_save_image(SDL_Surface* png, const std::string& pname);
     __lambda__ bool game_save_image(SDL_Surface* png, const char* pname);
+    __lambda__ bool game_save_image(SDL_Surface* png, const char* pname, Plteen::PNGCompression level);
+    __lambda__ bool game_save_png(const uint8_t* rgba, int width, int height, int pitch, const char* pname,
+                                    Plteen::PNGCompression level = PNGCompression::Fast); // bytes in R, G, B, A order
 }
@@ -0,0 +1,73 @@
+#include "label.hpp"
+#include "dc.hpp"
+
+#include "../datum/hash.hpp"
+
+using namespace Plteen;
+
+/*************************************************************************************************/
+bool Plteen::LabelCache::Key::operator==(const Key& rhs) const {
+    return (this->font == rhs.font)
+            && (this->rgba == rhs.rgba)
+            && (this->font_selection_disabled == rhs.font_selection_disabled)
+            && (this->text == rhs.text);
+}
+
+size_t Plteen::LabelCache::KeyHash::operator()(const Key& key) const {
+    size_t hash = 0;
+
+    hash_combine(hash, key.text);
+    hash_combine(hash, key.font);
+    hash_combine(hash, key.rgba);
+    hash_combine(hash, key.font_selection_disabled);
+
+    return hash;
+}
+
+/*************************************************************************************************/
+shared_texture_t Plteen::LabelCache::ref(DrawingContext* dc, const std::string& text, const shared_font_t& font, const RGBA& color, bool font_selection_disabled) {
+    shared_texture_t texture = nullptr;
+    uint8_t r, g, b, a;
+    Key key;
+
+    color.unbox(&r, &g, &b, &a);
+    key.font = font.get();
+    key.rgba = (uint32_t(r) << 24U) | (uint32_t(g) << 16U) | (uint32_t(b) << 8U) | uint32_t(a);
+    key.font_selection_disabled = font_selection_disabled;
+    key.text = text;
+
+    auto it = this->index.find(key);
+
+    if (it != this->index.end()) {
+        this->entries.splice(this->entries.begin(), this->entries, it->second);
+        texture = it->second->texture;
+    } else {
+        texture = std::make_shared<Texture>(dc->create_blended_text(text, font, color));
+
+        // failures are not cached, they might be caused by a transient state of the renderer
+        if (texture->okay() && (this->capacity > 0U)) {
+            this->entries.push_front({ key, font, texture });
+            this->index[key] = this->entries.begin();
+            this->evict();
+        }
+    }
+
+    return texture;
+}
+
+void Plteen::LabelCache::set_capacity(size_t n) {
+    this->capacity = n;
+    this->evict();
+}
+
+void Plteen::LabelCache::clear() {
+    this->index.clear();
+    this->entries.clear();
+}
+
+void Plteen::LabelCache::evict() {
+    while (this->entries.size() > this->capacity) {
+        this->index.erase(this->entries.back().key);
+        this->entries.pop_back();
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "font.hpp"
+#include "texture.hpp"
+
+#include "../physics/color/rgba.hpp"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace Plteen {
+    class DrawingContext;
+
+    /**
+     * Blended text textures keyed by (font, text, color),
+     *   the least recently used ones are evicted once over capacity.
+     *
+     * Each drawing context owns one, so that labels are shared by all matters on the same renderer.
+     */
+    class __lambda__ LabelCache {
+    public:
+        LabelCache(size_t capacity = 512U) : capacity(capacity) {}
+
+    public:
+        Plteen::shared_texture_t ref(Plteen::DrawingContext* dc, const std::string& text,
+                    const Plteen::shared_font_t& font, const Plteen::RGBA& color, bool font_selection_disabled);
+
+    public:
+        void set_capacity(size_t n);
+        size_t size() { return this->entries.size(); }
+        void clear();
+
+    private:
+        struct Key {
+            Plteen::GameFont* font;
+            uint32_t rgba;
+            bool font_selection_disabled;
+            std::string text;
+
+            bool operator==(const Key& rhs) const;
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const;
+        };
+
+        struct Entry {
+            Key key;
+            Plteen::shared_font_t font; // keeps the font alive so that its address cannot be reused
+            Plteen::shared_texture_t texture;
+        };
+
+    private:
+        void evict();
+
+    private:
+        std::list<Entry> entries; // the front is the most recently used
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        size_t capacity;
+    };
+}
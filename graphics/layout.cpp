@@ -0,0 +1,157 @@
+#include "layout.hpp"
+
+#include "../datum/hash.hpp"
+#include "../datum/box.hpp"
+
+using namespace Plteen;
+
+/*************************************************************************************************/
+static const SDL_Color layout_color = { 0xFF, 0xFF, 0xFF, 0xFF };
+
+static inline size_t layout_size(SDL_Surface* layout) {
+    return (layout == nullptr) ? 0U : size_t(layout->pitch) * size_t(layout->h);
+}
+
+/*************************************************************************************************/
+bool Plteen::TextLayoutCache::Key::operator==(const Key& rhs) const {
+    return (this->font == rhs.font)
+            && (this->style == rhs.style)
+            && (this->wrap == rhs.wrap)
+            && (this->text == rhs.text);
+}
+
+size_t Plteen::TextLayoutCache::KeyHash::operator()(const Key& key) const {
+    size_t hash = 0;
+
+    hash_combine(hash, key.text);
+    hash_combine(hash, key.font);
+    hash_combine(hash, key.style);
+    hash_combine(hash, key.wrap);
+
+    return hash;
+}
+
+/*************************************************************************************************/
+void Plteen::TextLayoutCache::feed_extent(TTF_Font* font, const char* text, int* width, int* height) {
+    Entry* entry = this->ref(font, text, -1);
+
+    if (entry->measured) {
+        this->nhits ++;
+    } else {
+        this->nmisses ++;
+
+        if (TTF_SizeUTF8(font, text, &entry->width, &entry->height) == 0) {
+            entry->measured = true;
+        }
+    }
+
+    SET_BOX(width, entry->width);
+    SET_BOX(height, entry->height);
+    this->evict();
+}
+
+SDL_Surface* Plteen::TextLayoutCache::ref_layout(TTF_Font* font, const std::string& text, int wrap) {
+    Entry* entry = this->ref(font, text.c_str(), wrap);
+    SDL_Surface* layout = entry->layout;
+
+    if (layout != nullptr) {
+        this->nhits ++;
+    } else {
+        this->nmisses ++;
+
+#ifndef __windows__
+        if (wrap >= 0) { // will wrap by newline for 0
+            layout = TTF_RenderUTF8_Blended_Wrapped(font, text.c_str(), layout_color, wrap);
+        } else {
+#endif
+            layout = TTF_RenderUTF8_Blended(font, text.c_str(), layout_color);
+#ifndef __windows__
+        }
+#endif
+
+        // failures are not cached, the caller reports them
+        if (layout != nullptr) {
+            entry->layout = layout;
+            this->resize(entry);
+        }
+    }
+
+    if (layout != nullptr) {
+        layout->refcount ++; // the entry might be evicted right away
+    }
+
+    this->evict();
+
+    return layout;
+}
+
+void Plteen::TextLayoutCache::forget(TTF_Font* font) {
+    auto it = this->entries.begin();
+
+    while (it != this->entries.end()) {
+        auto self = it ++;
+
+        if (self->key.font == font) {
+            this->drop(self);
+        }
+    }
+}
+
+void Plteen::TextLayoutCache::set_budget(size_t bytes) {
+    this->budget = bytes;
+    this->evict();
+}
+
+void Plteen::TextLayoutCache::clear() {
+    while (!this->entries.empty()) {
+        this->drop(this->entries.begin());
+    }
+}
+
+/*************************************************************************************************/
+TextLayoutCache::Entry* Plteen::TextLayoutCache::ref(TTF_Font* font, const char* text, int wrap) {
+    Key key = { font, TTF_GetFontStyle(font), wrap, text };
+    auto it = this->index.find(key);
+
+    if (it != this->index.end()) {
+        this->entries.splice(this->entries.begin(), this->entries, it->second);
+    } else {
+        this->entries.push_front({ key });
+        this->index[key] = this->entries.begin();
+        this->resize(&this->entries.front());
+    }
+
+    return &this->entries.front();
+}
+
+void Plteen::TextLayoutCache::resize(Entry* entry) {
+    this->bytes -= entry->bytes;
+
+    // the text is held by both the entry and the index
+    entry->bytes = sizeof(Entry) + entry->key.text.size() * 2U + layout_size(entry->layout);
+    this->bytes += entry->bytes;
+}
+
+void Plteen::TextLayoutCache::evict() {
+    while ((this->bytes > this->budget) && !this->entries.empty()) {
+        this->drop(std::prev(this->entries.end()));
+    }
+}
+
+void Plteen::TextLayoutCache::drop(std::list<Entry>::iterator it) {
+    if (it->layout != nullptr) {
+        SDL_FreeSurface(it->layout);
+    }
+
+    this->bytes -= it->bytes;
+    this->index.erase(it->key);
+    this->entries.erase(it);
+}
+
+/*************************************************************************************************/
+TextLayoutCache* Plteen::game_text_layouts() {
+    // never destructed, fonts might be closed during the static destruction
+    static TextLayoutCache* layouts = new TextLayoutCache();
+
+    return layouts;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <SDL2/SDL_ttf.h>
+
+#include <list>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+namespace Plteen {
+    /**
+     * Measured extents and blended line layouts keyed by (font, style, wrap width, text),
+     *   the least recently used ones are evicted once over the memory budget.
+     *
+     * A layout is the text rendered in opaque white, wrapped lines included,
+     *   the color is applied as the color and alpha mods of the textures made from it,
+     *   so that redrawing a string at a different color neither measures nor lays it out again.
+     *
+     * Entries are keyed by raw `TTF_Font*`s, fonts have to be forgotten before being closed.
+     */
+    class __lambda__ TextLayoutCache {
+    public:
+        TextLayoutCache(size_t budget = 8U * 1024U * 1024U) : budget(budget) {}
+        virtual ~TextLayoutCache() noexcept { this->clear(); }
+
+    public:
+        void feed_extent(TTF_Font* font, const char* text, int* width, int* height);
+        SDL_Surface* ref_layout(TTF_Font* font, const std::string& text, int wrap); // a new reference, or `nullptr`
+        void forget(TTF_Font* font);
+
+    public:
+        void set_budget(size_t bytes);
+        size_t memory() { return this->bytes; }
+        size_t size() { return this->entries.size(); }
+        uint64_t hits() { return this->nhits; }
+        uint64_t misses() { return this->nmisses; }
+        void clear();
+
+    private:
+        struct Key {
+            TTF_Font* font;
+            int style;
+            int wrap;
+            std::string text;
+
+            bool operator==(const Key& rhs) const;
+        };
+
+        struct KeyHash {
+            size_t operator()(const Key& key) const;
+        };
+
+        struct Entry {
+            Key key;
+            int width = 0;
+            int height = 0;
+            bool measured = false;
+            SDL_Surface* layout = nullptr;
+            size_t bytes = 0U;
+        };
+
+    private:
+        Entry* ref(TTF_Font* font, const char* text, int wrap);
+        void resize(Entry* entry);
+        void evict();
+        void drop(std::list<Entry>::iterator it);
+
+    private:
+        std::list<Entry> entries; // the front is the most recently used
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+        size_t budget;
+        size_t bytes = 0U;
+        uint64_t nhits = 0U;
+        uint64_t nmisses = 0U;
+    };
+
+    __lambda__ Plteen::TextLayoutCache* game_text_layouts();
+}
@@ -28,6 +28,17 @@ inline static std::string make_lmark_string(double mark, uint32_t precision, uin
 	return s;
 }
 
+static inline void draw_mark(dc_t* dc, const std::string& mark, shared_font_t font, float x, float y, float xfraction, uint32_t color) {
+	shared_texture_t label = dc->cached_blended_text(mark, font, color);
+
+	if (label->okay()) {
+		float width, height;
+
+		label->feed_extent(&width, &height);
+		dc->stamp(label->self(), x - width * xfraction, y);
+	}
+}
+
 inline static size_t mark_span(const std::string& mark) {
 	// TODO: resolve the mark language
 	return mark.size();
@@ -216,9 +227,9 @@ void Plteen::Ruler::draw_ht_hatchmark(shared_font_t font
 	
 	for (uint32_t i = 0; i <= step; i += (no_short ? 1 : skip)) {
 		std::string mark = make_mark_string(vmin + diff * double(i), precision);
-		float tx = x + metrics.hatch_x + interval * float(i) - float(font->width(mark)) * 0.5F;
+		float tx = x + metrics.hatch_x + interval * float(i);
 
-		dc->draw_blended_text(mark, font, tx, mark_ty, color);
+		draw_mark(dc, mark, font, tx, mark_ty, 0.5F, color);
 	}
 
 	SET_BOX(maybe_metrics, metrics);
@@ -239,9 +250,9 @@ void Plteen::Ruler::draw_hb_hatchmark(shared_font_t font
 
 	for (uint32_t i = 0; i <= step; i += (no_short ? 1 : skip)) {
 		std::string mark = make_mark_string(vmin + diff * double(i), precision);
-		float tx = x + metrics.hatch_x + interval * float(i) - float(font->width(mark)) * 0.5F;
-		
-		dc->draw_blended_text(mark, font, tx, mark_ty, color);
+		float tx = x + metrics.hatch_x + interval * float(i);
+
+		draw_mark(dc, mark, font, tx, mark_ty, 0.5F, color);
 	}
 
 	SET_BOX(maybe_metrics, metrics);
@@ -305,7 +316,7 @@ void Plteen::Ruler::draw_vl_hatchmark(shared_font_t font
 		float tx = x + mark_span_off * metrics.ch;
 		float ty = y + interval * float(i);
 
-		dc->draw_blended_text(mark, font, tx, ty, color);
+		draw_mark(dc, mark, font, tx, ty, 0.0F, color);
 	}
 
 	SET_BOX(maybe_metrics, metrics);
@@ -328,7 +339,7 @@ void Plteen::Ruler::draw_vr_hatchmark(shared_font_t font
 		std::string mark = make_mark_string(vmax - diff * double(i), precision);
 		float ty = y + interval * float(i);
 
-		dc->draw_blended_text(mark, font, mark_tx, ty, color);
+		draw_mark(dc, mark, font, mark_tx, ty, 0.0F, color);
 	}
 
 	SET_BOX(maybe_metrics, metrics);
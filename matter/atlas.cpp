@@ -413,6 +413,31 @@ void Plteen::GridAtlas::create_map_grid(int row, int col, float tile_width, floa
     this->invalidate_map_size();
 }
 
+const PassabilityGrid* Plteen::GridAtlas::get_passability_grid() {
+    if (!this->passability_okay || (this->passability.row_count() != this->map_row) || (this->passability.column_count() != this->map_col)) {
+        this->passability.reset(this->map_row, this->map_col, false);
+        this->passability_okay = true;
+        this->update_map_passability();
+    }
+
+    return &this->passability;
+}
+
+void Plteen::GridAtlas::update_map_tile_passability(int row, int col) {
+    // not built yet, nobody cares
+    if (this->passability_okay) {
+        this->passability.set_passable(row, col, this->is_map_tile_passable(row, col));
+    }
+}
+
+void Plteen::GridAtlas::update_map_passability() {
+    for (int r = 0; r < this->map_row; r ++) {
+        for (int c = 0; c < this->map_col; c ++) {
+            this->update_map_tile_passability(r, c);
+        }
+    }
+}
+
 int Plteen::GridAtlas::map_tile_index(int x, int y, int* r, int* c, bool local) {
     return this->map_tile_index(float(x), float(y), r, c, local);
 }
@@ -7,6 +7,7 @@
 #include "../physics/geometry/port.hpp"
 #include "../physics/geometry/aabox.hpp"
 #include "../physics/geometry/margin.hpp"
+#include "../physics/motion/passability.hpp"
 
 #include "../virtualization/filesystem/imgdb.hpp"
 
@@ -107,6 +108,10 @@ namespace Plteen {
         Plteen::Dot get_map_tile_location(int idx, const Port& a = 0.5F, bool local = true);
         Plteen::Dot get_map_tile_location(int row, int col, const Port& a = 0.5F, bool local = true);
         Plteen::Margin get_map_overlay();
+
+    public:
+        virtual bool is_map_tile_passable(int row, int col) { return true; }
+        const Plteen::PassabilityGrid* get_passability_grid(); // for `GridPathfinder`, stays at the same address
         
     public:
         void move_to_map_tile(IMatter* m, int idx, const Port& tp, const Port& p, const Vector& vec = Plteen::Vector::O);
@@ -119,6 +124,8 @@ namespace Plteen {
         
     protected:
         void create_map_grid(int row, int col, float tile_width = 0.0F, float tile_height = 0.0F, float xgap = 0.0F, float ygap = 0.0F);
+        void update_map_tile_passability(int row, int col);
+        void update_map_passability();
         
     protected:
         void on_tilemap_load(Plteen::shared_texture_t atlas) override;
@@ -144,5 +151,9 @@ namespace Plteen {
         int atlas_tile_ygap = 0;
         int atlas_tile_width = 0;
         int atlas_tile_height = 0;
+
+    private:
+        Plteen::PassabilityGrid passability;
+        bool passability_okay = false;
     };
 }
@@ -7,17 +7,44 @@
 
 using namespace Plteen;
 
+/*************************************************************************************************/
+#define PEN_PAINT 0x1U
+#define BRUSH_PAINT 0x2U
+
+static int canvas_capacity(int size) {
+    int capacity = 16;
+
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
 /*************************************************************************************************/
 void Plteen::ICanvaslet::on_resize(float w, float h, float width, float height) {
     this->invalidate_canvas();
 }
 
 void Plteen::ICanvaslet::draw(Plteen::dc_t* dc, float flx, float fly, float flwidth, float flheight) {
-    if (this->canvas.use_count() == 0) {
-        int width = fl2fxi(flwidth) + 1;
-        int height = fl2fxi(flheight) + 1;
+    int width = fl2fxi(flwidth) + 1;
+    int height = fl2fxi(flheight) + 1;
     
-        this->canvas = std::make_shared<Texture>(dc->create_blank_image(width, height));
+    if (this->canvas.use_count() > 0) {
+        // reallocate only if the texture is too small, or too large to be worth keeping
+        if ((width > this->canvas_capacity_width) || (height > this->canvas_capacity_height)
+                || (canvas_capacity(width) * 2 < this->canvas_capacity_width)
+                || (canvas_capacity(height) * 2 < this->canvas_capacity_height)) {
+            this->canvas.reset();
+        }
+    }
+
+    if (this->canvas.use_count() == 0) {
+        this->canvas_capacity_width = canvas_capacity(width);
+        this->canvas_capacity_height = canvas_capacity(height);
+        this->canvas = std::make_shared<Texture>(dc->create_blank_image(this->canvas_capacity_width, this->canvas_capacity_height));
+        this->needs_refresh_canvas = true;
+        this->needs_clear_canvas = false;
 
         if (!this->canvas->okay()) {
             fprintf(stderr, "failed to refresh the canvas of %s: %s\n", this->name(), SDL_GetError());
@@ -26,35 +53,53 @@ void Plteen::ICanvaslet::draw(Plteen::dc_t* dc, float flx, float fly, float flwi
     }
 
     if (this->canvas->okay()) {
+        SDL_Rect src = { 0, 0, width, height };
+        SDL_FRect dst = { flx, fly, flwidth, flheight };
+
         if (this->needs_refresh_canvas) {
             SDL_Texture* origin = dc->get_target();
             
             dc->set_target(this->canvas->self());
 
+            if (this->needs_clear_canvas || this->tintable) { // tintable ones are repainted as a whole
+                dc->clear(transparent);
+                this->needs_clear_canvas = false;
+            }
+
             if (!this->canvas_background_color.is_transparent()) {
                 dc->clear(this->canvas_background_color);
             }
 
+            this->tinted = this->canvas_tint(&this->tint_color, &this->tinted_paints);
             this->draw_on_canvas(dc, flwidth, flheight);
 
             dc->set_target(origin);
-            SDL_SetTextureBlendMode(this->canvas->self(), color_mixture_to_blend_mode(this->mixture));
+
+            if (!this->tinted) {
+                SDL_SetTextureColorMod(this->canvas->self(), 0xFFU, 0xFFU, 0xFFU);
+                SDL_SetTextureAlphaMod(this->canvas->self(), 0xFFU);
+            }
 
             this->needs_refresh_canvas = false;
         }
 
+        if (this->tinted) {
+            SDL_SetTextureColorMod(this->canvas->self(), this->tint_color.R(), this->tint_color.G(), this->tint_color.B());
+            SDL_SetTextureAlphaMod(this->canvas->self(), this->tint_color.A());
+        }
+
+        SDL_SetTextureBlendMode(this->canvas->self(), color_mixture_to_blend_mode(this->mixture));
+
         this->draw_before_canvas(dc, flx, fly, flwidth, flheight);
-        dc->stamp(this->canvas->self(), flx, fly, flwidth, flheight);
+        dc->stamp(this->canvas->self(), &src, &dst);
         this->draw_after_canvas(dc, flx, fly , flwidth, flheight);
     }
 }
 
 /*************************************************************************************************/
 void Plteen::ICanvaslet::invalidate_canvas() {
-    if (this->canvas.use_count() > 0) {
-        this->canvas.reset();
-    }
-
+    // the texture is kept for reusing, but its content is no longer valid
+    this->needs_clear_canvas = true;
     this->needs_refresh_canvas = true;
     this->on_canvas_invalidated();
 }
@@ -71,15 +116,69 @@ void Plteen::ICanvaslet::dirty_canvas(const RGBA& color) {
     }
 }
 
+void Plteen::ICanvaslet::enable_canvas_tinting(bool yes_or_no) {
+    if (this->tintable != yes_or_no) {
+        this->tintable = yes_or_no;
+        this->dirty_canvas();
+    }
+}
+
+void Plteen::ICanvaslet::recolor_canvas() {
+    RGBA color;
+    uint8_t paints;
+
+    if (this->tinted && (!this->needs_refresh_canvas)
+            && this->canvas_tint(&color, &paints) && (paints == this->tinted_paints)) {
+        if (this->tint_color != color) {
+            this->tint_color = color;
+            this->notify_updated();
+        }
+    } else {
+        this->dirty_canvas();
+    }
+}
+
+bool Plteen::ICanvaslet::canvas_tint(RGBA* color, uint8_t* paints) {
+    bool okay = false;
+
+    if (this->tintable && this->canvas_background_color.is_transparent()) {
+        bool pen_visible = !this->pen_color.is_transparent();
+        bool brush_visible = !this->brush_color.is_transparent();
+
+        if (pen_visible && brush_visible) {
+            okay = (this->pen_color == this->brush_color);
+        } else {
+            okay = (pen_visible || brush_visible);
+        }
+
+        if (okay) {
+            SET_BOX(color, (pen_visible ? this->pen_color : this->brush_color));
+            SET_BOX(paints, (pen_visible ? PEN_PAINT : 0U) | (brush_visible ? BRUSH_PAINT : 0U));
+        }
+    }
+
+    return okay;
+}
+
 /*************************************************************************************************/
 bool Plteen::ICanvaslet::brush_okay(uint8_t* r, uint8_t* g, uint8_t* b, uint8_t* a) {
-    this->brush_color.unbox(r, g, b, a);
+    if (this->tinted) {
+        SET_TRIPLETS(r, 0xFFU, g, 0xFFU, b, 0xFFU);
+        SET_BOX(a, 0xFFU);
+    } else {
+        this->brush_color.unbox(r, g, b, a);
+    }
 
     return !this->brush_color.is_transparent();
 }
 
 bool Plteen::ICanvaslet::pen_okay(uint8_t* r, uint8_t* g, uint8_t* b, uint8_t* a) {
-    this->pen_color.unbox(r, g, b, a);
+    if (this->tinted) {
+        SET_TRIPLETS(r, 0xFFU, g, 0xFFU, b, 0xFFU);
+        SET_BOX(a, 0xFFU);
+    } else {
+        this->pen_color.unbox(r, g, b, a);
+    }
     
     return !this->pen_color.is_transparent();
 }
@@ -87,41 +186,41 @@ bool Plteen::ICanvaslet::pen_okay(uint8_t* r, uint8_t* g, uint8_t* b, uint8_t* a
 void Plteen::ICanvaslet::set_color_mixture(ColorMixture mixture) {
     if (this->mixture != mixture) {
         this->mixture = mixture;
-        this->dirty_canvas();
+        this->notify_updated(); // only the blend mode of the texture
     }
 }
 
 void Plteen::ICanvaslet::set_canvas_alpha(double alpha) {
     if (this->canvas_background_color.alpha() != alpha) {
         this->canvas_background_color = RGBA(this->canvas_background_color, alpha);
-        this->dirty_canvas();
+        this->recolor_canvas();
     }
 }
 
 void Plteen::ICanvaslet::set_pen_color(const RGBA& c) {
     if (this->pen_color != c) {
         this->pen_color = c;
-        this->dirty_canvas();
+        this->recolor_canvas();
     }
 }
 
 void Plteen::ICanvaslet::set_pen_alpha(double alpha) {
     if (this->pen_color.alpha() != alpha) {
         this->pen_color = RGBA(this->pen_color, alpha);
-        this->dirty_canvas();
+        this->recolor_canvas();
     }
 }
 
 void Plteen::ICanvaslet::set_brush_color(const RGBA& c) {
     if (this->brush_color != c) {
         this->brush_color = c;
-        this->dirty_canvas();
+        this->recolor_canvas();
     }
 }
 
 void Plteen::ICanvaslet::set_brush_alpha(double alpha) {
     if (this->brush_color.alpha() != alpha) {
         this->brush_color = RGBA(this->brush_color, alpha);
-        this->dirty_canvas();
+        this->recolor_canvas();
     }
 }
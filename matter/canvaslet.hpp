@@ -47,13 +47,35 @@ namespace Plteen {
 		virtual void invalidate_canvas();
 		virtual void on_canvas_invalidated() {}
 
-    protected:
+	protected:
+		/**
+		 * For canvases painted with only the pen and the brush in `draw_on_canvas`,
+		 *   if the visible paints share the same color over a transparent background,
+		 *   the canvas is rasterized as a white mask and colored by the texture color/alpha mod,
+		 *   so that changing the color or alpha doesn't re-rasterize.
+		 */
+		void enable_canvas_tinting(bool yes_or_no);
+
+    protected: // the texture might be larger than the graphlet, only the top-left part is used
 		shared_texture_t canvas = nullptr;
 
+	private:
+		void recolor_canvas();
+		bool canvas_tint(Plteen::RGBA* color, uint8_t* paints);
+
 	private:
         bool needs_refresh_canvas = true;
+		bool needs_clear_canvas = false;
+		int canvas_capacity_width = 0;
+		int canvas_capacity_height = 0;
 		Plteen::RGBA canvas_background_color;
 
+	private:
+		bool tintable = false;
+		bool tinted = false;
+		uint8_t tinted_paints = 0U;
+		Plteen::RGBA tint_color;
+
 	private:
 		Plteen::ColorMixture mixture = ColorMixture::Alpha;
 		Plteen::RGBA brush_color;
@@ -5,13 +5,26 @@
 #include "../datum/enum.hpp"
 #include "../datum/flonum.hpp"
 
+#include <vector>
+#include <limits>
+#include <type_traits>
+
 namespace Plteen {
     class __lambda__ IGraphlet : public Plteen::IMatter {
 		// Yes, meanwhile it's empty
     };
 
+	template<typename T> class ValueBindingRegistry;
+
     template<typename T>
 	class __lambda__ IValuelet : public virtual Plteen::IGraphlet {
+	public:
+		virtual ~IValuelet() noexcept {
+			if (this->registry != nullptr) {
+				this->registry->detach(this);
+			}
+		}
+
     public:
 		T get_value() {
 			return this->guarded_value();
@@ -27,6 +40,7 @@ namespace Plteen {
 
 		void bind_value(T& address) {
 			this->value = &address;
+			this->notify_binding_changed();
 		}
 		
 		void bind_value(T* address) {
@@ -35,6 +49,8 @@ namespace Plteen {
 			} else {
 				this->value = &this->shadow;
 			}
+
+			this->notify_binding_changed();
 		}
 
 		void set_value_port(Plteen::MatterPort port) {
@@ -47,7 +63,11 @@ namespace Plteen {
 
 	public:
 		int update(uint64_t count, uint32_t interval, uint64_t uptime) override {
-			this->update_value_now();
+			// otherwise, the registry polls on behalf of this matter
+			if (this->registry == nullptr) {
+				this->update_value_now();
+			}
+
 			return 0;
 		}
 		
@@ -55,17 +75,70 @@ namespace Plteen {
 		virtual void on_value_changed(Plteen::dc_t* renderer, T value) {}
 		virtual T guarded_value() { return *(this->value); }
 
+	protected:
+		/**
+		 * Changes smaller than the quantum are invisible and therefore ignored,
+		 *   say, 0.01 for numbers displayed with 2 decimal places.
+		 * `T()` means that any change counts.
+		 */
+		virtual T display_quantum() { return T(); }
+
+		/**
+		 * The exact check for values that the quantum cannot tell apart,
+		 *   say, those printed with the same digits.
+		 */
+		virtual bool displays_differently(T prev, T cur) { return true; }
+
+		void notify_binding_changed() {
+			if (this->registry != nullptr) {
+				this->registry->rebind(this);
+			}
+		}
+
 	private:
+		friend class Plteen::ValueBindingRegistry<T>;
+
+		/**
+		 * Conservative, only values that are surely printed the same are told apart.
+		 * Values rounded to the same multiple of the quantum are printed the same,
+		 *   unless either of them is close to a rounding boundary, at which the printed
+		 *   digits depend on the exact binary values and the division is not exact.
+		 */
+		static bool visibly_differs(T prev, T cur, T quantum) {
+			if constexpr (std::is_floating_point_v<T>) {
+				if (quantum > T()) {
+					T a = prev / quantum + T(0.5);
+					T b = cur / quantum + T(0.5);
+					T cell = flfloor(a);
+
+					if (flfloor(b) == cell) {
+						T margin = flmax(flabs(a), T(1)) * std::numeric_limits<T>::epsilon() * T(1024);
+
+						if ((flmin(a, b) - cell > margin) && (cell + T(1) - flmax(a, b) > margin)) {
+							return false;
+						}
+					}
+				}
+			}
+
+			return prev != cur;
+		}
+
 		void update_value_now() {
 			T cur_value = this->guarded_value();
 
-			if (last_value != cur_value) {
-				Plteen::dc_t* dc = this->drawing_context();
+			if (visibly_differs(last_value, cur_value, this->display_quantum())) {
+				if (this->displays_differently(last_value, cur_value)) {
+					Plteen::dc_t* dc = this->drawing_context();
 
-				last_value = cur_value;
-				this->moor(this->port);
-				if (dc != nullptr) this->on_value_changed(dc, cur_value);
-				this->notify_updated();
+					last_value = cur_value;
+					this->moor(this->port);
+					if (dc != nullptr) this->on_value_changed(dc, cur_value);
+					this->notify_updated();
+				} else {
+					// printed the same, so that the current value is as good as the last one
+					last_value = cur_value;
+				}
 			}
 		}
 
@@ -76,6 +149,97 @@ namespace Plteen {
 	private:
 		T last_value = T();
 		T* value = &this->shadow;
+
+	private:
+		Plteen::ValueBindingRegistry<T>* registry = nullptr;
+		size_t binding_slot = 0U;
+	};
+
+	/**
+	 * Polls the bound values of many valuelets in one contiguous pass,
+	 *   and then updates those visibly changed in a batch.
+	 *
+	 * Attached valuelets stop polling in their own `update`,
+	 *   the owner of the registry should `refresh` it once per frame instead.
+	 *
+	 * NOTE: valuelets overriding `guarded_value()`, say, rangelets, must not be attached,
+	 *   the scan reads the bound values directly, and would miss the changes made by the hook.
+	 */
+	template<typename T>
+	class __lambda__ ValueBindingRegistry {
+	public:
+		~ValueBindingRegistry() noexcept {
+			for (auto& slot : this->slots) {
+				slot.owner->registry = nullptr;
+			}
+		}
+
+	public:
+		void attach(Plteen::IValuelet<T>* valuelet) {
+			if (valuelet->registry != this) {
+				if (valuelet->registry != nullptr) {
+					valuelet->registry->detach(valuelet);
+				}
+
+				valuelet->registry = this;
+				valuelet->binding_slot = this->slots.size();
+				this->slots.push_back({ valuelet->value, valuelet->display_quantum(), valuelet });
+			}
+		}
+
+		void detach(Plteen::IValuelet<T>* valuelet) {
+			if (valuelet->registry == this) {
+				size_t idx = valuelet->binding_slot;
+
+				this->slots[idx] = this->slots.back();
+				this->slots[idx].owner->binding_slot = idx;
+				this->slots.pop_back();
+				valuelet->registry = nullptr;
+			}
+		}
+
+		void rebind(Plteen::IValuelet<T>* valuelet) {
+			if (valuelet->registry == this) {
+				Slot& slot = this->slots[valuelet->binding_slot];
+
+				slot.address = valuelet->value;
+				slot.quantum = valuelet->display_quantum();
+			}
+		}
+
+		size_t size() { return this->slots.size(); }
+
+	public:
+		size_t refresh() {
+			this->changed.clear();
+
+			/**
+			 * The scan reads plain memory only, no virtual calls,
+			 *   values are compared with what the valuelets show, however they were updated.
+			 */
+			for (auto& slot : this->slots) {
+				if (IValuelet<T>::visibly_differs(slot.owner->last_value, *slot.address, slot.quantum)) {
+					this->changed.push_back(slot.owner);
+				}
+			}
+
+			for (auto valuelet : this->changed) {
+				valuelet->update_value_now();
+			}
+
+			return this->changed.size();
+		}
+
+	private:
+		struct Slot {
+			const T* address;
+			T quantum;
+			Plteen::IValuelet<T>* owner;
+		};
+
+	private:
+		std::vector<Slot> slots;
+		std::vector<Plteen::IValuelet<T>*> changed;
 	};
 
     template<typename T>
@@ -1,14 +1,18 @@
 #include "chromalet.hpp"
 
 #include "../../datum/box.hpp"
+#include "../../datum/fixnum.hpp"
 #include "../../datum/flonum.hpp"
 
 #include "../../graphics/image.hpp"
 #include "../../physics/color/rgba.hpp"
 #include "../../physics/color/names.hpp"
+#include "../../physics/color/batch.hpp"
 
 #include "../../physics/mathematics.hpp"
 
+#include <thread>
+
 using namespace Plteen;
 
 /*************************************************************************************************/
@@ -21,6 +25,10 @@ static const double blue_wavelength = 435.8;
 
 static const double start_wavelength = 380.0;
 
+static const size_t chromaticity_map_cache_size = 4U;
+static const int chromaticity_map_columns_per_thread = 64;
+static const unsigned int chromaticity_map_max_threads = 8U;
+
 static const double wavelength_xbars [] = {
     0.001435025, 0.0015721889999999999, 0.0017223550000000044, 0.0018990695000000056, 0.0021158785, 0.0023856924999999998,
     0.002713994, 0.0030967160000000002, 0.0035270325, 0.003998118, 0.0045026944999999995, 0.005046218499999984,
@@ -460,27 +468,148 @@ void Plteen::Chromalet::draw_spectral_locus(Plteen::dc_t* dc, double flwidth, do
 }
 
 void Plteen::Chromalet::draw_chromaticity(Plteen::dc_t* dc, double flwidth, double flheight, double dx, double dy) {
-    int slt_idx = this->scanline_idx0;
-    int slb_idx = this->scanline_idx0;
-    double X, Y, Z, R, G, B;
-    double fx, fy, ty, by;
-    
+    const ChromaticityMap& map = this->chromaticity_map(flwidth, flheight);
+
+    if (this->uploaded_map != &map) {
+        int tex_width = 0;
+        int tex_height = 0;
+
+        if (this->chromaticity.use_count() > 0) {
+            this->chromaticity->feed_extent(&tex_width, &tex_height);
+        }
+
+        if ((tex_width != map.width) || (tex_height != map.height)) {
+            this->chromaticity = std::make_shared<Texture>(SDL_CreateTexture(dc->self(),
+                                    SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC,
+                                    map.width, map.height));
+
+            if (this->chromaticity->okay()) {
+                SDL_SetTextureBlendMode(this->chromaticity->self(), SDL_BLENDMODE_BLEND);
+            }
+        }
+
+        if (this->chromaticity->okay()) {
+            SDL_UpdateTexture(this->chromaticity->self(), nullptr, map.pixels.data(), map.width * int(sizeof(uint32_t)));
+            this->uploaded_map = &map;
+        } else {
+            fprintf(stderr, "无法绘制色度图：%s\n", SDL_GetError());
+        }
+    }
+
+    if (this->uploaded_map == &map) {
+        dc->stamp(this->chromaticity->self(), float(dx), float(dy));
+    }
+}
+
+const Plteen::Chromalet::ChromaticityMap& Plteen::Chromalet::chromaticity_map(double flwidth, double flheight) {
+    int width = fl2fxi(flwidth) + 1;
+    int height = fl2fxi(flheight) + 1;
+    bool xflip = (this->width < 0.0F);
+    bool yflip = (this->height > 0.0F);
+
+    for (auto it = this->chromaticity_maps.begin(); it != this->chromaticity_maps.end(); it ++) {
+        if ((it->standard == this->standard) && (it->width == width) && (it->height == height)
+                && (it->xflip == xflip) && (it->yflip == yflip)) {
+            this->chromaticity_maps.splice(this->chromaticity_maps.begin(), this->chromaticity_maps, it);
+            return this->chromaticity_maps.front();
+        }
+    }
+
+    if (this->chromaticity_maps.size() >= chromaticity_map_cache_size) {
+        if (this->uploaded_map == &this->chromaticity_maps.back()) {
+            this->uploaded_map = nullptr;
+        }
+
+        this->chromaticity_maps.pop_back();
+    }
+
+    this->chromaticity_maps.push_front({ this->standard, width, height, xflip, yflip,
+                                         std::vector<uint32_t>(size_t(width) * size_t(height), 0U) });
+
+    ChromaticityMap* map = &this->chromaticity_maps.front();
+
     if (this->locus_xs == nullptr) {
         this->make_locus_polygon(flwidth, flheight);
-        slt_idx = slb_idx = this->scanline_idx0;
     }
 
-    for (double x = flround(this->scanline_start); x <= this->scanline_end; x += 1.0) {
+    if (this->scanline_end >= flround(this->scanline_start)) {
+        int columns = fl2fxi(flfloor(this->scanline_end - flround(this->scanline_start))) + 1;
+        unsigned int nthreads = std::thread::hardware_concurrency();
+
+        nthreads = fxmin(nthreads, chromaticity_map_max_threads);
+        nthreads = fxmin(nthreads, (unsigned int)(columns / chromaticity_map_columns_per_thread));
+
+        if (nthreads > 1U) {
+            std::vector<std::thread> workers;
+            int band = (columns + int(nthreads) - 1) / int(nthreads);
+
+            // bands of columns write disjoint pixels, and the locus is read only
+            for (int col0 = 0; col0 < columns; col0 += band) {
+                workers.emplace_back(&Chromalet::fill_chromaticity_columns, this, map, flwidth, flheight, col0, fxmin(col0 + band, columns));
+            }
+
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        } else {
+            this->fill_chromaticity_columns(map, flwidth, flheight, 0, columns);
+        }
+    }
+
+    return *map;
+}
+
+void Plteen::Chromalet::fill_chromaticity_columns(ChromaticityMap* map, double flwidth, double flheight, int col0, int col1) {
+    int slt_idx = this->scanline_idx0;
+    int slb_idx = this->scanline_idx0;
+    double x0 = flround(this->scanline_start);
+    std::vector<float> xs, ys, Xs, Ys, Zs;
+    bool xflip = (this->width < 0.0F);
+    bool yflip = (this->height > 0.0F);
+    double fx, ty, by;
+
+    for (int col = col0; col < col1; col ++) {
+        double x = x0 + double(col);
+        double y0;
+        size_t n;
+        
         fx = x / flwidth;
         this->spectrum_intersection_vpoints(x, flheight, slt_idx, slb_idx, &ty, &by);
 
-        for (double y = flfloor(ty); y <= flceiling(by); y += 1.0) {
-            fy = 1.0 - y / flheight;        
-            CIE_xyY_to_XYZ(fx, fy, &X, &Y, &Z, this->luminance);
-            CIE_XYZ_to_RGB(this->standard, X, Y, Z, &R, &G, &B, true);
-            this->render_dot(dc, fx, fy, flwidth, flheight, R, G, B, dx, dy);
+        y0 = flfloor(ty);
+        n = (flceiling(by) >= y0) ? size_t(flceiling(by) - y0) + 1U : 0U;
+        xs.assign(n, float(fx));
+        ys.resize(n);
+        Xs.resize(n);
+        Ys.resize(n);
+        Zs.resize(n);
+
+        for (size_t idx = 0; idx < n; idx ++) {
+            ys[idx] = float(1.0 - (y0 + double(idx)) / flheight);
+        }
+
+        // the whole column goes through the batch conversions, and then in place as RGB
+        CIE_xyY_to_XYZ_batch(xs.data(), ys.data(), Xs.data(), Ys.data(), Zs.data(), n, float(this->luminance));
+        CIE_XYZ_to_RGB_batch(this->standard, Xs.data(), Ys.data(), Zs.data(), Xs.data(), Ys.data(), Zs.data(), n, true);
+
+        for (size_t idx = 0; idx < n; idx ++) {
+            /**
+             * The same position as `render_dot` draws, but derived from the integral column and row,
+             *   dividing by the extent and then multiplying back may land on the neighbor,
+             *   which would leave transparent stripes, and make bands of columns overlap.
+             */
+            double y = y0 + double(idx);
+            int px = fl2fxi(xflip ? flfloor(flwidth - x) : x);
+            int py = fl2fxi(yflip ? y : flfloor(flheight - y));
+
+            if ((px >= 0) && (px < map->width) && (py >= 0) && (py < map->height)) {
+                RGBA c(double(Xs[idx]), double(Ys[idx]), double(Zs[idx]));
+
+                map->pixels[size_t(py) * size_t(map->width) + size_t(px)]
+                    = (uint32_t(c.R()) << 24U) | (uint32_t(c.G()) << 16U) | (uint32_t(c.B()) << 8U) | uint32_t(c.A());
+            }
         }
-    };
+    }
 }
 
 /*************************************************************************************************/
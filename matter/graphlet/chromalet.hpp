@@ -5,6 +5,9 @@
 #include "../../physics/algebra/point.hpp"
 #include "../../physics/geometry/aabox.hpp"
 
+#include <list>
+#include <vector>
+
 namespace Plteen {
     class __lambda__ Chromalet : public Plteen::ICanvaslet {
     public:
@@ -55,6 +58,19 @@ namespace Plteen {
         void render_dot(Plteen::dc_t* dc, double x, double y, double width, double height,
                             double R, double G, double B, double dx, double dy, double A = 1.0);
 
+    private:
+        struct ChromaticityMap {
+            Plteen::CIE_Standard standard;
+            int width;
+            int height;
+            bool xflip;
+            bool yflip;
+            std::vector<uint32_t> pixels; // RGBA8888
+        };
+
+        const ChromaticityMap& chromaticity_map(double width, double height);
+        void fill_chromaticity_columns(ChromaticityMap* map, double width, double height, int col0, int col1);
+
     private:
         void invalidate_locus();
 
@@ -75,5 +91,10 @@ namespace Plteen {
         double scanline_start = 0.0;
         double scanline_end = 0.0;
         int scanline_idx0 = 0U;
+
+    private: // the luminance cancels out in the normalized RGB, so it is not a part of the key
+        std::list<ChromaticityMap> chromaticity_maps; // the front is the most recently used
+        Plteen::shared_texture_t chromaticity = nullptr;
+        const ChromaticityMap* uploaded_map = nullptr;
     };
 }
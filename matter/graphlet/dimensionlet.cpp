@@ -201,29 +201,42 @@ void Plteen::Dimensionlet::prepare_style(DimensionState status, DimensionStyle&
 
 void Plteen::Dimensionlet::apply_style(DimensionStyle& style, Plteen::dc_t* dc) {
     if (!this->label.empty()) {
-        this->textures[label_idx].reset(
-            new Texture(dc->create_blended_text(this->label, style.label_font, style.label_color.value(), 0)));
+        this->textures[label_idx] = dc->cached_blended_text(this->label, style.label_font, style.label_color.value());
     }
 
     this->update_number_texture(dc, this->get_value(), style);
 
     if (!this->unit.empty()) {
-        this->textures[unit_idx].reset(
-            new Texture(dc->create_blended_text(this->unit, style.unit_font, style.unit_color.value(), 0)));
+        this->textures[unit_idx] = dc->cached_blended_text(this->unit, style.unit_font, style.unit_color.value());
     }
 	
     this->update_drawing_box(label_idx, style.minimize_label_width, style.label_font, 0.0F);
     this->update_drawing_box(datum_idx, style.minimize_number_width, style.number_font, style.number_leading_space);
     this->update_drawing_box( unit_idx, -1.0F, style.unit_font, style.unit_leading_space);
+
+    // the precision might be changed
+    this->notify_binding_changed();
 }
 
 void Plteen::Dimensionlet::on_value_changed(dc_t* dc, double value) {
 	this->update_number_texture(dc, value, this->get_style());
 }
 
+double Plteen::Dimensionlet::display_quantum() {
+    int precision = this->get_style().precision;
+
+    // `flstring` prints 6 decimal places for negative precisions
+    return flexpt(10.0, -double((precision >= 0) ? precision : 6));
+}
+
+bool Plteen::Dimensionlet::displays_differently(double prev, double cur) {
+    int precision = this->get_style().precision;
+
+    return flstring(prev, precision) != flstring(cur, precision);
+}
+
 void Plteen::Dimensionlet::update_number_texture(Plteen::dc_t* dc, double value, DimensionStyle& style) {
-    this->textures[datum_idx].reset(
-        new Texture(dc->create_blended_text(flstring(value, style.precision), style.number_font, style.number_color.value(), 0)));
+    this->textures[datum_idx] = dc->cached_blended_text(flstring(value, style.precision), style.number_font, style.number_color.value());
 }
 
 void Plteen::Dimensionlet::update_drawing_box(size_t idx, float min_width, shared_font_t font, float leading_space) {
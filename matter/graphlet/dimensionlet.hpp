@@ -87,6 +87,8 @@ namespace Plteen {
 
     protected:
         void on_value_changed(Plteen::dc_t* dc, double value) override;
+        double display_quantum() override;
+        bool displays_differently(double prev, double cur) override;
 
     private:
         void feed_subextent(size_t n, float* w = nullptr, float* h = nullptr);
@@ -12,8 +12,6 @@ Plteen::Histogramlet::Histogramlet(float width, float height, uint32_t box_hex,
         this->height = this->width;
     }
 
-    this->capacity = 0;
-    this->clear();
     this->enable_resize(true);
 }
 
@@ -24,69 +22,18 @@ Box Plteen::Histogramlet::get_bounding_box() {
 void Plteen::Histogramlet::on_resize(float w, float h, float width, float height) {
     this->width = flabs(w);
     this->height = flabs(h);
-    this->invalidate_geometry();
+    this->trace.reset();
 }
 
 void Plteen::Histogramlet::draw(Plteen::dc_t* dc, float flx, float fly, float flwidth, float flheight) {
-    if (this->diagram.use_count() == 0) {
-        this->diagram = std::make_shared<Texture>(dc->create_blank_image(fl2fxi(this->width) + 1, fl2fxi(this->height) + 1));
-    }
-
-    if (this->diagram->okay()) {
-        if (this->needs_refresh_diagram) {
-            SDL_Texture* origin = dc->get_target();
-            size_t n = this->raw_dots.size();
-            float xrange = flmax(this->xmax - this->xmin, flwidth);
-            float yrange = flmax(this->ymax - this->ymin, flheight);
-
-            if (n > 1) {
-                float xratio = flwidth / xrange;
-                float yratio = flheight / yrange;
-                std::vector<SDL_FPoint> dots(n);
-
-                for (size_t idx = 0; idx < n; idx ++) {
-                    float X = this->raw_dots[idx].first;
-                    float Y = this->raw_dots[idx].second;
-                    
-                    dots[idx] = { (X - this->xmin) * xratio, flheight - (Y - this->ymin) * yratio };
-                }
-
-                dc->set_target(this->diagram->self());
-
-                dc->clear(transparent);
-                dc->draw_lines(dots.data(), int(n), RGBA(this->color, this->alpha));
-                dc->set_target(origin);
-            }
-
-            this->needs_refresh_diagram = false;
-        }
-
-        dc->stamp(this->diagram->self(), flx, fly, flwidth, flheight);
-    } else {
-        fprintf(stderr, "无法绘制历史曲线：%s\n", SDL_GetError());
-    }
+    this->trace.render(dc, this->series, flwidth, flheight, RGBA(this->color, this->alpha));
+    this->trace.stamp(dc, flx, fly, flwidth, flheight);
 }
 
 /*************************************************************************************************/
-void Plteen::Histogramlet::invalidate_geometry() {
-    if (this->diagram.use_count() > 0) {
-        this->diagram.reset();
-        this->clear_geometry();
-    }
-}
-
-void Plteen::Histogramlet::clear_geometry() {
-    this->needs_refresh_diagram = true;
-}
-
 void Plteen::Histogramlet::clear() {
-    this->xmax = this->ymax = -infinity;
-    this->xmin = this->ymin = +infinity;
-
-    if (!this->raw_dots.empty()) {
-        this->raw_dots.clear();
-        this->clear_geometry();
-        
+    if (!this->series.empty()) {
+        this->series.clear();
         this->notify_updated();
     }
 }
@@ -95,42 +42,22 @@ void Plteen::Histogramlet::set_color(uint32_t hex, double alpha) {
     if ((this->color != hex) || (this->alpha != alpha)) {
         this->color = hex;
         this->alpha = alpha;
-        this->clear_geometry();
+        this->trace.invalidate();
         this->notify_updated();
     }
 }
 
 void Plteen::Histogramlet::set_capacity(size_t n) {
-    if (this->capacity != n) {
-        this->capacity = n;
-
-        if (this->capacity < this->raw_dots.size()) {
-            this->raw_dots.erase(this->raw_dots.begin(), this->raw_dots.end() - this->capacity);
-        }
-
-        this->clear_geometry();
+    if (this->series.capacity() != n) {
+        this->series.set_capacity(n);
+        this->trace.invalidate();
         this->notify_updated();
     }
 }
 
 void Plteen::Histogramlet::push_back_datum(float x, float y) {
-    if (this->raw_dots.empty() || (this->raw_dots.back().first != x)) {
-        this->raw_dots.push_back({ x , y });
-
-        if (this->capacity > 1) {
-            // Yes, the ranges are not affected
-            if (this->raw_dots.size() > this->capacity) {
-                this->raw_dots.erase(this->raw_dots.begin());
-            }
-        }
-        
-        // don't merge with `else if`
-        if (x < this->xmin) this->xmin = x;
-        if (x > this->xmax) this->xmax = x;
-        if (y < this->ymin) this->ymin = y;
-        if (y > this->ymax) this->ymax = y;
-
-        this->clear_geometry();
+    if (this->series.empty() || (this->series.back().first != x)) {
+        this->series.push_back(x, y);
         this->notify_updated();
     }
 }
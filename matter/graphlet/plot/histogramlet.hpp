@@ -1,17 +1,16 @@
 #pragma once
 
+#include "series.hpp"
+
 #include "../../graphlet.hpp"
-#include "../../../graphics/texture.hpp"
 #include "../../../physics/geometry/aabox.hpp"
 
-#include <vector>
-
 namespace Plteen {
     class __lambda__ Histogramlet : public Plteen::IGraphlet {
     public:
         Histogramlet(float size, uint32_t box_hex, uint32_t mark_hex) : Histogramlet(size, size, box_hex, mark_hex) {}
         Histogramlet(float width, float height, uint32_t box_hex, uint32_t mark_hex);
-        virtual ~Histogramlet() { this->invalidate_geometry(); }
+        virtual ~Histogramlet() {}
 
     public:
         Plteen::Box get_bounding_box() override;
@@ -27,18 +26,8 @@ namespace Plteen {
         void on_resize(float new_width, float new_height, float old_width, float old_height) override;
 
     private:
-        void clear_geometry();
-        void invalidate_geometry();
-
-    private:
-        shared_texture_t diagram = nullptr;
-        std::vector<std::pair<float, float>> raw_dots;
-        size_t capacity;
-        bool needs_refresh_diagram;
-        float xmin;
-        float xmax;
-        float ymin;
-        float ymax;
+        Plteen::PlotSeries series;
+        Plteen::PlotTrace trace;
 
     private:
         float width;
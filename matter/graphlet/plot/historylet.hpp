@@ -1,10 +1,10 @@
 #pragma once
 
+#include "series.hpp"
+
 #include "../../canvaslet.hpp"
 #include "../../../physics/geometry/aabox.hpp"
 
-#include <vector>
-
 namespace Plteen {
     class __lambda__ Historylet : public Plteen::ICanvaslet {
     public:
@@ -21,17 +21,14 @@ namespace Plteen {
 
     protected:
         void draw_on_canvas(Plteen::dc_t* dc, float Width, float Height) override;
+        void draw_after_canvas(Plteen::dc_t* dc, float x, float y, float Width, float Height) override;
         
     protected:
         void on_resize(float new_width, float new_height, float old_width, float old_height) override;
 
     private:
-        std::vector<std::pair<float, float>> raw_dots;
-        size_t capacity;
-        float xmin;
-        float xmax;
-        float ymin;
-        float ymax;
+        Plteen::PlotSeries series;
+        Plteen::PlotTrace trace;
 
     private:
         float width;
@@ -272,7 +272,7 @@ void Plteen::Radarlet::draw_variable(dc_t* dc, double percentage, float x, float
                             ? "0" : ((this->variable_range == 0.0)
                                         ? make_nstring("%.0lf%%", flround(100.0 * percentage))
                                         : make_nstring("%.1lf", this->variable_range * percentage));
-    shared_texture_t label = std::make_shared<Texture>(dc->create_blended_text(value, font, color));
+    shared_texture_t label = dc->cached_blended_text(value, font, color);
     float width, height;
 
     label->feed_extent(&width, &height);
@@ -0,0 +1,465 @@
+#include "series.hpp"
+
+#include "../../../datum/box.hpp"
+#include "../../../datum/flonum.hpp"
+
+using namespace Plteen;
+
+/*************************************************************************************************/
+static const size_t plot_series_pyramid_floor = 3U;
+static const float plot_trace_rebase_threshold = 1048576.0F;
+static const float plot_trace_xrange_tolerance = 0.25F;
+static const float plot_trace_decimation_density = 4.0F; // M4 emits at most 4 points per column
+
+template<typename Cmp>
+static inline void series_push_extreme(std::deque<std::pair<uint64_t, float>>& q, uint64_t seq, float v, Cmp dominates) {
+    while (!q.empty() && !dominates(q.back().second, v)) {
+        q.pop_back();
+    }
+
+    q.push_back({ seq, v });
+}
+
+static inline void series_evict_extreme(std::deque<std::pair<uint64_t, float>>& q, uint64_t first) {
+    while (!q.empty() && (q.front().first < first)) {
+        q.pop_front();
+    }
+}
+
+static inline bool series_lt(float a, float b) { return a < b; }
+static inline bool series_gt(float a, float b) { return a > b; }
+
+/*************************************************************************************************/
+const std::pair<float, float>& Plteen::PlotSeries::operator[](size_t idx) const {
+    if (this->limit > 0U) {
+        idx += this->head;
+
+        if (idx >= this->limit) {
+            idx -= this->limit;
+        }
+    }
+
+    return this->dots[idx];
+}
+
+float Plteen::PlotSeries::xmin() const { return this->xmins.empty() ? infinity_f : this->xmins.front().second; }
+float Plteen::PlotSeries::xmax() const { return this->xmaxs.empty() ? -infinity_f : this->xmaxs.front().second; }
+float Plteen::PlotSeries::ymin() const { return this->ymins.empty() ? infinity_f : this->ymins.front().second; }
+float Plteen::PlotSeries::ymax() const { return this->ymaxs.empty() ? -infinity_f : this->ymaxs.front().second; }
+
+bool Plteen::PlotSeries::monotonic() const {
+    // a descent at the sample `k` breaks the order only if the sample `k - 1` is still in the window
+    return this->descents <= this->total - this->count + 1U;
+}
+
+void Plteen::PlotSeries::push_back(float x, float y) {
+    uint64_t i = this->total;
+
+    if ((this->count > 0U) && (x < this->back().first)) {
+        this->descents = this->total + 1U;
+    }
+
+    if ((this->limit > 0U) && (this->count == this->limit)) {
+        this->dots[this->head] = { x, y };
+
+        if (++ this->head == this->limit) {
+            this->head = 0U;
+        }
+    } else {
+        this->dots.push_back({ x, y });
+        this->count ++;
+    }
+
+    this->total ++;
+    this->track_extremes(x, y);
+
+    if (this->expected_levels() != this->pyramid.size()) {
+        this->rebuild_pyramid();
+    } else {
+        this->summarize(i, y);
+    }
+}
+
+void Plteen::PlotSeries::set_capacity(size_t n) {
+    if (this->limit != n) {
+        size_t keep = ((n > 0U) && (n < this->count)) ? n : this->count;
+        std::vector<std::pair<float, float>> window;
+
+        window.reserve((n > 0U) ? n : keep);
+        for (size_t idx = this->count - keep; idx < this->count; idx ++) {
+            window.push_back((*this)[idx]);
+        }
+
+        this->dots.swap(window);
+        this->limit = n;
+        this->head = 0U;
+        this->count = keep;
+        this->rebuild_extremes();
+        this->rebuild_pyramid();
+    }
+}
+
+void Plteen::PlotSeries::clear() {
+    this->dots.clear();
+    this->head = 0U;
+    this->count = 0U;
+    this->rebuild_extremes();
+    this->rebuild_pyramid();
+}
+
+void Plteen::PlotSeries::rebuild_extremes() {
+    uint64_t seq = this->total - this->count;
+
+    this->xmins.clear();
+    this->xmaxs.clear();
+    this->ymins.clear();
+    this->ymaxs.clear();
+
+    for (size_t idx = 0U; idx < this->count; idx ++) {
+        const std::pair<float, float>& dot = (*this)[idx];
+
+        seq ++;
+        series_push_extreme(this->xmins, seq, dot.first, series_lt);
+        series_push_extreme(this->xmaxs, seq, dot.first, series_gt);
+        series_push_extreme(this->ymins, seq, dot.second, series_lt);
+        series_push_extreme(this->ymaxs, seq, dot.second, series_gt);
+    }
+}
+
+void Plteen::PlotSeries::track_extremes(float x, float y) {
+    uint64_t first = this->total - this->count + 1U;
+
+    series_push_extreme(this->xmins, this->total, x, series_lt);
+    series_push_extreme(this->xmaxs, this->total, x, series_gt);
+    series_push_extreme(this->ymins, this->total, y, series_lt);
+    series_push_extreme(this->ymaxs, this->total, y, series_gt);
+
+    if (this->limit > 0U) {
+        series_evict_extreme(this->xmins, first);
+        series_evict_extreme(this->xmaxs, first);
+        series_evict_extreme(this->ymins, first);
+        series_evict_extreme(this->ymaxs, first);
+    }
+}
+
+size_t Plteen::PlotSeries::lower_bound(float x, size_t first, size_t last) const {
+    while (first < last) {
+        size_t mid = first + (last - first) / 2U;
+
+        if ((*this)[mid].first < x) {
+            first = mid + 1U;
+        } else {
+            last = mid;
+        }
+    }
+
+    return first;
+}
+
+void Plteen::PlotSeries::range_extremes(size_t first, size_t last, float* ymin, float* ymax) const {
+    uint64_t origin = this->total - this->count;
+    uint64_t i = origin + first;
+    uint64_t end = origin + last;
+    float lo = infinity_f;
+    float hi = -infinity_f;
+
+    while (i < end) {
+        size_t level = this->pyramid.size();
+
+        // the largest block that starts at `i` and stays in the range
+        while (level > 0U) {
+            uint64_t span = uint64_t(1U) << (plot_series_pyramid_floor + level - 1U);
+
+            if (((i & (span - 1U)) == 0U) && (i + span <= end)) {
+                const Summary& block = this->summary(level - 1U, i >> (plot_series_pyramid_floor + level - 1U));
+
+                if (block.ymin < lo) lo = block.ymin;
+                if (block.ymax > hi) hi = block.ymax;
+                i += span;
+                break;
+            }
+
+            level --;
+        }
+
+        if (level == 0U) {
+            float y = (*this)[size_t(i - origin)].second;
+
+            if (y < lo) lo = y;
+            if (y > hi) hi = y;
+            i ++;
+        }
+    }
+
+    SET_BOX(ymin, lo);
+    SET_BOX(ymax, hi);
+}
+
+size_t Plteen::PlotSeries::expected_levels() const {
+    size_t n = (this->limit > 0U) ? this->limit : this->count;
+    size_t levels = 0U;
+
+    while ((size_t(1U) << (plot_series_pyramid_floor + levels)) <= n) {
+        levels ++;
+    }
+
+    return levels;
+}
+
+void Plteen::PlotSeries::rebuild_pyramid() {
+    size_t levels = this->expected_levels();
+    uint64_t origin = this->total - this->count;
+
+    this->pyramid.resize(levels);
+    this->pyramid_bases.resize(levels);
+
+    for (size_t level = 0U; level < levels; level ++) {
+        size_t k = plot_series_pyramid_floor + level;
+        
+        this->pyramid[level].clear();
+        this->pyramid_bases[level] = origin >> k;
+
+        if (this->limit > 0U) {
+            // a ring of blocks that overlap the window
+            this->pyramid[level].resize((this->limit >> k) + 2U, { infinity_f, -infinity_f });
+        }
+    }
+
+    for (size_t idx = 0U; idx < this->count; idx ++) {
+        this->summarize(origin + idx, (*this)[idx].second);
+    }
+}
+
+void Plteen::PlotSeries::summarize(uint64_t i, float y) {
+    for (size_t level = 0U; level < this->pyramid.size(); level ++) {
+        size_t k = plot_series_pyramid_floor + level;
+        Summary& block = this->summary(level, i >> k);
+
+        if ((i & ((uint64_t(1U) << k) - 1U)) == 0U) {
+            block = { y, y };
+        } else {
+            if (y < block.ymin) block.ymin = y;
+            if (y > block.ymax) block.ymax = y;
+        }
+    }
+}
+
+Plteen::PlotSeries::Summary& Plteen::PlotSeries::summary(size_t level, uint64_t block) {
+    std::vector<Summary>& blocks = this->pyramid[level];
+
+    if (this->limit > 0U) {
+        block %= blocks.size();
+    } else {
+        block -= this->pyramid_bases[level];
+
+        if (block >= blocks.size()) {
+            blocks.resize(size_t(block) + 1U, { infinity_f, -infinity_f });
+        }
+    }
+
+    return blocks[size_t(block)];
+}
+
+const Plteen::PlotSeries::Summary& Plteen::PlotSeries::summary(size_t level, uint64_t block) const {
+    const std::vector<Summary>& blocks = this->pyramid[level];
+
+    if (this->limit > 0U) {
+        block %= blocks.size();
+    } else {
+        block -= this->pyramid_bases[level];
+    }
+
+    return blocks[size_t(block)];
+}
+
+/*************************************************************************************************/
+void Plteen::PlotTrace::reset() {
+    this->strip.reset();
+    this->needs_redraw = true;
+}
+
+void Plteen::PlotTrace::render(dc_t* dc, const PlotSeries& series, float flwidth, float flheight, const RGBA& color) {
+    int width = fl2fxi(flwidth) + 1;
+    int height = fl2fxi(flheight) + 1;
+
+    if ((this->strip.use_count() == 0) || (this->strip_width != width) || (this->strip_height != height)) {
+        this->strip = std::make_shared<Texture>(dc->create_blank_image(width, height));
+        this->strip_width = width;
+        this->strip_height = height;
+        this->needs_redraw = true;
+    }
+
+    if (this->strip->okay()) {
+        size_t n = series.size();
+        uint64_t fresh = series.sequence() - this->drawn_sequence;
+        float xmin = series.xmin();
+        float ymin = series.ymin();
+        float xrange = flmax(series.xmax() - xmin, flwidth);
+        float yrange = flmax(series.ymax() - ymin, flheight);
+        float scrolled = 0.0F;
+        int shift = 0;
+
+        if (!this->needs_redraw && (fresh > 0U)) {
+            // the axes must keep still, except that the window slides rightward
+            this->needs_redraw = (fresh >= n) || (!series.monotonic())
+                                    || (ymin != this->ymin) || (yrange != this->yrange)
+                                    || (flabs(xrange - this->xrange) * this->xratio >= plot_trace_xrange_tolerance);
+
+            if (!this->needs_redraw) {
+                scrolled = (xmin - this->anchor) * this->xratio;
+                shift = fl2fxi(flfloor(scrolled)) - fl2fxi(flfloor(this->scrolled));
+                this->needs_redraw = (shift < 0) || (shift >= width) || (scrolled >= plot_trace_rebase_threshold);
+            }
+        }
+
+        if (this->needs_redraw || (fresh > 0U)) {
+            SDL_Texture* origin = dc->get_target();
+
+            dc->set_target(this->strip->self());
+
+            if (this->needs_redraw) {
+                this->anchor = (n > 0U) ? xmin : 0.0F;
+                this->scrolled = 0.0F;
+                this->origin = 0;
+                this->xrange = xrange;
+                this->yrange = yrange;
+                this->ymin = ymin;
+                this->xratio = flwidth / xrange;
+                this->yratio = flheight / yrange;
+                this->redraw(dc, series, flheight, color);
+                this->needs_redraw = false;
+            } else {
+                if (shift > 0) {
+                    this->erase_columns(dc, this->origin, shift);
+                    this->origin = (this->origin + shift) % width;
+                }
+
+                this->scrolled = scrolled;
+                this->append(dc, series, size_t(fresh), flheight, color);
+            }
+
+            dc->set_target(origin);
+            this->drawn_sequence = series.sequence();
+        }
+    } else {
+        fprintf(stderr, "无法绘制历史曲线：%s\n", SDL_GetError());
+    }
+}
+
+void Plteen::PlotTrace::stamp(dc_t* dc, float x, float y, float flwidth, float flheight) {
+    if ((this->strip.use_count() > 0) && this->strip->okay()) {
+        float sx = flwidth / float(this->strip_width);
+        int head = this->strip_width - this->origin;
+        SDL_Rect src = { this->origin, 0, head, this->strip_height };
+        SDL_FRect dst = { x, y, float(head) * sx, flheight };
+
+        dc->stamp(this->strip->self(), &src, &dst);
+
+        if (this->origin > 0) {
+            src = { 0, 0, this->origin, this->strip_height };
+            dst = { x + dst.w, y, float(this->origin) * sx, flheight };
+            dc->stamp(this->strip->self(), &src, &dst);
+        }
+    }
+}
+
+/*************************************************************************************************/
+void Plteen::PlotTrace::redraw(dc_t* dc, const PlotSeries& series, float flheight, const RGBA& color) {
+    dc->clear(transparent);
+
+    if (series.size() > 1U) {
+        this->project(series, 0U, series.size(), 0.0F, flheight);
+        dc->draw_lines(this->dots.data(), int(this->dots.size()), color);
+    }
+}
+
+void Plteen::PlotTrace::append(dc_t* dc, const PlotSeries& series, size_t fresh, float flheight, const RGBA& color) {
+    size_t n = series.size();
+    size_t start = n - fresh - 1U; // connecting with the last drawn sample
+    float wrap = float(this->strip_width);
+    float base = flfloor((series[start].first - this->anchor) * this->xratio / wrap) * wrap;
+
+    this->project(series, start, n, base, flheight);
+    dc->draw_lines(this->dots.data(), int(this->dots.size()), color);
+
+    // the new segments never span more than a strip, so that wrapping once is enough
+    if (this->dots.back().x > wrap) {
+        for (size_t idx = 0; idx < this->dots.size(); idx ++) {
+            this->dots[idx].x -= wrap;
+        }
+
+        dc->draw_lines(this->dots.data(), int(this->dots.size()), color);
+    }
+}
+
+void Plteen::PlotTrace::project(const PlotSeries& series, size_t first, size_t last, float ushift, float flheight) {
+    float ufirst = flfloor((series[first].first - this->anchor) * this->xratio);
+    float ulast = flfloor((series[last - 1U].first - this->anchor) * this->xratio);
+    float density = float(last - first) / (ulast - ufirst + 1.0F);
+
+    this->dots.clear();
+
+    if (!series.monotonic() || (density <= plot_trace_decimation_density)) {
+        for (size_t idx = first; idx < last; idx ++) {
+            this->project_dot(series[idx], ushift, flheight);
+        }
+    } else {
+        size_t idx = first;
+
+        while (idx < last) {
+            const std::pair<float, float>& head = series[idx];
+            float column = flfloor((head.first - this->anchor) * this->xratio);
+            size_t end = series.lower_bound(this->anchor + (column + 1.0F) / this->xratio, idx + 1U, last);
+
+            if (end - idx <= 4U) {
+                for (size_t i = idx; i < end; i ++) {
+                    this->project_dot(series[i], ushift, flheight);
+                }
+            } else {
+                // first, min, max, last, the middle two are ordered to meet the last one
+                const std::pair<float, float>& tail = series[end - 1U];
+                float ux = column + 0.5F - ushift;
+                float ymin, ymax;
+
+                series.range_extremes(idx, end, &ymin, &ymax);
+                this->project_dot(head, ushift, flheight);
+
+                if (tail.second >= head.second) {
+                    this->dots.push_back({ ux, flheight - (ymin - this->ymin) * this->yratio });
+                    this->dots.push_back({ ux, flheight - (ymax - this->ymin) * this->yratio });
+                } else {
+                    this->dots.push_back({ ux, flheight - (ymax - this->ymin) * this->yratio });
+                    this->dots.push_back({ ux, flheight - (ymin - this->ymin) * this->yratio });
+                }
+
+                this->project_dot(tail, ushift, flheight);
+            }
+
+            idx = end;
+        }
+    }
+}
+
+void Plteen::PlotTrace::project_dot(const std::pair<float, float>& dot, float ushift, float flheight) {
+    this->dots.push_back({ (dot.first - this->anchor) * this->xratio - ushift,
+                           flheight - (dot.second - this->ymin) * this->yratio });
+}
+
+void Plteen::PlotTrace::erase_columns(dc_t* dc, int start, int span) {
+    SDL_Renderer* renderer = dc->self();
+    SDL_BlendMode mode = SDL_BLENDMODE_BLEND;
+    int head = (span < this->strip_width - start) ? span : (this->strip_width - start);
+    SDL_Rect box = { start, 0, head, this->strip_height };
+
+    SDL_GetRenderDrawBlendMode(renderer, &mode);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderFillRect(renderer, &box);
+
+    if (span > head) {
+        box = { 0, 0, span - head, this->strip_height };
+        SDL_RenderFillRect(renderer, &box);
+    }
+
+    SDL_SetRenderDrawBlendMode(renderer, mode);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../../../graphics/dc.hpp"
+#include "../../../graphics/texture.hpp"
+
+#include <vector>
+#include <deque>
+
+namespace Plteen {
+    /**
+     * Samples of a time series in arrival order,
+     *   a fixed-capacity ring if `capacity` is positive, otherwise unbounded.
+     *
+     * The extremes are those of the samples in the window,
+     *   maintained by monotonic deques, amortized O(1) per sample.
+     *
+     * The y extremes of any range are answered by a pyramid of block summaries,
+     *   the block at level `k` summarizes 2^k samples aligned by sequence,
+     *   O(log n) per sample to update and O(log n) per range to query.
+     */
+    class __lambda__ PlotSeries {
+    public:
+        PlotSeries(size_t capacity = 0U) { this->set_capacity(capacity); }
+
+    public:
+        void push_back(float x, float y);
+        void set_capacity(size_t n);
+        void clear();
+
+    public:
+        size_t size() const { return this->count; }
+        size_t capacity() const { return this->limit; }
+        bool empty() const { return this->count == 0U; }
+        const std::pair<float, float>& operator[](size_t idx) const; // 0 is the oldest
+        const std::pair<float, float>& back() const { return (*this)[this->count - 1U]; }
+
+    public:
+        uint64_t sequence() const { return this->total; } // number of samples ever pushed
+        bool monotonic() const; // whether x never decreases in the window
+        float xmin() const;
+        float xmax() const;
+        float ymin() const;
+        float ymax() const;
+
+    public: // for monotonic series, indices are those of the window
+        size_t lower_bound(float x, size_t first, size_t last) const;
+        void range_extremes(size_t first, size_t last, float* ymin, float* ymax) const;
+
+    private:
+        struct Summary { float ymin; float ymax; };
+
+    private:
+        void rebuild_extremes();
+        void track_extremes(float x, float y);
+        void rebuild_pyramid();
+        void summarize(uint64_t i, float y);
+        size_t expected_levels() const;
+        Summary& summary(size_t level, uint64_t block);
+        const Summary& summary(size_t level, uint64_t block) const;
+
+    private:
+        std::vector<std::pair<float, float>> dots;
+        size_t limit = 0U;
+        size_t head = 0U;
+        size_t count = 0U;
+        uint64_t total = 0U;
+        uint64_t descents = 0U; // sequence of the latest sample whose x goes backward
+
+    private: // { sequence, value }, the front is the extreme of the window
+        std::deque<std::pair<uint64_t, float>> xmins;
+        std::deque<std::pair<uint64_t, float>> xmaxs;
+        std::deque<std::pair<uint64_t, float>> ymins;
+        std::deque<std::pair<uint64_t, float>> ymaxs;
+
+    private: // the level 0 is the series itself, levels below the floor are not stored
+        std::vector<std::vector<Summary>> pyramid;
+        std::vector<uint64_t> pyramid_bases; // first block of each level, for unbounded series
+    };
+
+    /**
+     * Renders a series as a polyline onto a texture used as a circular strip.
+     *
+     * When the axes stay the same, only the segments of new samples are drawn,
+     *   and the strip scrolls by offsetting the source rectangles,
+     *   otherwise, the whole series is redrawn.
+     *
+     * Dense runs are decimated into at most 4 points per pixel column (M4),
+     *   so that a frame costs O(width) points whatever the length of the series.
+     */
+    class __lambda__ PlotTrace {
+    public:
+        void render(Plteen::dc_t* dc, const Plteen::PlotSeries& series, float width, float height, const Plteen::RGBA& color);
+        void stamp(Plteen::dc_t* dc, float x, float y, float width, float height);
+        void invalidate() { this->needs_redraw = true; }
+        void reset();
+
+    private:
+        void redraw(Plteen::dc_t* dc, const Plteen::PlotSeries& series, float height, const Plteen::RGBA& color);
+        void append(Plteen::dc_t* dc, const Plteen::PlotSeries& series, size_t fresh, float height, const Plteen::RGBA& color);
+        void erase_columns(Plteen::dc_t* dc, int start, int span);
+        void project(const Plteen::PlotSeries& series, size_t first, size_t last, float ushift, float height);
+        void project_dot(const std::pair<float, float>& dot, float ushift, float height);
+
+    private:
+        Plteen::shared_texture_t strip = nullptr;
+        std::vector<SDL_FPoint> dots;
+        bool needs_redraw = true;
+        int strip_width = 0;
+        int strip_height = 0;
+        int origin = 0; // the strip column shown at the left edge
+
+    private: // axes of the content
+        uint64_t drawn_sequence = 0U;
+        float anchor = 0.0F; // the x that maps to the strip column 0 before scrolling
+        float scrolled = 0.0F;
+        float xratio = 1.0F;
+        float yratio = 1.0F;
+        float xrange = 0.0F;
+        float ymin = 0.0F;
+        float yrange = 0.0F;
+    };
+}
@@ -14,6 +14,7 @@ using namespace Plteen;
 Plteen::IShapelet::IShapelet(const RGBA& color, const RGBA& bcolor) {
     this->set_brush_color(color);
     this->set_pen_color(bcolor);
+    this->enable_canvas_tinting(true);
 }
 
 void Plteen::IShapelet::draw_on_canvas(Plteen::dc_t* dc, float flwidth, float flheight) {
@@ -40,7 +40,7 @@ void Plteen::ITextlet::construct(Plteen::dc_t* dcer) {
 void Plteen::ITextlet::set_text_color(const RGBA& fgc) {
     if (this->foreground_color != fgc) {
         this->foreground_color = fgc;
-        this->update_texture();
+        this->tint_texture();
         this->notify_updated();
     }
 }
@@ -48,7 +48,7 @@ void Plteen::ITextlet::set_text_color(const RGBA& fgc) {
 void Plteen::ITextlet::set_text_alpha(double alpha) {
     if (this->foreground_color.alpha() != alpha) {
         this->foreground_color = RGBA(this->foreground_color, alpha);
-        this->update_texture();
+        this->tint_texture();
         this->notify_updated();
     }
 }
@@ -217,6 +217,17 @@ void Plteen::ITextlet::update_texture() {
     }
 }
 
+void Plteen::ITextlet::tint_texture() {
+    // the blended text is laid out in white, the color is merely the mods of the texture
+    if ((this->texture.use_count() > 0) && this->texture->okay()) {
+        uint8_t r, g, b, a;
+
+        this->foreground_color.unbox(&r, &g, &b, &a);
+        SDL_SetTextureColorMod(this->texture->self(), r, g, b);
+        SDL_SetTextureAlphaMod(this->texture->self(), a);
+    }
+}
+
 /*************************************************************************************************/
 Plteen::Labellet::Labellet(const char *fmt, ...) {
     VSNPRINT(caption, fmt);
@@ -65,6 +65,7 @@ namespace Plteen {
 
     private:
         void update_texture();
+        void tint_texture();
 
     protected:
         shared_font_t text_font = nullptr;
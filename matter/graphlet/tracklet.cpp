@@ -3,11 +3,15 @@
 #include "../../datum/box.hpp"
 #include "../../datum/flonum.hpp"
 
-// https://www.ferzkopp.net/Software/SDL2_gfx/Docs/html/index.html
-#include <SDL2/SDL2_gfxPrimitives.h>
-
 using namespace Plteen;
 
+/*************************************************************************************************/
+static const size_t tracklet_stroke_flush_threshold = 8192U;
+
+static inline bool stroke_color_equal(const SDL_Color& c1, const SDL_Color& c2) {
+    return (c1.r == c2.r) && (c1.g == c2.g) && (c1.b == c2.b) && (c1.a == c2.a);
+}
+
 /*************************************************************************************************/
 Plteen::Tracklet::Tracklet(float width, float height, uint32_t hex, double alpha)
         : width(flabs(width)), height(flabs(height)), line_width(1) {
@@ -27,44 +31,25 @@ Box Plteen::Tracklet::get_bounding_box() {
 
 void Plteen::Tracklet::add_line(float x1, float y1, float x2, float y2) {
     if (this->is_drawing()) {
-        if (this->canvas->okay()) {
-            auto master = this->drawing_context();
-
-            if (master != nullptr) {
-                SDL_Texture* origin = master->get_target();
-                short fx1 = fl2fx<short>(x1);
-                short fy1 = fl2fx<short>(y1);
-                short fx2 = fl2fx<short>(x2);
-                short fy2 = fl2fx<short>(y2);
-                uint8_t r, g, b, a;
-
-                if (this->pen_okay(&r, &g, &b, &a)) {
-                    master->set_target(this->canvas->self());
-                
-                    if (this->line_width <= 1) {
-                        aalineRGBA(master->self(), fx1, fy1, fx2, fy2, r, g, b, a);
-                    } else {
-                        int radius = this->line_width / 2;
+        uint8_t r, g, b, a;
 
-                        filledCircleRGBA(master->self(), fx1, fy1, radius, r, g, b, a);
-                        filledCircleRGBA(master->self(), fx2, fy2, radius, r, g, b, a);
-                        thickLineRGBA(master->self(), fx1, fy1, fx2, fy2, this->line_width, r, g, b, a);
-                    }
+        if (this->pen_okay(&r, &g, &b, &a)) {
+            this->push_stroke(x1, y1, x2, y2, { r, g, b, a });
 
-                    SDL_SetRenderTarget(master->self(), origin);
+            this->resolve_boundary(x1, y1);
+            this->resolve_boundary(x2, y2);
 
-                    this->resolve_boundary(x1, y1);
-                    this->resolve_boundary(x2, y2);
-
-                    this->dirty_canvas(0U, -1.0);
-                }
+            if (this->stroke_dots.size() >= tracklet_stroke_flush_threshold) {
+                this->flush_strokes_offscreen();
             }
+
+            this->dirty_canvas(0U, -1.0);
         }
     }
 }
 
 void Plteen::Tracklet::stamp(Plteen::IMatter* matter, float x, float y) {
-    if (this->canvas->okay()) {
+    if ((this->canvas.use_count() > 0) && this->canvas->okay()) {
         auto master = this->drawing_context();
 
         if (master != nullptr) {
@@ -74,6 +59,7 @@ void Plteen::Tracklet::stamp(Plteen::IMatter* matter, float x, float y) {
             float mheight = mbox.height();
                 
             master->set_target(this->canvas->self());
+            this->flush_strokes(master); // keep the order of drawing
             matter->draw(master, x, y, mwidth, mheight);
             master->set_target(origin);
 
@@ -85,8 +71,15 @@ void Plteen::Tracklet::stamp(Plteen::IMatter* matter, float x, float y) {
     }
 }
 
+void Plteen::Tracklet::draw_on_canvas(Plteen::dc_t* dc, float Width, float Height) {
+    this->flush_strokes(dc);
+}
+
 /*************************************************************************************************/
 void Plteen::Tracklet::erase() {
+    this->strokes.clear();
+    this->stroke_dots.clear();
+
     if (this->xmax != -infinity) {
         this->xmax = this->ymax = -infinity;
         this->xmin = this->ymin = +infinity;
@@ -107,3 +100,137 @@ void Plteen::Tracklet::resolve_boundary(float x, float y) {
     if (y < this->ymin) this->ymin = y;
     if (y > this->ymax) this->ymax = y;
 }
+
+/*************************************************************************************************/
+void Plteen::Tracklet::push_stroke(float x1, float y1, float x2, float y2, const SDL_Color& color) {
+    if (!this->strokes.empty()) {
+        Stroke& last = this->strokes.back();
+        const SDL_FPoint& tail = this->stroke_dots.back();
+
+        // consecutive lines of the same pen join into one polyline
+        if ((tail.x == x1) && (tail.y == y1) && (last.width == this->line_width) && stroke_color_equal(last.color, color)) {
+            this->stroke_dots.push_back({ x2, y2 });
+            last.count ++;
+
+            return;
+        }
+    }
+
+    this->strokes.push_back({ this->stroke_dots.size(), 2U, color, this->line_width });
+    this->stroke_dots.push_back({ x1, y1 });
+    this->stroke_dots.push_back({ x2, y2 });
+}
+
+void Plteen::Tracklet::flush_strokes_offscreen() {
+    if ((this->canvas.use_count() > 0) && this->canvas->okay()) {
+        auto master = this->drawing_context();
+
+        if (master != nullptr) {
+            SDL_Texture* origin = master->get_target();
+
+            master->set_target(this->canvas->self());
+            this->flush_strokes(master);
+            master->set_target(origin);
+        }
+    }
+}
+
+void Plteen::Tracklet::flush_strokes(Plteen::dc_t* dc) {
+    if (!this->strokes.empty()) {
+        SDL_BlendMode mode;
+
+        this->vertices.clear();
+        this->indices.clear();
+
+        for (auto& stroke : this->strokes) {
+            this->tessellate_stroke(stroke);
+        }
+
+        if (!this->indices.empty()) {
+            SDL_GetRenderDrawBlendMode(dc->self(), &mode);
+            SDL_SetRenderDrawBlendMode(dc->self(), SDL_BLENDMODE_BLEND);
+            SDL_RenderGeometry(dc->self(), nullptr,
+                this->vertices.data(), int(this->vertices.size()),
+                this->indices.data(), int(this->indices.size()));
+            SDL_SetRenderDrawBlendMode(dc->self(), mode);
+        }
+
+        this->strokes.clear();
+        this->stroke_dots.clear();
+    }
+}
+
+void Plteen::Tracklet::tessellate_stroke(const Stroke& stroke) {
+    const SDL_FPoint* dots = this->stroke_dots.data() + stroke.first;
+    float half = flmax(float(stroke.width), 1.0F) * 0.5F;
+    float pnx = 0.0F;
+    float pny = 0.0F;
+    bool has_previous = false;
+    size_t last = stroke.count - 1U;
+
+    for (size_t idx = 0U; idx < last; idx ++) {
+        SDL_FPoint a = dots[idx];
+        SDL_FPoint b = dots[idx + 1U];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float len = flsqrt(dx * dx + dy * dy);
+
+        if (len > 0.0F) {
+            float ux = dx / len;
+            float uy = dy / len;
+            float nx = -uy * half;
+            float ny = +ux * half;
+
+            if (has_previous) {
+                this->tessellate_joint(a, pnx, pny, nx, ny, stroke.color);
+            } else { // square cap, covers the same extent as the round one
+                a.x -= ux * half;
+                a.y -= uy * half;
+            }
+
+            if (idx + 1U == last) {
+                b.x += ux * half;
+                b.y += uy * half;
+            }
+
+            this->tessellate_quad(a, b, nx, ny, stroke.color);
+            pnx = nx;
+            pny = ny;
+            has_previous = true;
+        }
+    }
+
+    if (!has_previous) { // all dots coincide
+        SDL_FPoint a = { dots[0].x - half, dots[0].y };
+        SDL_FPoint b = { dots[0].x + half, dots[0].y };
+
+        this->tessellate_quad(a, b, 0.0F, half, stroke.color);
+    }
+}
+
+void Plteen::Tracklet::tessellate_quad(const SDL_FPoint& a, const SDL_FPoint& b, float nx, float ny, const SDL_Color& c) {
+    int base = int(this->vertices.size());
+
+    this->vertices.push_back({ { a.x + nx, a.y + ny }, c, { 0.0F, 0.0F } });
+    this->vertices.push_back({ { a.x - nx, a.y - ny }, c, { 0.0F, 0.0F } });
+    this->vertices.push_back({ { b.x + nx, b.y + ny }, c, { 0.0F, 0.0F } });
+    this->vertices.push_back({ { b.x - nx, b.y - ny }, c, { 0.0F, 0.0F } });
+
+    this->indices.insert(this->indices.end(), { base, base + 1, base + 2, base + 2, base + 1, base + 3 });
+}
+
+void Plteen::Tracklet::tessellate_joint(const SDL_FPoint& o, float nx0, float ny0, float nx1, float ny1, const SDL_Color& c) {
+    int base = int(this->vertices.size());
+
+    // bevel join, the wedge on the inner side is covered by the segments already
+    if (nx0 * ny1 - ny0 * nx1 > 0.0F) {
+        nx0 = -nx0; ny0 = -ny0;
+        nx1 = -nx1; ny1 = -ny1;
+    }
+
+    this->vertices.push_back({ { o.x, o.y }, c, { 0.0F, 0.0F } });
+    this->vertices.push_back({ { o.x + nx0, o.y + ny0 }, c, { 0.0F, 0.0F } });
+    this->vertices.push_back({ { o.x + nx1, o.y + ny1 }, c, { 0.0F, 0.0F } });
+
+    this->indices.insert(this->indices.end(), { base, base + 1, base + 2 });
+}
@@ -5,6 +5,8 @@
 #include "../canvaslet.hpp"
 #include "../../physics/geometry/aabox.hpp"
 
+#include <vector>
+
 namespace Plteen {
     class __lambda__ Tracklet : public Plteen::ICanvaslet {
     public:
@@ -22,13 +24,36 @@ namespace Plteen {
         void set_pen_width(uint8_t width);
         uint8_t get_pen_width() { return this->line_width; }
 
-    public:
+    public: // lines are buffered as polylines, and rasterized at once when the canvas is drawn
         void add_line(float x1, float y1, float x2, float y2);
         void stamp(Plteen::IMatter* matter, float x, float y);
         void erase();
 
+    protected:
+        void draw_on_canvas(Plteen::dc_t* dc, float Width, float Height) override;
+
+    private:
+        struct Stroke {
+            size_t first; // into `stroke_dots`
+            size_t count;
+            SDL_Color color;
+            uint8_t width;
+        };
+
     private:
         void resolve_boundary(float x, float y);
+        void push_stroke(float x1, float y1, float x2, float y2, const SDL_Color& color);
+        void flush_strokes(Plteen::dc_t* dc);
+        void flush_strokes_offscreen();
+        void tessellate_stroke(const Plteen::Tracklet::Stroke& stroke);
+        void tessellate_quad(const SDL_FPoint& a, const SDL_FPoint& b, float nx, float ny, const SDL_Color& c);
+        void tessellate_joint(const SDL_FPoint& o, float nx0, float ny0, float nx1, float ny1, const SDL_Color& c);
+
+    private:
+        std::vector<Plteen::Tracklet::Stroke> strokes;
+        std::vector<SDL_FPoint> stroke_dots;
+        std::vector<SDL_Vertex> vertices;
+        std::vector<int> indices;
 
     private:
         bool in_drawing = false;
@@ -43,10 +43,24 @@ void Plteen::PlanetCuteAtlas::set_tile_type(int r, int c, GroundBlockType type)
 
     if (this->tiles[r][c] != type) {
         this->tiles[r][c] = type;
+        this->update_map_tile_passability(r, c);
         this->notify_updated();
     }
 }
 
+bool Plteen::PlanetCuteAtlas::is_map_tile_passable(int r, int c) {
+    bool okay = true;
+
+    if (this->tiles != nullptr) {
+        switch (this->tiles[r][c]) {
+        case GroundBlockType::Water: case GroundBlockType::Wall: okay = false; break;
+        default: okay = true;
+        }
+    }
+
+    return okay;
+}
+
 void Plteen::PlanetCuteAtlas::on_tilemap_load(shared_texture_t atlas) {
     GridAtlas::on_tilemap_load(atlas);
 
@@ -59,6 +73,8 @@ void Plteen::PlanetCuteAtlas::on_tilemap_load(shared_texture_t atlas) {
             this->alter_map_tile(r, c);   
         }
     }
+
+    this->update_map_passability();
 }
 
 void Plteen::PlanetCuteAtlas::reset_map_tiles() {
@@ -69,6 +85,7 @@ void Plteen::PlanetCuteAtlas::reset_map_tiles() {
         }
     }
 
+    this->update_map_passability();
     this->notify_updated();
 }
 
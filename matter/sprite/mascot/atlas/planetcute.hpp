@@ -25,6 +25,7 @@ namespace Plteen {
         GroundBlockType get_tile_type(int r, int c) { return this->tiles[r][c]; }
         void set_tile_type(int r, int c, GroundBlockType type);
         void set_tile_type(int r, int c) { this->set_tile_type(r, c, this->default_type); }
+        bool is_map_tile_passable(int r, int c) override;
 
     protected:
         void on_tilemap_load(Plteen::shared_texture_t atlas) override;
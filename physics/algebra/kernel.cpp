@@ -0,0 +1,233 @@
+#include "kernel.hpp"
+
+#include "../../datum/cpu.hpp"
+
+#include <atomic>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define __matrix_kernel_x86__
+#include <immintrin.h>
+#endif
+
+using namespace Plteen;
+
+/*************************************************************************************************/
+namespace {
+    typedef void (*block_multiply_t)(Flonum*, size_t, const Flonum*, size_t, const Flonum*, size_t, size_t, size_t, size_t);
+
+    /**
+     * A `block_rows x block_depth` block of `A` stays in L1/L2 while it sweeps
+     *   a `block_depth x block_cols` panel of `B`, which stays in L2 (128KiB).
+     */
+    static const size_t block_rows = 64U;
+    static const size_t block_depth = 128U;
+    static const size_t block_cols = 128U;
+}
+
+/*************************************************************************************************/
+namespace scalar {
+    /* `C += A * B`, rows are multiplied four at a time to reuse the loaded row of `B` */
+    static void block_multiply(Flonum* C, size_t ldc, const Flonum* A, size_t lda, const Flonum* B, size_t ldb, size_t m, size_t n, size_t p) {
+        size_t i = 0U;
+
+        for (; i + 4U <= m; i += 4U) {
+            Flonum* c0 = C + i * ldc;
+            Flonum* c1 = c0 + ldc;
+            Flonum* c2 = c1 + ldc;
+            Flonum* c3 = c2 + ldc;
+            const Flonum* a0 = A + i * lda;
+            const Flonum* a1 = a0 + lda;
+            const Flonum* a2 = a1 + lda;
+            const Flonum* a3 = a2 + lda;
+
+            for (size_t k = 0U; k < n; ++ k) {
+                const Flonum* b = B + k * ldb;
+                Flonum x0 = a0[k];
+                Flonum x1 = a1[k];
+                Flonum x2 = a2[k];
+                Flonum x3 = a3[k];
+
+                for (size_t j = 0U; j < p; ++ j) {
+                    c0[j] += x0 * b[j];
+                    c1[j] += x1 * b[j];
+                    c2[j] += x2 * b[j];
+                    c3[j] += x3 * b[j];
+                }
+            }
+        }
+
+        for (; i < m; ++ i) {
+            Flonum* c = C + i * ldc;
+            const Flonum* a = A + i * lda;
+
+            for (size_t k = 0U; k < n; ++ k) {
+                const Flonum* b = B + k * ldb;
+                Flonum x = a[k];
+
+                for (size_t j = 0U; j < p; ++ j) {
+                    c[j] += x * b[j];
+                }
+            }
+        }
+    }
+}
+
+#if defined(__matrix_kernel_x86__)
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+    /**
+     * `R` rows by `V` vectors of 4 entries, all accumulators live in registers,
+     *   no FMA, so that the rounding is the same as the scalar version.
+     */
+    template<size_t R, size_t V>
+    static inline void tile_multiply(Flonum* C, size_t ldc, const Flonum* A, size_t lda, const Flonum* B, size_t ldb, size_t n) {
+        __m256d acc[R][V];
+        __m256d b[V];
+
+        for (size_t r = 0U; r < R; ++ r) {
+            for (size_t v = 0U; v < V; ++ v) {
+                acc[r][v] = _mm256_loadu_pd(C + r * ldc + v * 4U);
+            }
+        }
+
+        for (size_t k = 0U; k < n; ++ k) {
+            for (size_t v = 0U; v < V; ++ v) {
+                b[v] = _mm256_loadu_pd(B + k * ldb + v * 4U);
+            }
+
+            for (size_t r = 0U; r < R; ++ r) {
+                __m256d a = _mm256_set1_pd(A[r * lda + k]);
+
+                for (size_t v = 0U; v < V; ++ v) {
+                    acc[r][v] = _mm256_add_pd(acc[r][v], _mm256_mul_pd(a, b[v]));
+                }
+            }
+        }
+
+        for (size_t r = 0U; r < R; ++ r) {
+            for (size_t v = 0U; v < V; ++ v) {
+                _mm256_storeu_pd(C + r * ldc + v * 4U, acc[r][v]);
+            }
+        }
+    }
+
+    template<size_t R>
+    static inline void rows_multiply(Flonum* C, size_t ldc, const Flonum* A, size_t lda, const Flonum* B, size_t ldb, size_t n, size_t p) {
+        size_t j = 0U;
+
+        for (; j + 8U <= p; j += 8U) {
+            tile_multiply<R, 2U>(C + j, ldc, A, lda, B + j, ldb, n);
+        }
+
+        for (; j + 4U <= p; j += 4U) {
+            tile_multiply<R, 1U>(C + j, ldc, A, lda, B + j, ldb, n);
+        }
+
+        if (j < p) {
+            scalar::block_multiply(C + j, ldc, A, lda, B + j, ldb, R, n, p - j);
+        }
+    }
+
+    static void block_multiply(Flonum* C, size_t ldc, const Flonum* A, size_t lda, const Flonum* B, size_t ldb, size_t m, size_t n, size_t p) {
+        size_t i = 0U;
+
+        for (; i + 4U <= m; i += 4U) {
+            rows_multiply<4U>(C + i * ldc, ldc, A + i * lda, lda, B, ldb, n, p);
+        }
+
+        for (; i < m; ++ i) {
+            rows_multiply<1U>(C + i * ldc, ldc, A + i * lda, lda, B, ldb, n, p);
+        }
+    }
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
+
+/*************************************************************************************************/
+static bool matrix_kernel_supports(MatrixKernelISA isa) {
+    bool okay = false;
+
+    switch (isa) {
+    case MatrixKernelISA::Scalar: okay = true; break;
+#if defined(__matrix_kernel_x86__)
+    case MatrixKernelISA::AVX2: okay = cpu_supports_avx2(); break;
+#endif
+    default: okay = false;
+    }
+
+    return okay;
+}
+
+static block_multiply_t matrix_block_kernel(MatrixKernelISA isa) {
+    switch (isa) {
+#if defined(__matrix_kernel_x86__)
+    case MatrixKernelISA::AVX2: return avx2::block_multiply; break;
+#endif
+    default: return scalar::block_multiply;
+    }
+}
+
+static MatrixKernelISA matrix_kernel_best() {
+    MatrixKernelISA best = MatrixKernelISA::Scalar;
+
+    if (matrix_kernel_supports(MatrixKernelISA::AVX2)) {
+        best = MatrixKernelISA::AVX2;
+    }
+
+    return best;
+}
+
+static std::atomic<MatrixKernelISA>& the_isa() {
+    static std::atomic<MatrixKernelISA> isa { matrix_kernel_best() };
+
+    return isa;
+}
+
+/*************************************************************************************************/
+MatrixKernelISA Plteen::matrix_kernel_isa() {
+    return the_isa().load(std::memory_order_relaxed);
+}
+
+MatrixKernelISA Plteen::matrix_kernel_select(MatrixKernelISA isa) {
+    if (!matrix_kernel_supports(isa)) {
+        isa = matrix_kernel_best();
+    }
+
+    the_isa().store(isa, std::memory_order_relaxed);
+
+    return isa;
+}
+
+void Plteen::flmatrix_multiply(Flonum* C, size_t ldc, const Flonum* A, size_t lda, const Flonum* B, size_t ldb, size_t M, size_t N, size_t P) {
+    block_multiply_t block_multiply = matrix_block_kernel(the_isa().load(std::memory_order_relaxed));
+
+    for (size_t i = 0U; i < M; ++ i) {
+        std::fill_n(C + i * ldc, P, Flonum(0));
+    }
+
+    // the depth is the outermost, so that every entry sums its products in the order of the naive loop
+    for (size_t kk = 0U; kk < N; kk += block_depth) {
+        size_t n = std::min(block_depth, N - kk);
+
+        for (size_t jj = 0U; jj < P; jj += block_cols) {
+            size_t p = std::min(block_cols, P - jj);
+
+            for (size_t ii = 0U; ii < M; ii += block_rows) {
+                block_multiply(C + ii * ldc + jj, ldc, A + ii * lda + kk, lda, B + kk * ldb + jj, ldb,
+                    std::min(block_rows, M - ii), n, p);
+            }
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+
+#include "../../datum/flonum.hpp"
+
+namespace Plteen {
+    /**
+     * Matrix kernels over row-major `Flonum` buffers, rows of which are `ld*` elements apart.
+     *
+     * The multiplication is blocked for caches and tiled for registers,
+     *   every instruction set still sums the products of an entry in the order of the naive loop,
+     *   so results are identical across them, and to `array2d_multiply`.
+     *
+     * `C` must not overlap `A` or `B`.
+     */
+    enum class MatrixKernelISA { Scalar, AVX2 };
+
+    __lambda__ Plteen::MatrixKernelISA matrix_kernel_isa();
+    __lambda__ Plteen::MatrixKernelISA matrix_kernel_select(Plteen::MatrixKernelISA isa); // falls back if not supported
+
+    __lambda__ void flmatrix_multiply(Plteen::Flonum* C, size_t ldc,
+                                        const Plteen::Flonum* A, size_t lda, const Plteen::Flonum* B, size_t ldb,
+                                        size_t M, size_t N, size_t P);
+}
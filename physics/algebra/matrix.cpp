@@ -1,25 +1,19 @@
 #include "matrix.hpp"
 
+#include <algorithm>
+
 using namespace Plteen;
 
 /*************************************************************************************************/
 Plteen::Matrix::~Matrix() noexcept {
-    for (size_t r = 0; r < this->M; ++ r) {
-        delete [] this->entries[r];
-    }
-
-    delete [] this->entries;
+    this->deallocate();
 }
 
-Plteen::Matrix::Matrix(size_t m, size_t n) noexcept : M(m), N(n) {
-    this->entries = new Flonum*[this->M];
-
-    for (size_t r = 0; r < this->M; ++ r) {
-        this->entries[r] = new Flonum[this->N];
-    }
+Plteen::Matrix::Matrix(size_t m, size_t n) noexcept {
+    this->allocate(m, n);
 }
 
-Plteen::Matrix::Matrix(const Plteen::Matrix& lhs, const Plteen::Matrix& rhs, bool forward) noexcept {
+Plteen::Matrix::Matrix(const Plteen::Matrix& lhs, const Plteen::Matrix& rhs, bool forward) noexcept : Matrix(lhs.M, lhs.N) {
     if (forward) {
         array2d_add(this->entries, lhs.entries, rhs.entries, this->M, this->N);
     } else {
@@ -27,7 +21,7 @@ Plteen::Matrix::Matrix(const Plteen::Matrix& lhs, const Plteen::Matrix& rhs, boo
     }
 }
 
-Plteen::Matrix::Matrix(const Plteen::Matrix& lhs, Flonum rhs, bool forward) noexcept {
+Plteen::Matrix::Matrix(const Plteen::Matrix& lhs, Flonum rhs, bool forward) noexcept : Matrix(lhs.M, lhs.N) {
     if (forward) {
         array2d_scalar_multiply(this->entries, lhs.entries, rhs, this->M, this->N);
     } else {
@@ -36,11 +30,56 @@ Plteen::Matrix::Matrix(const Plteen::Matrix& lhs, Flonum rhs, bool forward) noex
 }
 
 Plteen::Matrix::Matrix(const Plteen::Matrix& src) noexcept : Matrix(src.M, src.N) {
-    // this->fill(src);
+    std::copy_n(src.pool, src.M * src.stride, this->pool);
 }
 
-Plteen::Matrix::Matrix(const Plteen::Matrix* src) noexcept : Matrix(src->M, src->N) {
-    // this->fill(src);
+Plteen::Matrix::Matrix(const Plteen::Matrix* src) noexcept : Matrix(*src) {}
+
+Plteen::Matrix::Matrix(Plteen::Matrix&& src) noexcept
+    : M(src.M), N(src.N), stride(src.stride), pool(src.pool), entries(src.entries) {
+    src.allocate(0U, 0U);
+}
+
+Plteen::Matrix& Plteen::Matrix::operator=(const Plteen::Matrix& src) noexcept {
+    if (this != &src) {
+        if ((this->M != src.M) || (this->N != src.N)) {
+            this->deallocate();
+            this->allocate(src.M, src.N);
+        }
+
+        std::copy_n(src.pool, src.M * src.stride, this->pool);
+    }
+
+    return (*this);
+}
+
+Plteen::Matrix& Plteen::Matrix::operator=(Plteen::Matrix&& src) noexcept {
+    if (this != &src) {
+        std::swap(this->M, src.M);
+        std::swap(this->N, src.N);
+        std::swap(this->stride, src.stride);
+        std::swap(this->pool, src.pool);
+        std::swap(this->entries, src.entries);
+    }
+
+    return (*this);
+}
+
+void Plteen::Matrix::allocate(size_t m, size_t n) noexcept {
+    this->M = m;
+    this->N = n;
+    this->stride = n;
+    this->pool = new Flonum[this->M * this->stride]();
+    this->entries = new Flonum*[this->M];
+
+    for (size_t r = 0; r < this->M; ++ r) {
+        this->entries[r] = this->pool + r * this->stride;
+    }
+}
+
+void Plteen::Matrix::deallocate() noexcept {
+    delete [] this->entries;
+    delete [] this->pool;
 }
 
 /*************************************************************************************************/
@@ -56,8 +95,9 @@ void Plteen::Matrix::set(size_t r, size_t c, Flonum datum) {
 }
 
 void Plteen::Matrix::swap_row(size_t r1, size_t r2) {
+    // swapping the contents rather than the row pointers, rows stay in order in the pool
     if (array2d_rows_okay(this->M, r1, r2))
-        array2d_swap_row(this->entries, this->N, r1, r2);
+        std::swap_ranges(this->entries[r1], this->entries[r1] + this->N, this->entries[r2]);
 }
 
 void Plteen::Matrix::swap_column(size_t c1, size_t c2) {
@@ -78,7 +118,7 @@ Plteen::Matrix& Plteen::Matrix::operator-=(const Plteen::Matrix& rhs) {
 }
         
 bool Plteen::Matrix::is_singular_matrix() const noexcept {
-    return false;
+    return LUPFactorization(*this).is_singular();
 }
 
 bool Plteen::Matrix::is_scalar_matrix() const noexcept {
@@ -93,6 +133,101 @@ bool Plteen::Matrix::LU_decomposite(Plteen::Matrix* L, Plteen::Matrix* U) const
 }
 
 bool Plteen::Matrix::LUP_decomposite(Plteen::Matrix* L, Plteen::Matrix* U, Plteen::Matrix* P) const noexcept {
-    // return array2d_lup_decomposite(this->entries, L->entries, U->entries, P->entries);
-    return false;
+    LUPFactorization lup(*this);
+
+    if (lup.okay) {
+        size_t n = this->N;
+
+        (*L) = Matrix(n, n);
+        (*U) = Matrix(n, n);
+        (*P) = Matrix(1, n);
+
+        for (size_t r = 0; r < n; ++ r) {
+            for (size_t c = 0; c < r; ++ c) {
+                L->entries[r][c] = lup.LU.entries[r][c];
+            }
+
+            L->entries[r][r] = Flonum(1);
+            std::copy(lup.LU.entries[r] + r, lup.LU.entries[r] + n, U->entries[r] + r);
+            P->entries[0][r] = Flonum(lup.P[r]);
+        }
+    }
+
+    return lup.okay;
+}
+
+LUPFactorization Plteen::Matrix::LUP_factorize() const noexcept {
+    return LUPFactorization(*this);
+}
+
+/*************************************************************************************************/
+Flonum Plteen::Matrix::determinant() const {
+    if (!this->is_square_matrix()) {
+        raise_range_error("determinant of a non-square matrix");
+    }
+
+    return LUPFactorization(*this).determinant();
+}
+
+bool Plteen::Matrix::inverse(Plteen::Matrix* dest) const noexcept {
+    return LUPFactorization(*this).inverse(dest);
+}
+
+bool Plteen::Matrix::solve(const Plteen::Matrix& b, Plteen::Matrix* x) const noexcept {
+    return LUPFactorization(*this).solve(b, x);
+}
+
+/*************************************************************************************************/
+Plteen::LUPFactorization::LUPFactorization(const Plteen::Matrix& src) noexcept : LU(src) {
+    this->factorize(src);
+}
+
+bool Plteen::LUPFactorization::factorize(const Plteen::Matrix& src) noexcept {
+    if (&src != &this->LU) {
+        this->LU = src;
+    }
+
+    this->P.resize(src.M);
+    this->sign = 1;
+    this->okay = src.is_square_matrix()
+                    && array2d_lup_factorize(this->LU.entries, this->LU.M, this->P, &this->sign);
+
+    return this->okay;
+}
+
+Flonum Plteen::LUPFactorization::determinant() const noexcept {
+    return this->okay ? array2d_lup_determinant<Flonum>(this->LU.entries, this->LU.M, this->sign) : Flonum(0);
+}
+
+bool Plteen::LUPFactorization::solve(const Plteen::Matrix& b, Plteen::Matrix* x) const noexcept {
+    bool okay = this->okay && (b.M == this->LU.M);
+
+    if (okay) {
+        if (x == &b) {
+            Matrix src(b);
+
+            return this->solve(src, x);
+        }
+
+        if ((x->M != b.M) || (x->N != b.N)) {
+            (*x) = Matrix(b.M, b.N);
+        }
+
+        array2d_lup_solve(this->LU.entries, this->LU.M, this->P, b.entries, x->entries, b.N);
+    }
+
+    return okay;
+}
+
+bool Plteen::LUPFactorization::inverse(Plteen::Matrix* dest) const noexcept {
+    bool okay = this->okay;
+
+    if (okay) {
+        Matrix I(this->LU.M);
+
+        array2d_fill_diagonal_with_datum(I.entries, I.M, I.N, Flonum(1));
+        okay = this->solve(I, dest);
+    }
+
+    return okay;
 }
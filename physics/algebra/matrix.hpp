@@ -11,7 +11,10 @@
 #include "../../datum/flonum.hpp"
 #include "../../datum/string.hpp"
 
+#include "kernel.hpp"
+
 #include <type_traits>
+#include <vector>
 
 namespace Plteen {
     /*********************************************************************************************/
@@ -99,6 +102,8 @@ namespace Plteen {
 
     /*********************************************************************************************/
     class __lambda__ Matrix;
+    class __lambda__ LUPFactorization;
+    template<size_t N> class lup_factorization;
 
     template<size_t M, size_t N = M, typename T = Flonum>
     class __lambda__ matrix
@@ -107,6 +112,7 @@ namespace Plteen {
 #endif
     {
         template<size_t R, size_t C, typename U> friend class Plteen::matrix;
+        template<size_t R> friend class Plteen::lup_factorization;
         friend class Plteen::Matrix;
 
         using Super = std::enable_if_t<std::is_arithmetic_v<T>, super_t<T>>;
@@ -338,7 +344,7 @@ namespace Plteen {
 
         template<size_t P, typename R>
         friend inline Plteen::matrix<M, P, decltype(T{} * R{})> operator*(const Plteen::matrix<M, N, T>& lhs, const Plteen::matrix<N, P, R>& rhs)
-        { Plteen::matrix<M, P, decltype(T{} * R{})> self; array2d_multiply(self.entries, lhs.entries, rhs.entries, M, N, P); return self; }
+        { Plteen::matrix<M, P, decltype(T{} * R{})> self; lhs.multiply(rhs, &self); return self; }
 
     public:
         Plteen::matrix<N, M, T> transpose() const noexcept { Plteen::matrix<N, M, T> dest; this->transpose(&dest); return dest; }
@@ -428,6 +434,18 @@ namespace Plteen {
         LUP_decomposite(Plteen::matrix<M, N, D>* L, Plteen::matrix<M, N, D>* U, Plteen::matrix<1, N, size_t>* P) const noexcept
         { return array2d_lup_decomposite(this->entries, L->entries, U->entries, P->entries); }
         
+    public:
+        template<typename F = Plteen::lup_factorization<N>>
+        typename std::enable_if_t<M == N, F> LUP_factorize() const noexcept { return F(*this); }
+
+        template<typename B = bool>
+        typename std::enable_if_t<M == N, B> inverse(Plteen::matrix<M, N, Flonum>* dest) const noexcept
+        { return Plteen::lup_factorization<N>(*this).inverse(dest); }
+
+        template<size_t C, typename U, typename B = bool>
+        typename std::enable_if_t<M == N, B> solve(const Plteen::matrix<N, C, U>& b, Plteen::matrix<N, C, Flonum>* x) const noexcept
+        { return Plteen::lup_factorization<N>(*this).solve(b, x); }
+
     public:
         template<typename E = T>
         typename std::enable_if_t<M == N, E> trace() const noexcept { return array2d_trace(this->entries, N, E(0)); }
@@ -437,19 +455,19 @@ namespace Plteen {
             if constexpr(N > 0) {
                 if constexpr(N < 5) {
                     return matrix_determinant<T, S>(this->entries);
-                } else {  // Inefficient, but we don't currently use N > 4 anyway...
-                    matrix<N - 1, N - 1, T> submtx;
-                    S sign = 1;
-                    S det = 0;
-                    
-                    for (size_t i = 0; i < N; ++ i) {
-                        // Submatrix without row 0 and column `i`
-                        array2d_reduce(this->entries, N, submtx.entries, 0, i);
-                        det += fl_multiply(sign * this->entries[0][i], submtx.determinant());
-                        sign = -sign;
+                } else {
+                    S self[N][N];
+
+                    array2d_copy_to_array2d(this->entries, N, N, self, N, N);
+
+                    if constexpr(std::is_integral_v<S>) { // exact, as integer matrices promise
+                        return array2d_bareiss_determinant<S>(self, N);
+                    } else {
+                        size_t P[N];
+                        int sign = 1;
+
+                        return array2d_lup_factorize(self, N, P, &sign) ? array2d_lup_determinant<S>(self, N, sign) : S(0);
                     }
-        
-                    return det;
                 }
             } else { 
                 // the empty product as in `x^0 = 1` and `0! = 1`,
@@ -463,6 +481,15 @@ namespace Plteen {
         { return array2d_to_string(this->entries, M, N, 0, one_line); }
 
     private:
+        template<size_t P, typename R, typename D>
+        void multiply(const Plteen::matrix<N, P, R>& rhs, Plteen::matrix<M, P, D>* self) const noexcept {
+            if constexpr (std::is_same_v<T, Flonum> && std::is_same_v<R, Flonum> && (M * N * P >= 512U)) {
+                flmatrix_multiply(self->entries[0], P, this->entries[0], N, rhs.entries[0], P, M, N, P);
+            } else { // small ones are unrolled in place, which is cheaper than calling the kernel
+                array2d_multiply(self->entries, this->entries, rhs.entries, M, N, P);
+            }
+        }
+
         template<typename Lhs, typename Rhs>
         matrix(const Plteen::matrix<M, N, Lhs>& lhs, const Plteen::matrix<M, N, Rhs>& rhs, bool forward) noexcept {
             if (forward) {
@@ -488,6 +515,7 @@ namespace Plteen {
     /*********************************************************************************************/
     class __lambda__ Matrix {
         template<size_t R, size_t C, typename U> friend class Plteen::matrix;
+        friend class Plteen::LUPFactorization;
         
         using Super = super_t<Flonum>;
 
@@ -499,6 +527,10 @@ namespace Plteen {
 
         Matrix(const Plteen::Matrix& src) noexcept;
         Matrix(const Plteen::Matrix* src) noexcept;
+        Matrix(Plteen::Matrix&& src) noexcept;
+
+        Plteen::Matrix& operator=(const Plteen::Matrix& src) noexcept;
+        Plteen::Matrix& operator=(Plteen::Matrix&& src) noexcept;
 
         template<size_t R, size_t C, typename U>
         Matrix(const Plteen::matrix<R, C, U>& src) noexcept : Matrix(R, C) { this->fill(src); }
@@ -618,7 +650,13 @@ namespace Plteen {
         friend inline Plteen::Matrix operator*(Flonum lhs, const Plteen::Matrix& rhs) { return Plteen::Matrix(rhs, lhs, true); }
         friend inline Plteen::Matrix operator/(const Plteen::Matrix lhs, Flonum rhs) { return Plteen::Matrix(lhs, rhs, false); }
         friend inline Plteen::Matrix operator*(const Plteen::Matrix& lhs, const Plteen::Matrix& rhs)
-        { Plteen::Matrix self(lhs.M, rhs.N); array2d_multiply(self.entries, lhs.entries, rhs.entries, lhs.M, lhs.N, rhs.N); return self; }
+        {
+            Plteen::Matrix self(lhs.M, rhs.N);
+
+            flmatrix_multiply(self.pool, self.stride, lhs.pool, lhs.stride, rhs.pool, rhs.stride, lhs.M, lhs.N, rhs.N);
+
+            return self;
+        }
 
     public:
         size_t row_size() const noexcept { return this->M; }
@@ -649,6 +687,12 @@ namespace Plteen {
     public:
         bool LU_decomposite(Plteen::Matrix* L, Plteen::Matrix* U) const noexcept;
         bool LUP_decomposite(Plteen::Matrix* L, Plteen::Matrix* U, Plteen::Matrix* P) const noexcept;
+        Plteen::LUPFactorization LUP_factorize() const noexcept;
+
+    public:
+        Flonum determinant() const;
+        bool inverse(Plteen::Matrix* dest) const noexcept;
+        bool solve(const Plteen::Matrix& b, Plteen::Matrix* x) const noexcept;
         
     public:
         std::string desc(bool one_line = false) const noexcept
@@ -658,10 +702,100 @@ namespace Plteen {
         Matrix(const Plteen::Matrix& lhs, const Plteen::Matrix& rhs, bool forward) noexcept;
         Matrix(const Plteen::Matrix& lhs, Flonum rhs, bool forward) noexcept;
 
+    private:
+        void allocate(size_t m, size_t n) noexcept;
+        void deallocate() noexcept;
+
     private:
         size_t M;
         size_t N;
-        Flonum** entries;
+        size_t stride; // entries between the starts of two rows
+        Flonum* pool;  // all rows, contiguous in row-major order
+        Flonum** entries; // rows in `pool`, for `array2d_*`s
+    };
+
+    /*********************************************************************************************/
+    /**
+     * LUP factorizations with partial pivoting, made once and reused for repeated solves,
+     *   entries are `Flonum`s whatever the type of the matrix is.
+     *
+     * Solving against a singular matrix fails and leaves the destination untouched.
+     */
+    template<size_t N>
+    class lup_factorization {
+    public:
+        lup_factorization() = default;
+
+        template<typename T>
+        lup_factorization(const Plteen::matrix<N, N, T>& src) noexcept { this->factorize(src); }
+
+    public:
+        template<typename T>
+        bool factorize(const Plteen::matrix<N, N, T>& src) noexcept {
+            array2d_copy_to_array2d(src.entries, N, N, this->LU, N, N);
+            this->okay = array2d_lup_factorize(this->LU, N, this->P, &this->sign);
+
+            return this->okay;
+        }
+
+        bool is_singular() const noexcept { return !this->okay; }
+        Flonum determinant() const noexcept { return this->okay ? array2d_lup_determinant<Flonum>(this->LU, N, this->sign) : Flonum(0); }
+
+        template<size_t C, typename U>
+        bool solve(const Plteen::matrix<N, C, U>& b, Plteen::matrix<N, C, Flonum>* x) const noexcept {
+            if (this->okay) {
+                if constexpr (std::is_same_v<U, Flonum>) {
+                    if (&b == x) {
+                        Plteen::matrix<N, C, Flonum> src = b;
+
+                        array2d_lup_solve(this->LU, N, this->P, src.entries, x->entries, C);
+                        return true;
+                    }
+                }
+
+                array2d_lup_solve(this->LU, N, this->P, b.entries, x->entries, C);
+            }
+
+            return this->okay;
+        }
+
+        bool inverse(Plteen::matrix<N, N, Flonum>* dest) const noexcept {
+            if (this->okay) {
+                Flonum I[N][N] = {};
+
+                array2d_fill_diagonal_with_datum(I, N, N, Flonum(1));
+                array2d_lup_solve(this->LU, N, this->P, I, dest->entries, N);
+            }
+
+            return this->okay;
+        }
+
+    private:
+        Flonum LU[N][N] = {};
+        size_t P[N] = {};
+        int sign = 1;
+        bool okay = false;
+    };
+
+    class __lambda__ LUPFactorization {
+    public:
+        LUPFactorization(const Plteen::Matrix& src) noexcept;
+
+    public:
+        bool factorize(const Plteen::Matrix& src) noexcept;
+        bool is_singular() const noexcept { return !this->okay; }
+        Flonum determinant() const noexcept;
+        bool solve(const Plteen::Matrix& b, Plteen::Matrix* x) const noexcept;
+        bool inverse(Plteen::Matrix* dest) const noexcept;
+
+    private:
+        friend class Plteen::Matrix;
+
+    private:
+        Plteen::Matrix LU;
+        std::vector<size_t> P;
+        int sign = 1;
+        bool okay = false;
     };
 
     /*********************************************************************************************/
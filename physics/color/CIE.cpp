@@ -10,7 +10,7 @@ static inline double color_gamma_encode(double c) {
     double sgn = (c < 0.0) ? -1.0 : 1.0;
     double abs = flabs(c);
 
-    return (abs <= 0.0031308) ? c * 12.92 : sgn * (flexpt(c, 1.0 / 2.4 ) * 1.055 - 0.055);
+    return (abs <= 0.0031308) ? c * 12.92 : sgn * (flexpt(abs, 1.0 / 2.4) * 1.055 - 0.055);
 }
 
 static inline double color_gamma_decode(double c) {
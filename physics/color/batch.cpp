@@ -0,0 +1,403 @@
+#include "batch.hpp"
+
+#include "../../datum/flonum.hpp"
+#include "../../datum/cpu.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define __color_batch_x86__
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define __color_batch_neon__
+#include <arm_neon.h>
+#endif
+
+using namespace Plteen;
+
+/*************************************************************************************************/
+namespace {
+    struct ColorBatchKernels {
+        void (*rgb_to_hsv)(const float*, const float*, const float*, float*, float*, float*, size_t);
+        void (*hsv_to_rgb)(const float*, const float*, const float*, float*, float*, float*, size_t);
+        void (*rgb_to_hsl)(const float*, const float*, const float*, float*, float*, float*, size_t);
+        void (*hsl_to_rgb)(const float*, const float*, const float*, float*, float*, float*, size_t);
+        void (*rgb_to_hsi)(const float*, const float*, const float*, float*, float*, float*, size_t);
+        void (*hsi_to_rgb)(const float*, const float*, const float*, float*, float*, float*, size_t);
+        void (*xyz_to_rgb)(const float*, bool, const float*, const float*, const float*, float*, float*, float*, size_t);
+        void (*rgb_to_xyz)(const float*, bool, const float*, const float*, const float*, float*, float*, float*, size_t);
+        void (*xyy_to_xyz)(const float*, const float*, float*, float*, float*, size_t, float);
+        void (*xyz_to_xyy)(const float*, const float*, const float*, float*, float*, size_t);
+        void (*gamma_encode)(const float*, float*, size_t);
+        void (*gamma_decode)(const float*, float*, size_t);
+    };
+
+    /* the same coefficients as `CIE.cpp` */
+    static const float cie_primary_xyz_to_rgb[] = {
+        +2.36461F, -0.89654F, -0.46807F,
+        -0.51517F, +1.42641F, +0.08876F,
+        +0.00520F, -0.01441F, +1.00920F
+    };
+
+    static const float cie_primary_rgb_to_xyz[] = {
+        0.49000F, 0.31000F, 0.20000F,
+        0.17697F, 0.81240F, 0.01063F,
+        0.00000F, 0.01000F, 0.99000F
+    };
+
+    static const float cie_d65_xyz_to_rgb[] = {
+        +3.240479F, -1.537150F, -0.498535F,
+        -0.969256F, +1.875991F, +0.041556F,
+        +0.055648F, -0.204043F, +1.057311F
+    };
+
+    static const float cie_d65_rgb_to_xyz[] = {
+        0.412453F, 0.357580F, 0.180423F,
+        0.212671F, 0.715160F, 0.072169F,
+        0.019334F, 0.119193F, 0.950227F
+    };
+}
+
+/*************************************************************************************************/
+namespace scalar {
+    struct Lanes {
+        typedef float V;
+        typedef bool M;
+        static constexpr size_t width = 1U;
+
+        static inline V load(const float* src) { return (*src); }
+        static inline void store(float* dst, V v) { (*dst) = v; }
+        static inline V fill(float fl) { return fl; }
+
+        static inline V add(V a, V b) { return a + b; }
+        static inline V sub(V a, V b) { return a - b; }
+        static inline V mul(V a, V b) { return a * b; }
+        static inline V div(V a, V b) { return a / b; }
+        static inline V min(V a, V b) { return (a < b) ? a : b; }
+        static inline V max(V a, V b) { return (a > b) ? a : b; }
+        static inline V abs(V a) { return std::fabs(a); }
+        static inline V sqrt(V a) { return std::sqrt(a); }
+        static inline V floor(V a) { return std::floor(a); }
+
+        static inline M lt(V a, V b) { return a < b; }
+        static inline M le(V a, V b) { return a <= b; }
+        static inline M eq(V a, V b) { return a == b; }
+        static inline M unordered(V a) { return a != a; }
+        static inline M either(M a, M b) { return a || b; }
+        static inline V select(M m, V a, V b) { return m ? a : b; }
+
+        static inline V exponent(V x, V* mantissa) {
+            uint32_t bits;
+
+            memcpy(&bits, &x, sizeof(float));
+            x = float(int32_t(bits >> 23U) - 127);
+            bits = (bits & 0x007FFFFFU) | 0x3F800000U;
+            memcpy(mantissa, &bits, sizeof(float));
+
+            return x;
+        }
+
+        static inline V exp2i(V n) {
+            uint32_t bits = uint32_t(int32_t(n) + 127) << 23U;
+            float fl;
+
+            memcpy(&fl, &bits, sizeof(float));
+
+            return fl;
+        }
+    };
+
+#include "batch.inl"
+}
+
+#if defined(__color_batch_x86__)
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace sse2 {
+    struct Lanes {
+        typedef __m128 V;
+        typedef __m128 M;
+        static constexpr size_t width = 4U;
+
+        static inline V load(const float* src) { return _mm_loadu_ps(src); }
+        static inline void store(float* dst, V v) { _mm_storeu_ps(dst, v); }
+        static inline V fill(float fl) { return _mm_set1_ps(fl); }
+
+        static inline V add(V a, V b) { return _mm_add_ps(a, b); }
+        static inline V sub(V a, V b) { return _mm_sub_ps(a, b); }
+        static inline V mul(V a, V b) { return _mm_mul_ps(a, b); }
+        static inline V div(V a, V b) { return _mm_div_ps(a, b); }
+        static inline V min(V a, V b) { return _mm_min_ps(a, b); }
+        static inline V max(V a, V b) { return _mm_max_ps(a, b); }
+        static inline V abs(V a) { return _mm_andnot_ps(_mm_set1_ps(-0.0F), a); }
+        static inline V sqrt(V a) { return _mm_sqrt_ps(a); }
+
+        static inline V floor(V a) { // SSE2 has no rounding instruction, |a| >= 2^23 are integers already
+            V t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+
+            t = _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0F)));
+
+            return select(_mm_cmplt_ps(abs(a), _mm_set1_ps(8388608.0F)), t, a);
+        }
+
+        static inline M lt(V a, V b) { return _mm_cmplt_ps(a, b); }
+        static inline M le(V a, V b) { return _mm_cmple_ps(a, b); }
+        static inline M eq(V a, V b) { return _mm_cmpeq_ps(a, b); }
+        static inline M unordered(V a) { return _mm_cmpunord_ps(a, a); }
+        static inline M either(M a, M b) { return _mm_or_ps(a, b); }
+        static inline V select(M m, V a, V b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+
+        static inline V exponent(V x, V* mantissa) {
+            __m128i bits = _mm_castps_si128(x);
+
+            (*mantissa) = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+            return _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+        }
+
+        static inline V exp2i(V n) {
+            return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n), _mm_set1_epi32(127)), 23));
+        }
+    };
+
+#include "batch.inl"
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace avx2 {
+    struct Lanes {
+        typedef __m256 V;
+        typedef __m256 M;
+        static constexpr size_t width = 8U;
+
+        static inline V load(const float* src) { return _mm256_loadu_ps(src); }
+        static inline void store(float* dst, V v) { _mm256_storeu_ps(dst, v); }
+        static inline V fill(float fl) { return _mm256_set1_ps(fl); }
+
+        static inline V add(V a, V b) { return _mm256_add_ps(a, b); }
+        static inline V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+        static inline V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+        static inline V div(V a, V b) { return _mm256_div_ps(a, b); }
+        static inline V min(V a, V b) { return _mm256_min_ps(a, b); }
+        static inline V max(V a, V b) { return _mm256_max_ps(a, b); }
+        static inline V abs(V a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0F), a); }
+        static inline V sqrt(V a) { return _mm256_sqrt_ps(a); }
+        static inline V floor(V a) { return _mm256_floor_ps(a); }
+
+        static inline M lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+        static inline M le(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+        static inline M eq(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+        static inline M unordered(V a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+        static inline M either(M a, M b) { return _mm256_or_ps(a, b); }
+        static inline V select(M m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+
+        static inline V exponent(V x, V* mantissa) {
+            __m256i bits = _mm256_castps_si256(x);
+
+            (*mantissa) = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F800000)));
+
+            return _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+        }
+
+        static inline V exp2i(V n) {
+            return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n), _mm256_set1_epi32(127)), 23));
+        }
+    };
+
+#include "batch.inl"
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+#endif
+
+#if defined(__color_batch_neon__)
+namespace neon {
+    struct Lanes {
+        typedef float32x4_t V;
+        typedef uint32x4_t M;
+        static constexpr size_t width = 4U;
+
+        static inline V load(const float* src) { return vld1q_f32(src); }
+        static inline void store(float* dst, V v) { vst1q_f32(dst, v); }
+        static inline V fill(float fl) { return vdupq_n_f32(fl); }
+
+        static inline V add(V a, V b) { return vaddq_f32(a, b); }
+        static inline V sub(V a, V b) { return vsubq_f32(a, b); }
+        static inline V mul(V a, V b) { return vmulq_f32(a, b); }
+        static inline V div(V a, V b) { return vdivq_f32(a, b); }
+        static inline V min(V a, V b) { return vbslq_f32(vcltq_f32(a, b), a, b); } // the same as `minps` for NaNs
+        static inline V max(V a, V b) { return vbslq_f32(vcgtq_f32(a, b), a, b); }
+        static inline V abs(V a) { return vabsq_f32(a); }
+        static inline V sqrt(V a) { return vsqrtq_f32(a); }
+        static inline V floor(V a) { return vrndmq_f32(a); }
+
+        static inline M lt(V a, V b) { return vcltq_f32(a, b); }
+        static inline M le(V a, V b) { return vcleq_f32(a, b); }
+        static inline M eq(V a, V b) { return vceqq_f32(a, b); }
+        static inline M unordered(V a) { return vmvnq_u32(vceqq_f32(a, a)); }
+        static inline M either(M a, M b) { return vorrq_u32(a, b); }
+        static inline V select(M m, V a, V b) { return vbslq_f32(m, a, b); }
+
+        static inline V exponent(V x, V* mantissa) {
+            uint32x4_t bits = vreinterpretq_u32_f32(x);
+
+            (*mantissa) = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007FFFFFU)), vdupq_n_u32(0x3F800000U)));
+
+            return vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)));
+        }
+
+        static inline V exp2i(V n) {
+            return vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127)), 23));
+        }
+    };
+
+#include "batch.inl"
+}
+#endif
+
+/*************************************************************************************************/
+static bool color_batch_supports(ColorBatchISA isa) {
+    bool okay = false;
+
+    switch (isa) {
+    case ColorBatchISA::Scalar: okay = true; break;
+#if defined(__color_batch_x86__)
+    case ColorBatchISA::SSE2: okay = cpu_supports_sse2(); break;
+    case ColorBatchISA::AVX2: okay = cpu_supports_avx2(); break;
+#endif
+#if defined(__color_batch_neon__)
+    case ColorBatchISA::NEON: okay = true; break;
+#endif
+    default: okay = false;
+    }
+
+    return okay;
+}
+
+static const ColorBatchKernels* color_batch_kernels(ColorBatchISA isa) {
+    switch (isa) {
+#if defined(__color_batch_x86__)
+    case ColorBatchISA::SSE2: return &sse2::kernels; break;
+    case ColorBatchISA::AVX2: return &avx2::kernels; break;
+#endif
+#if defined(__color_batch_neon__)
+    case ColorBatchISA::NEON: return &neon::kernels; break;
+#endif
+    default: return &scalar::kernels;
+    }
+}
+
+static ColorBatchISA color_batch_best() {
+    ColorBatchISA best = ColorBatchISA::Scalar;
+
+    if (color_batch_supports(ColorBatchISA::AVX2)) {
+        best = ColorBatchISA::AVX2;
+    } else if (color_batch_supports(ColorBatchISA::SSE2)) {
+        best = ColorBatchISA::SSE2;
+    } else if (color_batch_supports(ColorBatchISA::NEON)) {
+        best = ColorBatchISA::NEON;
+    }
+
+    return best;
+}
+
+static std::atomic<ColorBatchISA>& the_isa() {
+    static std::atomic<ColorBatchISA> isa { color_batch_best() };
+
+    return isa;
+}
+
+static inline const ColorBatchKernels* kernels() {
+    return color_batch_kernels(the_isa().load(std::memory_order_relaxed));
+}
+
+static inline const float* cie_matrix(CIE_Standard type, bool to_rgb) {
+    if (type == CIE_Standard::Primary) {
+        return to_rgb ? cie_primary_xyz_to_rgb : cie_primary_rgb_to_xyz;
+    } else {
+        return to_rgb ? cie_d65_xyz_to_rgb : cie_d65_rgb_to_xyz;
+    }
+}
+
+/*************************************************************************************************/
+ColorBatchISA Plteen::color_batch_isa() {
+    return the_isa().load(std::memory_order_relaxed);
+}
+
+ColorBatchISA Plteen::color_batch_select(ColorBatchISA isa) {
+    if (!color_batch_supports(isa)) {
+        isa = color_batch_best();
+    }
+
+    the_isa().store(isa, std::memory_order_relaxed);
+
+    return isa;
+}
+
+void Plteen::RGB_to_HSV_batch(const float* r, const float* g, const float* b, float* h, float* s, float* v, size_t n) {
+    kernels()->rgb_to_hsv(r, g, b, h, s, v, n);
+}
+
+void Plteen::HSV_to_RGB_batch(const float* h, const float* s, const float* v, float* r, float* g, float* b, size_t n) {
+    kernels()->hsv_to_rgb(h, s, v, r, g, b, n);
+}
+
+void Plteen::RGB_to_HSL_batch(const float* r, const float* g, const float* b, float* h, float* s, float* l, size_t n) {
+    kernels()->rgb_to_hsl(r, g, b, h, s, l, n);
+}
+
+void Plteen::HSL_to_RGB_batch(const float* h, const float* s, const float* l, float* r, float* g, float* b, size_t n) {
+    kernels()->hsl_to_rgb(h, s, l, r, g, b, n);
+}
+
+void Plteen::RGB_to_HSI_batch(const float* r, const float* g, const float* b, float* h, float* s, float* i, size_t n) {
+    kernels()->rgb_to_hsi(r, g, b, h, s, i, n);
+}
+
+void Plteen::HSI_to_RGB_batch(const float* h, const float* s, const float* i, float* r, float* g, float* b, size_t n) {
+    kernels()->hsi_to_rgb(h, s, i, r, g, b, n);
+}
+
+void Plteen::CIE_XYZ_to_RGB_batch(CIE_Standard type, const float* X, const float* Y, const float* Z, float* R, float* G, float* B, size_t n, bool gamma) {
+    kernels()->xyz_to_rgb(cie_matrix(type, true), gamma, X, Y, Z, R, G, B, n);
+}
+
+void Plteen::CIE_RGB_to_XYZ_batch(CIE_Standard type, const float* R, const float* G, const float* B, float* X, float* Y, float* Z, size_t n, bool gamma) {
+    kernels()->rgb_to_xyz(cie_matrix(type, false), gamma, R, G, B, X, Y, Z, n);
+}
+
+void Plteen::CIE_xyY_to_XYZ_batch(const float* x, const float* y, float* X, float* Y, float* Z, size_t n, float L) {
+    kernels()->xyy_to_xyz(x, y, X, Y, Z, n, L);
+}
+
+void Plteen::CIE_XYZ_to_xyY_batch(const float* X, const float* Y, const float* Z, float* x, float* y, size_t n) {
+    kernels()->xyz_to_xyy(X, Y, Z, x, y, n);
+}
+
+void Plteen::color_gamma_encode_batch(const float* linear, float* srgb, size_t n) {
+    kernels()->gamma_encode(linear, srgb, n);
+}
+
+void Plteen::color_gamma_decode_batch(const float* srgb, float* linear, size_t n) {
+    kernels()->gamma_decode(srgb, linear, n);
+}
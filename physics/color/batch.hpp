@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+
+#include "CIE.hpp"
+
+namespace Plteen {
+    /**
+     * Batch color conversions over planar arrays of `float`s (one array per component),
+     *   `src` and `dst` arrays may be the same array, but must not partially overlap.
+     *
+     * The instruction set is chosen at runtime, and every instruction set runs the same
+     *   operations in the same order, so results are identical across them,
+     *   and agree with the single-color `double` versions within `float` precision.
+     *
+     * Hues are in degrees, `NaN` for achromatic colors, as `RGBA::hue()` does.
+     */
+    enum class ColorBatchISA { Scalar, SSE2, AVX2, NEON };
+
+    __lambda__ Plteen::ColorBatchISA color_batch_isa();
+    __lambda__ Plteen::ColorBatchISA color_batch_select(Plteen::ColorBatchISA isa); // falls back if not supported
+
+    __lambda__ void RGB_to_HSV_batch(const float* r, const float* g, const float* b, float* h, float* s, float* v, size_t n);
+    __lambda__ void HSV_to_RGB_batch(const float* h, const float* s, const float* v, float* r, float* g, float* b, size_t n);
+    __lambda__ void RGB_to_HSL_batch(const float* r, const float* g, const float* b, float* h, float* s, float* l, size_t n);
+    __lambda__ void HSL_to_RGB_batch(const float* h, const float* s, const float* l, float* r, float* g, float* b, size_t n);
+    __lambda__ void RGB_to_HSI_batch(const float* r, const float* g, const float* b, float* h, float* s, float* i, size_t n);
+    __lambda__ void HSI_to_RGB_batch(const float* h, const float* s, const float* i, float* r, float* g, float* b, size_t n);
+
+    __lambda__ void CIE_XYZ_to_RGB_batch(Plteen::CIE_Standard type, const float* X, const float* Y, const float* Z,
+                                            float* R, float* G, float* B, size_t n, bool gamma = true);
+    __lambda__ void CIE_RGB_to_XYZ_batch(Plteen::CIE_Standard type, const float* R, const float* G, const float* B,
+                                            float* X, float* Y, float* Z, size_t n, bool gamma = true);
+    __lambda__ void CIE_xyY_to_XYZ_batch(const float* x, const float* y, float* X, float* Y, float* Z, size_t n, float L = 1.0F);
+    __lambda__ void CIE_XYZ_to_xyY_batch(const float* X, const float* Y, const float* Z, float* x, float* y, size_t n);
+
+    __lambda__ void color_gamma_encode_batch(const float* linear, float* srgb, size_t n);
+    __lambda__ void color_gamma_decode_batch(const float* srgb, float* linear, size_t n);
+}
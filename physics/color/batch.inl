@@ -0,0 +1,395 @@
+/**
+ * Kernels of the batch color conversions, written in terms of `Lanes`,
+ *   included by `batch.cpp` once per instruction set, inside its own namespace.
+ *
+ * NOTE: no `#pragma once` here, and no floating point contraction is assumed,
+ *   all instruction sets perform the same operations in the same order.
+ */
+
+typedef Lanes::V V;
+typedef Lanes::M M;
+
+/*************************************************************************************************/
+static inline V k(float fl) { return Lanes::fill(fl); }
+static inline V add(V a, V b) { return Lanes::add(a, b); }
+static inline V sub(V a, V b) { return Lanes::sub(a, b); }
+static inline V mul(V a, V b) { return Lanes::mul(a, b); }
+static inline V div(V a, V b) { return Lanes::div(a, b); }
+static inline V select(M m, V a, V b) { return Lanes::select(m, a, b); }
+
+static inline V log2_of(V x) { // x > 0
+    V m;
+    V e = Lanes::exponent(x, &m);
+    M big = Lanes::lt(k(1.41421356F), m);
+    V t, t2, p;
+
+    m = select(big, mul(m, k(0.5F)), m);
+    e = select(big, add(e, k(1.0F)), e);
+
+    t = div(sub(m, k(1.0F)), add(m, k(1.0F))); // |t| <= 0.1716
+    t2 = mul(t, t);
+    p = k(1.0F / 9.0F);
+    p = add(mul(p, t2), k(1.0F / 7.0F));
+    p = add(mul(p, t2), k(1.0F / 5.0F));
+    p = add(mul(p, t2), k(1.0F / 3.0F));
+    p = add(mul(p, t2), k(1.0F));
+
+    return add(e, mul(mul(mul(t, p), k(2.0F)), k(1.44269504F)));
+}
+
+static inline V exp2_of(V y) {
+    V n, z, p;
+
+    y = Lanes::min(Lanes::max(y, k(-126.0F)), k(127.0F));
+    n = Lanes::floor(add(y, k(0.5F)));
+    z = mul(sub(y, n), k(0.69314718F)); // |z| <= 0.3466
+
+    p = k(1.0F / 5040.0F);
+    p = add(mul(p, z), k(1.0F / 720.0F));
+    p = add(mul(p, z), k(1.0F / 120.0F));
+    p = add(mul(p, z), k(1.0F / 24.0F));
+    p = add(mul(p, z), k(1.0F / 6.0F));
+    p = add(mul(p, z), k(0.5F));
+    p = add(mul(p, z), k(1.0F));
+    p = add(mul(p, z), k(1.0F));
+
+    return mul(p, Lanes::exp2i(n));
+}
+
+static inline V cos_of(V x) { // |x| <= 2.1
+    V x2 = mul(x, x);
+    V p = k(4.7794773e-14F);
+
+    p = sub(mul(p, x2), k(1.1470746e-11F));
+    p = add(mul(p, x2), k(2.0876757e-09F));
+    p = sub(mul(p, x2), k(2.7557319e-07F));
+    p = add(mul(p, x2), k(2.4801587e-05F));
+    p = sub(mul(p, x2), k(1.3888889e-03F));
+    p = add(mul(p, x2), k(4.1666668e-02F));
+    p = sub(mul(p, x2), k(0.5F));
+    p = add(mul(p, x2), k(1.0F));
+
+    return p;
+}
+
+static inline V atan2_of(V y, V x) {
+    // by the half-angle formula, tan(a/2) = tan(a) / (1 + sec(a)), three times
+    V t = div(y, add(Lanes::sqrt(add(mul(x, x), mul(y, y))), Lanes::abs(x)));
+    V t2, p, phi;
+
+    t = div(t, add(k(1.0F), Lanes::sqrt(add(k(1.0F), mul(t, t)))));
+    t = div(t, add(k(1.0F), Lanes::sqrt(add(k(1.0F), mul(t, t))))); // |t| <= tan(pi/16)
+    t2 = mul(t, t);
+
+    p = k(-1.0F / 11.0F);
+    p = add(mul(p, t2), k(1.0F / 9.0F));
+    p = sub(mul(p, t2), k(1.0F / 7.0F));
+    p = add(mul(p, t2), k(1.0F / 5.0F));
+    p = sub(mul(p, t2), k(1.0F / 3.0F));
+    p = add(mul(p, t2), k(1.0F));
+    phi = mul(mul(t, p), k(8.0F)); // atan2(y, |x|)
+
+    return select(Lanes::lt(x, k(0.0F)),
+                sub(select(Lanes::lt(y, k(0.0F)), k(-3.14159265F), k(3.14159265F)), phi),
+                phi);
+}
+
+/*************************************************************************************************/
+static inline V wrap_degrees(V deg) {
+    V w = sub(deg, mul(k(360.0F), Lanes::floor(mul(deg, k(1.0F / 360.0F)))));
+
+    return select(Lanes::lt(w, k(360.0F)), w, sub(w, k(360.0F)));
+}
+
+static inline V gamma_encode(V c) {
+    V a = Lanes::abs(c);
+    V sgn = select(Lanes::lt(c, k(0.0F)), k(-1.0F), k(1.0F));
+    V e = mul(sgn, sub(mul(exp2_of(mul(log2_of(a), k(1.0F / 2.4F))), k(1.055F)), k(0.055F)));
+
+    e = select(Lanes::le(a, k(0.0031308F)), mul(c, k(12.92F)), e);
+
+    return select(Lanes::unordered(c), c, e);
+}
+
+static inline V gamma_decode(V c) {
+    V a = Lanes::abs(c);
+    V sgn = select(Lanes::lt(c, k(0.0F)), k(-1.0F), k(1.0F));
+    V d = mul(sgn, exp2_of(mul(log2_of(div(add(a, k(0.055F)), k(1.055F))), k(2.4F))));
+
+    d = select(Lanes::le(a, k(0.04045F)), div(c, k(12.92F)), d);
+
+    return select(Lanes::unordered(c), c, d);
+}
+
+static inline V rgb_to_hue(V r, V g, V b, V* flM, V* flm, V* flchroma) {
+    V M = Lanes::max(Lanes::max(r, g), b);
+    V m = Lanes::min(Lanes::min(r, g), b);
+    V chroma = sub(M, m);
+    V hr = mul(k(60.0F), add(div(sub(g, b), chroma), select(Lanes::lt(g, b), k(6.0F), k(0.0F))));
+    V hg = mul(k(60.0F), add(div(sub(b, r), chroma), k(2.0F)));
+    V hb = mul(k(60.0F), add(div(sub(r, g), chroma), k(4.0F)));
+    V hue = select(Lanes::eq(M, g), hg, select(Lanes::eq(M, b), hb, hr));
+
+    (*flM) = M;
+    (*flm) = m;
+    (*flchroma) = chroma;
+
+    return select(Lanes::eq(chroma, k(0.0F)), k(flnan_f), hue);
+}
+
+static inline V rgb_from_hue(V hue_60, float n, V chroma, V m) {
+    V sector = add(hue_60, k(n));
+    V w;
+
+    sector = select(Lanes::lt(sector, k(6.0F)), sector, sub(sector, k(6.0F)));
+    w = Lanes::min(Lanes::min(sector, sub(k(4.0F), sector)), k(1.0F));
+    w = Lanes::max(w, k(0.0F));
+
+    return add(m, mul(chroma, sub(k(1.0F), w)));
+}
+
+static inline void feed_rgb_from_hue(V hue, V chroma, V m, V* rgb) {
+    V hue_60 = mul(wrap_degrees(hue), k(1.0F / 60.0F));
+    M achromatic = Lanes::unordered(hue);
+
+    rgb[0] = select(achromatic, m, rgb_from_hue(hue_60, 5.0F, chroma, m));
+    rgb[1] = select(achromatic, m, rgb_from_hue(hue_60, 3.0F, chroma, m));
+    rgb[2] = select(achromatic, m, rgb_from_hue(hue_60, 1.0F, chroma, m));
+}
+
+/*************************************************************************************************/
+struct RGBtoHSV {
+    void operator()(const V* rgb, V* hsv) const {
+        V M, m, chroma;
+
+        hsv[0] = rgb_to_hue(rgb[0], rgb[1], rgb[2], &M, &m, &chroma);
+        hsv[1] = select(Lanes::eq(M, k(0.0F)), k(0.0F), div(chroma, M));
+        hsv[2] = M;
+    }
+};
+
+struct HSVtoRGB {
+    void operator()(const V* hsv, V* rgb) const {
+        V chroma = mul(hsv[1], hsv[2]);
+
+        feed_rgb_from_hue(hsv[0], chroma, sub(hsv[2], chroma), rgb);
+    }
+};
+
+struct RGBtoHSL {
+    void operator()(const V* rgb, V* hsl) const {
+        V M, m, chroma;
+        V hue = rgb_to_hue(rgb[0], rgb[1], rgb[2], &M, &m, &chroma);
+        V lightness = mul(add(M, m), k(0.5F));
+        V abs_2L_1 = Lanes::abs(sub(mul(lightness, k(2.0F)), k(1.0F)));
+
+        hsl[0] = hue;
+        hsl[1] = select(Lanes::eq(abs_2L_1, k(1.0F)), k(0.0F), div(chroma, sub(k(1.0F), abs_2L_1)));
+        hsl[2] = lightness;
+    }
+};
+
+struct HSLtoRGB {
+    void operator()(const V* hsl, V* rgb) const {
+        V chroma = mul(hsl[1], sub(k(1.0F), Lanes::abs(sub(mul(hsl[2], k(2.0F)), k(1.0F)))));
+
+        feed_rgb_from_hue(hsl[0], chroma, sub(hsl[2], mul(chroma, k(0.5F))), rgb);
+    }
+};
+
+struct RGBtoHSI {
+    void operator()(const V* rgb, V* hsi) const {
+        V M, m, chroma;
+        V intensity = mul(add(add(rgb[0], rgb[1]), rgb[2]), k(1.0F / 3.0F));
+        V hue;
+
+        rgb_to_hue(rgb[0], rgb[1], rgb[2], &M, &m, &chroma);
+        hue = atan2_of(mul(sub(rgb[1], rgb[2]), k(1.73205081F)),
+                       sub(sub(mul(rgb[0], k(2.0F)), rgb[1]), rgb[2]));
+        hue = wrap_degrees(mul(hue, k(180.0F / 3.14159265F)));
+
+        hsi[0] = select(Lanes::eq(chroma, k(0.0F)), k(flnan_f), hue);
+        hsi[1] = select(Lanes::eq(intensity, k(0.0F)), k(0.0F), sub(k(1.0F), div(m, intensity)));
+        hsi[2] = intensity;
+    }
+};
+
+struct HSItoRGB {
+    void operator()(const V* hsi, V* rgb) const {
+        V hue = wrap_degrees(hsi[0]);
+        V sector = Lanes::min(Lanes::floor(mul(hue, k(1.0F / 120.0F))), k(2.0F));
+        V H = mul(sub(hue, mul(sector, k(120.0F))), k(3.14159265F / 180.0F));
+        V cosH_60H = div(cos_of(H), cos_of(sub(k(3.14159265F / 3.0F), H)));
+        V major = mul(hsi[2], add(k(1.0F), mul(hsi[1], cosH_60H)));
+        V midor = mul(hsi[2], sub(k(1.0F), hsi[1]));
+        V minor = sub(mul(hsi[2], k(3.0F)), add(major, midor));
+        M r_major = Lanes::eq(sector, k(0.0F));
+        M g_major = Lanes::eq(sector, k(1.0F));
+        M gray = Lanes::either(Lanes::eq(hsi[1], k(0.0F)), Lanes::unordered(hsi[0]));
+
+        rgb[0] = select(gray, hsi[2], select(r_major, major, select(g_major, midor, minor)));
+        rgb[1] = select(gray, hsi[2], select(r_major, minor, select(g_major, major, midor)));
+        rgb[2] = select(gray, hsi[2], select(r_major, midor, select(g_major, minor, major)));
+    }
+};
+
+struct LinearTransform {
+    void operator()(const V* src, V* dst) const {
+        for (size_t i = 0; i < 3; i ++) {
+            dst[i] = add(add(mul(k(this->matrix[i * 3 + 0]), src[0]),
+                             mul(k(this->matrix[i * 3 + 1]), src[1])),
+                             mul(k(this->matrix[i * 3 + 2]), src[2]));
+        }
+    }
+
+    const float* matrix;
+};
+
+struct XYZtoRGB {
+    void operator()(const V* XYZ, V* RGB) const {
+        V L;
+
+        LinearTransform { this->matrix } (XYZ, RGB);
+        L = Lanes::max(Lanes::max(RGB[0], RGB[1]), RGB[2]);
+
+        for (size_t i = 0; i < 3; i ++) {
+            RGB[i] = div(RGB[i], L);
+
+            if (this->gamma) {
+                RGB[i] = gamma_encode(RGB[i]);
+            }
+        }
+    }
+
+    const float* matrix;
+    bool gamma;
+};
+
+struct RGBtoXYZ {
+    void operator()(const V* RGB, V* XYZ) const {
+        if (this->gamma) {
+            V linear[3] = { gamma_decode(RGB[0]), gamma_decode(RGB[1]), gamma_decode(RGB[2]) };
+
+            LinearTransform { this->matrix } (linear, XYZ);
+        } else {
+            LinearTransform { this->matrix } (RGB, XYZ);
+        }
+    }
+
+    const float* matrix;
+    bool gamma;
+};
+
+struct xyYtoXYZ {
+    void operator()(const V* xy, V* XYZ) const {
+        V z = sub(sub(k(1.0F), xy[0]), xy[1]);
+        V L = k(this->luminance);
+
+        XYZ[0] = div(mul(L, xy[0]), xy[1]);
+        XYZ[1] = L;
+        XYZ[2] = div(mul(L, z), xy[1]);
+    }
+
+    float luminance;
+};
+
+struct XYZtoxyY {
+    void operator()(const V* XYZ, V* xy) const {
+        V L = add(add(XYZ[0], XYZ[1]), XYZ[2]);
+
+        xy[0] = div(XYZ[0], L);
+        xy[1] = div(XYZ[1], L);
+    }
+};
+
+struct GammaEncode {
+    void operator()(const V* src, V* dst) const { dst[0] = gamma_encode(src[0]); }
+};
+
+struct GammaDecode {
+    void operator()(const V* src, V* dst) const { dst[0] = gamma_decode(src[0]); }
+};
+
+/*************************************************************************************************/
+template<typename Op, size_t Nin, size_t Nout>
+static void map_lanes(const Op& op, const float* const (&src)[Nin], float* const (&dst)[Nout], size_t n) {
+    V in[Nin];
+    V out[Nout];
+    size_t idx = 0U;
+
+    for (; idx + Lanes::width <= n; idx += Lanes::width) {
+        for (size_t i = 0; i < Nin; i ++) in[i] = Lanes::load(src[i] + idx);
+        op(in, out);
+        for (size_t i = 0; i < Nout; i ++) Lanes::store(dst[i] + idx, out[i]);
+    }
+
+    if (idx < n) { // the rest goes through padded lanes, to keep the same results
+        float pad[Nin + Nout][Lanes::width] = {};
+        size_t rest = n - idx;
+
+        for (size_t i = 0; i < Nin; i ++) {
+            for (size_t j = 0; j < rest; j ++) pad[i][j] = src[i][idx + j];
+            in[i] = Lanes::load(pad[i]);
+        }
+
+        op(in, out);
+
+        for (size_t i = 0; i < Nout; i ++) {
+            Lanes::store(pad[Nin + i], out[i]);
+            for (size_t j = 0; j < rest; j ++) dst[i][idx + j] = pad[Nin + i][j];
+        }
+    }
+}
+
+static void rgb_to_hsv(const float* r, const float* g, const float* b, float* h, float* s, float* v, size_t n) {
+    map_lanes(RGBtoHSV(), { r, g, b }, { h, s, v }, n);
+}
+
+static void hsv_to_rgb(const float* h, const float* s, const float* v, float* r, float* g, float* b, size_t n) {
+    map_lanes(HSVtoRGB(), { h, s, v }, { r, g, b }, n);
+}
+
+static void rgb_to_hsl(const float* r, const float* g, const float* b, float* h, float* s, float* l, size_t n) {
+    map_lanes(RGBtoHSL(), { r, g, b }, { h, s, l }, n);
+}
+
+static void hsl_to_rgb(const float* h, const float* s, const float* l, float* r, float* g, float* b, size_t n) {
+    map_lanes(HSLtoRGB(), { h, s, l }, { r, g, b }, n);
+}
+
+static void rgb_to_hsi(const float* r, const float* g, const float* b, float* h, float* s, float* i, size_t n) {
+    map_lanes(RGBtoHSI(), { r, g, b }, { h, s, i }, n);
+}
+
+static void hsi_to_rgb(const float* h, const float* s, const float* i, float* r, float* g, float* b, size_t n) {
+    map_lanes(HSItoRGB(), { h, s, i }, { r, g, b }, n);
+}
+
+static void xyz_to_rgb(const float* matrix, bool gamma, const float* X, const float* Y, const float* Z, float* R, float* G, float* B, size_t n) {
+    map_lanes(XYZtoRGB { matrix, gamma }, { X, Y, Z }, { R, G, B }, n);
+}
+
+static void rgb_to_xyz(const float* matrix, bool gamma, const float* R, const float* G, const float* B, float* X, float* Y, float* Z, size_t n) {
+    map_lanes(RGBtoXYZ { matrix, gamma }, { R, G, B }, { X, Y, Z }, n);
+}
+
+static void xyy_to_xyz(const float* x, const float* y, float* X, float* Y, float* Z, size_t n, float L) {
+    map_lanes(xyYtoXYZ { L }, { x, y }, { X, Y, Z }, n);
+}
+
+static void xyz_to_xyy(const float* X, const float* Y, const float* Z, float* x, float* y, size_t n) {
+    map_lanes(XYZtoxyY(), { X, Y, Z }, { x, y }, n);
+}
+
+static void gamma_encode(const float* src, float* dst, size_t n) {
+    map_lanes(GammaEncode(), { src }, { dst }, n);
+}
+
+static void gamma_decode(const float* src, float* dst, size_t n) {
+    map_lanes(GammaDecode(), { src }, { dst }, n);
+}
+
+static const ColorBatchKernels kernels = {
+    rgb_to_hsv, hsv_to_rgb, rgb_to_hsl, hsl_to_rgb, rgb_to_hsi, hsi_to_rgb,
+    xyz_to_rgb, rgb_to_xyz, xyy_to_xyz, xyz_to_xyy, gamma_encode, gamma_decode
+};
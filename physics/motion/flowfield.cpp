@@ -0,0 +1,351 @@
+#include "flowfield.hpp"
+
+#include "../../datum/box.hpp"
+#include "../../datum/flonum.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+using namespace Plteen;
+
+/*************************************************************************************************/
+namespace {
+    static const float diagonal_cost = 1.41421356F;
+    static const float infinity = std::numeric_limits<float>::infinity();
+    static const uint8_t flow_none = 0xFFU;
+
+    // E, S, W, N, ES, WS, WN, EN, the same as `GridPathfinder`'s, `y` goes down
+    static const int drs[] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+    static const int dcs[] = { 1, 0, -1, 0, 1, -1, -1, 1 };
+    static const double flow_radians[] = { 0.0, h_pi, pi, -h_pi, q_pi, q_pi * 3.0, -q_pi * 3.0, -q_pi };
+
+    typedef std::greater<std::pair<float, int>> OpenOrder;
+}
+
+/*************************************************************************************************/
+float Plteen::FlowField::unreachable() {
+    return infinity;
+}
+
+Plteen::FlowField::FlowField(const PassabilityGrid* grid, bool diagonal) : grid(grid), diagonal(diagonal) {}
+
+void Plteen::FlowField::set_goal(int tile) {
+    this->goals.assign(1, tile);
+    this->dirty = true;
+}
+
+void Plteen::FlowField::set_goal(int row, int col) {
+    this->set_goal(row * this->grid->column_count() + col);
+}
+
+void Plteen::FlowField::set_goals(const std::vector<int>& tiles) {
+    this->goals = tiles;
+    this->dirty = true;
+}
+
+void Plteen::FlowField::update() {
+    uint64_t revision = this->grid->revision();
+
+    if (this->dirty || (revision != this->revision)) {
+        std::vector<int> changes;
+        bool incremental = (!this->dirty)
+                            && (this->row == this->grid->row_count()) && (this->col == this->grid->column_count())
+                            && this->grid->feed_changes(this->revision, &changes);
+
+        this->revision = revision;
+        this->dirty = false;
+
+        if (incremental) {
+            this->repair(changes);
+        } else {
+            this->integrate();
+        }
+    }
+}
+
+/*************************************************************************************************/
+float Plteen::FlowField::integration(int tile) const {
+    return ((tile >= 0) && (size_t(tile) < this->costs.size())) ? this->costs[tile] : infinity;
+}
+
+int Plteen::FlowField::next_tile(int tile) const {
+    int next = -1;
+
+    if ((tile >= 0) && (size_t(tile) < this->flows.size())) {
+        uint8_t d = this->flows[tile];
+
+        if (d != flow_none) {
+            next = tile + drs[d] * this->col + dcs[d];
+        }
+    }
+
+    return next;
+}
+
+bool Plteen::FlowField::steer(int tile, double* direction_rad, double* dx, double* dy) const {
+    bool okay = false;
+
+    if ((tile >= 0) && (size_t(tile) < this->flows.size())) {
+        uint8_t d = this->flows[tile];
+
+        if (d != flow_none) {
+            double unit = (d < 4) ? 1.0 : 0.7071067811865476;
+
+            SET_BOX(direction_rad, flow_radians[d]);
+            SET_BOX(dx, double(dcs[d]) * unit);
+            SET_BOX(dy, double(drs[d]) * unit);
+            okay = true;
+        }
+    }
+
+    return okay;
+}
+
+bool Plteen::FlowField::steer(IMovable* agent, int tile, double speed) const {
+    double rad = 0.0;
+    bool okay = this->steer(tile, &rad);
+
+    // heading events of `I8WayMotion`s are dispatched by the agent itself
+    if (okay) {
+        agent->set_velocity(speed, rad, true);
+    }
+
+    return okay;
+}
+
+/*************************************************************************************************/
+void Plteen::FlowField::integrate() {
+    size_t n = size_t(this->grid->tile_count());
+
+    this->row = this->grid->row_count();
+    this->col = this->grid->column_count();
+    this->costs.assign(n, infinity);
+    this->flows.assign(n, flow_none);
+    this->stamps.assign(n, 0U);
+    this->stamp = 0U;
+    this->open.clear();
+
+    for (int goal : this->goals) {
+        if (this->grid->is_passable(goal)) {
+            this->costs[goal] = 0.0F;
+            this->open.push_back({ 0.0F, goal });
+        }
+    }
+
+    std::make_heap(this->open.begin(), this->open.end(), OpenOrder());
+    this->propagate();
+    this->touched.clear();
+
+    for (size_t idx = 0U; idx < n; idx ++) {
+        this->reflow(int(idx));
+    }
+}
+
+void Plteen::FlowField::repair(const std::vector<int>& changes) {
+    std::vector<int> affected;
+    int n = (this->diagonal ? 8 : 4);
+
+    this->stamp ++;
+
+    if (this->stamp == 0U) {
+        std::fill(this->stamps.begin(), this->stamps.end(), 0U);
+        this->stamp = 1U;
+    }
+
+    /**
+     * Invalidation, costs supported only by invalidated tiles are invalidated as well.
+     * Candidates are decided in the order of their costs, supporters are cheaper,
+     *   so that they have been decided before the tiles they support.
+     */
+    this->open.clear();
+
+    for (int tile : changes) {
+        if (!this->grid->is_passable(tile) && (this->stamps[tile] != this->stamp)) {
+            this->stamps[tile] = this->stamp;
+            affected.push_back(tile);
+
+            // including those whose diagonal moves go around the blocked corner
+            for (int d = 0; d < 8; d ++) {
+                int r = tile / this->col + drs[d];
+                int c = tile % this->col + dcs[d];
+
+                if (this->grid->is_passable(r, c) && (this->costs[r * this->col + c] < infinity)) {
+                    this->open.push_back({ this->costs[r * this->col + c], r * this->col + c });
+                    std::push_heap(this->open.begin(), this->open.end(), OpenOrder());
+                }
+            }
+        }
+    }
+
+    while (!this->open.empty()) {
+        std::pop_heap(this->open.begin(), this->open.end(), OpenOrder());
+        int tile = this->open.back().second;
+        float cost = this->costs[tile];
+        int r = tile / this->col;
+        int c = tile % this->col;
+        bool supported = (cost == 0.0F);
+
+        this->open.pop_back();
+
+        if (this->stamps[tile] == this->stamp) continue;
+
+        for (int d = 0; (!supported) && (d < n); d ++) {
+            if (this->steppable(r, c, drs[d], dcs[d])) {
+                int next = tile + drs[d] * this->col + dcs[d];
+
+                supported = (this->stamps[next] != this->stamp)
+                            && (this->costs[next] + ((d < 4) ? 1.0F : diagonal_cost) == cost);
+            }
+        }
+
+        if (!supported) {
+            this->stamps[tile] = this->stamp;
+            affected.push_back(tile);
+
+            for (int d = 0; d < n; d ++) {
+                if (this->steppable(r, c, drs[d], dcs[d])) {
+                    int next = tile + drs[d] * this->col + dcs[d];
+
+                    if ((this->stamps[next] != this->stamp) && (this->costs[next] < infinity)) {
+                        this->open.push_back({ this->costs[next], next });
+                        std::push_heap(this->open.begin(), this->open.end(), OpenOrder());
+                    }
+                }
+            }
+        }
+    }
+
+    for (int tile : affected) {
+        this->costs[tile] = infinity;
+    }
+
+    // seeds, from the valid neighbors of the invalidated and the newly opened tiles
+    this->touched = affected;
+    this->touched.insert(this->touched.end(), changes.begin(), changes.end());
+
+    for (int tile : this->touched) {
+        if (this->grid->is_passable(tile)) {
+            int r = tile / this->col;
+            int c = tile % this->col;
+            float best = this->costs[tile];
+
+            if (std::find(this->goals.begin(), this->goals.end(), tile) != this->goals.end()) {
+                best = 0.0F;
+            }
+
+            for (int d = 0; d < n; d ++) {
+                if (this->steppable(r, c, drs[d], dcs[d])) {
+                    int next = tile + drs[d] * this->col + dcs[d];
+
+                    best = std::min(best, this->costs[next] + ((d < 4) ? 1.0F : diagonal_cost));
+                }
+            }
+
+            if (best < this->costs[tile]) {
+                this->costs[tile] = best;
+            }
+
+            if (this->costs[tile] < infinity) {
+                this->open.push_back({ this->costs[tile], tile });
+            }
+        }
+    }
+
+    // opened tiles also open the diagonal moves around them
+    for (int tile : changes) {
+        if (this->grid->is_passable(tile)) {
+            for (int d = 0; d < 4; d ++) {
+                int r = tile / this->col + drs[d];
+                int c = tile % this->col + dcs[d];
+
+                if (this->grid->is_passable(r, c) && (this->costs[r * this->col + c] < infinity)) {
+                    this->open.push_back({ this->costs[r * this->col + c], r * this->col + c });
+                }
+            }
+        }
+    }
+
+    std::make_heap(this->open.begin(), this->open.end(), OpenOrder());
+    this->propagate();
+
+    for (int tile : this->touched) {
+        int r = tile / this->col;
+        int c = tile % this->col;
+
+        this->reflow(tile);
+
+        for (int d = 0; d < 8; d ++) {
+            if (this->grid->is_passable(r + drs[d], c + dcs[d])) {
+                this->reflow(tile + drs[d] * this->col + dcs[d]);
+            }
+        }
+    }
+
+    this->touched.clear();
+}
+
+void Plteen::FlowField::propagate() {
+    int n = (this->diagonal ? 8 : 4);
+
+    while (!this->open.empty()) {
+        std::pop_heap(this->open.begin(), this->open.end(), OpenOrder());
+        std::pair<float, int> top = this->open.back();
+        int r = top.second / this->col;
+        int c = top.second % this->col;
+
+        this->open.pop_back();
+
+        if (top.first > this->costs[top.second]) continue;
+
+        for (int d = 0; d < n; d ++) {
+            if (this->steppable(r, c, drs[d], dcs[d])) {
+                int next = top.second + drs[d] * this->col + dcs[d];
+                float cost = top.first + ((d < 4) ? 1.0F : diagonal_cost);
+
+                if (cost < this->costs[next]) {
+                    this->costs[next] = cost;
+                    this->open.push_back({ cost, next });
+                    std::push_heap(this->open.begin(), this->open.end(), OpenOrder());
+                    this->touched.push_back(next);
+                }
+            }
+        }
+    }
+}
+
+void Plteen::FlowField::reflow(int tile) {
+    uint8_t flow = flow_none;
+    float cost = this->costs[tile];
+
+    if ((cost > 0.0F) && (cost < infinity)) {
+        int r = tile / this->col;
+        int c = tile % this->col;
+        int n = (this->diagonal ? 8 : 4);
+        float best = infinity;
+
+        // orthogonal moves win ties
+        for (int d = 0; d < n; d ++) {
+            if (this->steppable(r, c, drs[d], dcs[d])) {
+                float v = this->costs[tile + drs[d] * this->col + dcs[d]] + ((d < 4) ? 1.0F : diagonal_cost);
+
+                if (v < best) {
+                    best = v;
+                    flow = uint8_t(d);
+                }
+            }
+        }
+    }
+
+    this->flows[tile] = flow;
+}
+
+bool Plteen::FlowField::steppable(int r, int c, int dr, int dc) const {
+    bool okay = this->grid->is_passable(r + dr, c + dc);
+
+    if (okay && (dr != 0) && (dc != 0)) {
+        okay = this->grid->is_passable(r + dr, c) && this->grid->is_passable(r, c + dc);
+    }
+
+    return okay;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "../motion.hpp"
+#include "passability.hpp"
+
+#include <vector>
+#include <cstdint>
+
+namespace Plteen {
+    /**
+     * Dijkstra maps for crowds, one integration field per goal (or goal set),
+     *   every agent steers by looking up its tile, no per-agent search.
+     *
+     * Tiles are indexed in row-major order, as `GridAtlas` does,
+     *   moves and their costs are the same as `GridPathfinder`'s.
+     *
+     * Changes of the grid are caught up incrementally in `update`:
+     *   costs that depended on newly blocked tiles are invalidated and repaired from their valid neighbors,
+     *   newly opened tiles are integrated from their neighbors,
+     *   and only the touched tiles get their flows recomputed.
+     */
+    class __lambda__ FlowField {
+    public:
+        FlowField(const Plteen::PassabilityGrid* grid, bool diagonal = true);
+        virtual ~FlowField() {}
+
+    public:
+        void set_goal(int tile);
+        void set_goal(int row, int col);
+        void set_goals(const std::vector<int>& tiles);
+        const std::vector<int>& get_goals() const { return this->goals; }
+        void update(); // returns immediately if nothing has changed
+
+    public:
+        float integration(int tile) const;
+        bool is_reachable(int tile) const { return this->integration(tile) < this->unreachable(); }
+        int next_tile(int tile) const; // -1 for goals and unreachable tiles
+        bool steer(int tile, double* direction_rad, double* dx = nullptr, double* dy = nullptr) const;
+        bool steer(Plteen::IMovable* agent, int tile, double speed) const;
+
+    public:
+        static float unreachable();
+
+    private:
+        void integrate();
+        void repair(const std::vector<int>& changes);
+        void propagate();
+        void reflow(int tile);
+        bool steppable(int r, int c, int dr, int dc) const;
+
+    private:
+        const Plteen::PassabilityGrid* grid;
+        uint64_t revision = 0U;
+        bool diagonal;
+        int row = 0;
+        int col = 0;
+
+    private:
+        std::vector<int> goals;
+        std::vector<float> costs;
+        std::vector<uint8_t> flows;     // into the 8 neighbors
+        std::vector<uint32_t> stamps;   // scratch for repairing
+        uint32_t stamp = 0U;
+        bool dirty = true;
+
+    private:
+        std::vector<std::pair<float, int>> open;
+        std::vector<int> touched;
+    };
+}
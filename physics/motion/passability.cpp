@@ -0,0 +1,54 @@
+#include "passability.hpp"
+
+using namespace Plteen;
+
+/*************************************************************************************************/
+static const size_t passability_log_capacity = 4096U;
+
+/*************************************************************************************************/
+void Plteen::PassabilityGrid::reset(int row, int col, bool passable) {
+    this->row = (row > 0) ? row : 0;
+    this->col = (col > 0) ? col : 0;
+    this->stride = (size_t(this->col) + 63U) >> 6U;
+    this->bits.assign(this->stride * size_t(this->row), 0U);
+
+    if (passable) {
+        for (int r = 0; r < this->row; ++ r) {
+            for (int c = 0; c < this->col; ++ c) {
+                this->bits[size_t(r) * this->stride + (size_t(c) >> 6U)] |= (uint64_t(1U) << (size_t(c) & 63U));
+            }
+        }
+    }
+
+    this->rev ++;
+    this->log_base = this->rev;
+    this->log.clear();
+}
+
+void Plteen::PassabilityGrid::set_passable(int row, int col, bool yes) {
+    if ((row >= 0) && (col >= 0) && (row < this->row) && (col < this->col)) {
+        if (this->is_passable(row, col) != yes) {
+            uint64_t& word = this->bits[size_t(row) * this->stride + (size_t(col) >> 6U)];
+
+            word ^= (uint64_t(1U) << (size_t(col) & 63U));
+
+            if (this->log.size() >= passability_log_capacity) {
+                this->log_base = this->rev;
+                this->log.clear();
+            }
+
+            this->rev ++;
+            this->log.push_back(row * this->col + col);
+        }
+    }
+}
+
+bool Plteen::PassabilityGrid::feed_changes(uint64_t since, std::vector<int>* tiles) const {
+    bool okay = (since >= this->log_base);
+
+    if (okay && (since < this->rev)) {
+        tiles->insert(tiles->end(), this->log.begin() + std::ptrdiff_t(since - this->log_base), this->log.end());
+    }
+
+    return okay;
+}
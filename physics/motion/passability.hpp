@@ -0,0 +1,48 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Plteen {
+    /**
+     * Passable tiles of a map, one bit per tile, rows are padded to 64-bit words.
+     *
+     * Changes are logged with revisions, so that planners could catch up with only the changed tiles,
+     *   those that fall behind the log, or a reset, have to rebuild everything.
+     */
+    class __lambda__ PassabilityGrid {
+    public:
+        PassabilityGrid(int row = 0, int col = 0, bool passable = true) { this->reset(row, col, passable); }
+
+    public:
+        void reset(int row, int col, bool passable = true);
+        int row_count() const { return this->row; }
+        int column_count() const { return this->col; }
+        int tile_count() const { return this->row * this->col; }
+
+    public:
+        bool is_passable(int row, int col) const {
+            return (row >= 0) && (col >= 0) && (row < this->row) && (col < this->col)
+                    && ((this->bits[size_t(row) * this->stride + (size_t(col) >> 6U)] >> (size_t(col) & 63U)) & 1U);
+        }
+
+        bool is_passable(int idx) const { return (this->col > 0) && (idx >= 0) && this->is_passable(idx / this->col, idx % this->col); }
+        void set_passable(int row, int col, bool yes);
+
+    public:
+        uint64_t revision() const { return this->rev; }
+        bool feed_changes(uint64_t since, std::vector<int>* tiles) const; // `false` if it's too late to tell
+
+    private:
+        int row = 0;
+        int col = 0;
+        size_t stride = 0U;
+        std::vector<uint64_t> bits;
+
+    private:
+        uint64_t rev = 0U;
+        uint64_t log_base = 0U; // the revision before the first logged change
+        std::vector<int> log;
+    };
+}
@@ -0,0 +1,856 @@
+#include "pathfinder.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <limits>
+
+using namespace Plteen;
+
+/*************************************************************************************************/
+namespace {
+    static const float diagonal_cost = 1.41421356F;
+    static const float infinity = std::numeric_limits<float>::infinity();
+
+    // E, S, W, N, ES, WS, WN, EN
+    static const int drs[] = { 0, 1, 0, -1, 1, 1, -1, -1 };
+    static const int dcs[] = { 1, 0, -1, 0, 1, -1, -1, 1 };
+
+    /* entrances of a border run that is shorter than this have only one crossing in the middle */
+    static const int entrance_span = 6;
+
+    template<typename N>
+    struct OpenOrder {
+        // the best is on top, and the deeper one breaks ties, which reaches the goal earlier
+        bool operator()(const N& lhs, const N& rhs) const {
+            return (lhs.f > rhs.f) || ((lhs.f == rhs.f) && (lhs.g < rhs.g));
+        }
+    };
+
+    static inline int sign(int n) {
+        return (n > 0) - (n < 0);
+    }
+}
+
+/*************************************************************************************************/
+Plteen::GridPathfinder::GridPathfinder(const PassabilityGrid* grid, bool diagonal, int cluster_size)
+    : grid(grid), diagonal(diagonal), csize(std::max(cluster_size, 4)) {}
+
+bool Plteen::GridPathfinder::find_path(int from_row, int from_col, int to_row, int to_col, std::vector<int>* path, PathAlgorithm algorithm) {
+    int col = this->grid->column_count();
+
+    if ((from_col < 0) || (from_col >= col) || (to_col < 0) || (to_col >= col)) {
+        path->clear();
+        return false;
+    }
+
+    return this->find_path(from_row * col + from_col, to_row * col + to_col, path, algorithm);
+}
+
+bool Plteen::GridPathfinder::find_path(int from, int to, std::vector<int>* path, PathAlgorithm algorithm) {
+    size_t work = 0U;
+    bool okay = false;
+
+    this->synchronize();
+    path->clear();
+
+    // the scratch is shared, the interrupted request will restart later
+    if (this->search.ticket > 0U) {
+        this->queue.push_front(this->search.ticket);
+        this->search.ticket = 0U;
+    }
+
+    if (this->grid->is_passable(from) && this->grid->is_passable(to)) {
+        if (from == to) {
+            path->push_back(from);
+            okay = true;
+        } else if (algorithm == PathAlgorithm::HPA) {
+            okay = this->find_hierarchical_path(from, to, path, &work);
+        } else {
+            okay = this->search_path(from, to, (algorithm == PathAlgorithm::JPS) && this->diagonal,
+                        { 0, 0, this->row - 1, this->col - 1 }, path, &work);
+        }
+    }
+
+    return okay;
+}
+
+/*************************************************************************************************/
+uint32_t Plteen::GridPathfinder::request_path(int from, int to, PathAlgorithm algorithm) {
+    uint32_t ticket = this->next_ticket ++;
+
+    if (this->next_ticket == 0U) {
+        this->next_ticket = 1U;
+    }
+
+    this->tickets[ticket] = { from, to, from, algorithm, PathStatus::Pending, {} };
+    this->queue.push_back(ticket);
+
+    return ticket;
+}
+
+PathStatus Plteen::GridPathfinder::poll_path(uint32_t ticket, std::vector<int>* path) {
+    PathStatus status = PathStatus::Unknown;
+    auto it = this->tickets.end();
+
+    // found paths might have been blocked
+    this->synchronize();
+    it = this->tickets.find(ticket);
+
+    if (it != this->tickets.end()) {
+        status = it->second.status;
+
+        if ((status == PathStatus::Found) && (path != nullptr)) {
+            (*path) = it->second.path;
+        }
+    }
+
+    return status;
+}
+
+void Plteen::GridPathfinder::follow_path(uint32_t ticket, int tile) {
+    auto it = this->tickets.find(ticket);
+
+    if (it != this->tickets.end()) {
+        it->second.current = tile;
+    }
+}
+
+void Plteen::GridPathfinder::release_path(uint32_t ticket) {
+    // the ticket in the queue will be skipped
+    this->tickets.erase(ticket);
+
+    if (this->search.ticket == ticket) {
+        this->search.ticket = 0U;
+    }
+}
+
+size_t Plteen::GridPathfinder::pending_count() {
+    this->synchronize();
+
+    return this->queue.size() + ((this->search.ticket > 0U) ? 1U : 0U);
+}
+
+size_t Plteen::GridPathfinder::update(size_t budget) {
+    size_t remaining = budget;
+
+    this->synchronize();
+
+    while (remaining > 0U) {
+        if (this->search.ticket == 0U) {
+            if (this->queue.empty()) break;
+
+            uint32_t id = this->queue.front();
+            auto it = this->tickets.find(id);
+
+            this->queue.pop_front();
+
+            if ((it == this->tickets.end()) || (it->second.status != PathStatus::Pending)) continue;
+
+            Ticket& t = it->second;
+
+            t.path.clear();
+
+            if (!(this->grid->is_passable(t.from) && this->grid->is_passable(t.to))) {
+                t.status = PathStatus::Unreachable;
+            } else if (t.from == t.to) {
+                t.path.push_back(t.from);
+                t.status = PathStatus::Found;
+            } else if (t.algorithm == PathAlgorithm::HPA) {
+                size_t work = 1U;
+
+                // not preemptible, but the abstract graph keeps it short
+                t.status = this->find_hierarchical_path(t.from, t.to, &t.path, &work) ? PathStatus::Found : PathStatus::Unreachable;
+                remaining -= std::min(remaining, work);
+            } else {
+                this->begin_search(&this->search, t.from, t.to, (t.algorithm == PathAlgorithm::JPS) && this->diagonal,
+                    { 0, 0, this->row - 1, this->col - 1 });
+                this->search.ticket = id;
+            }
+        } else {
+            int status = this->continue_search(&this->search, &remaining);
+
+            if (status != 0) {
+                Ticket& t = this->tickets[this->search.ticket];
+
+                if (status > 0) {
+                    this->trace_path(t.from, t.to, &t.path);
+                    t.status = PathStatus::Found;
+                } else {
+                    t.status = PathStatus::Unreachable;
+                }
+
+                this->search.ticket = 0U;
+            }
+        }
+    }
+
+    return budget - remaining;
+}
+
+/*************************************************************************************************/
+void Plteen::GridPathfinder::synchronize() {
+    uint64_t revision = this->grid->revision();
+
+    if (revision != this->revision) {
+        std::vector<int> changes;
+        bool incremental = (this->row == this->grid->row_count()) && (this->col == this->grid->column_count())
+                            && this->grid->feed_changes(this->revision, &changes);
+
+        this->revision = revision;
+
+        if (incremental) {
+            if (this->abstraction_okay) {
+                this->rebuild_abstraction(&changes);
+            }
+
+            this->replan_tickets(changes);
+        } else {
+            size_t n = size_t(this->grid->tile_count());
+
+            this->row = this->grid->row_count();
+            this->col = this->grid->column_count();
+            this->g.assign(n, infinity);
+            this->parent.assign(n, -1);
+            this->seen.assign(n, 0U);
+            this->closed.assign(n, 0U);
+            this->generation = 0U;
+            this->abstraction_okay = false;
+            this->clusters.clear();
+            this->nodes.clear();
+            this->node_indices.clear();
+
+            if (this->search.ticket > 0U) {
+                this->queue.push_front(this->search.ticket);
+                this->search.ticket = 0U;
+            }
+
+            for (auto& it : this->tickets) {
+                if (it.second.status != PathStatus::Pending) {
+                    it.second.status = PathStatus::Pending;
+                    it.second.from = it.second.current;
+                    this->queue.push_back(it.first);
+                }
+            }
+        }
+    }
+}
+
+void Plteen::GridPathfinder::replan_tickets(const std::vector<int>& changes) {
+    std::vector<int> blocked;
+    bool opened = false;
+
+    for (int tile : changes) {
+        if (this->grid->is_passable(tile)) {
+            opened = true;
+        } else {
+            blocked.push_back(tile);
+        }
+    }
+
+    std::sort(blocked.begin(), blocked.end());
+
+    // the ongoing search may have seen the old tiles
+    if ((this->search.ticket > 0U) && !changes.empty()) {
+        this->queue.push_front(this->search.ticket);
+        this->search.ticket = 0U;
+    }
+
+    for (auto& it : this->tickets) {
+        Ticket& t = it.second;
+        bool stale = false;
+
+        if (t.status == PathStatus::Found) {
+            if (!blocked.empty()) {
+                auto rest = std::find(t.path.begin(), t.path.end(), t.current);
+
+                if (rest == t.path.end()) {
+                    rest = t.path.begin();
+                }
+
+                for (; (!stale) && (rest != t.path.end()); ++ rest) {
+                    stale = std::binary_search(blocked.begin(), blocked.end(), *rest);
+
+                    // the corners of diagonal steps
+                    if ((!stale) && (rest + 1 != t.path.end())) {
+                        int r = (*rest) / this->col;
+                        int c = (*rest) % this->col;
+                        int dr = (*(rest + 1)) / this->col - r;
+                        int dc = (*(rest + 1)) % this->col - c;
+
+                        if ((dr != 0) && (dc != 0)) {
+                            stale = std::binary_search(blocked.begin(), blocked.end(), (r + dr) * this->col + c)
+                                    || std::binary_search(blocked.begin(), blocked.end(), r * this->col + c + dc);
+                        }
+                    }
+                }
+            }
+        } else if (t.status == PathStatus::Unreachable) {
+            stale = opened;
+        }
+
+        if (stale) {
+            t.status = PathStatus::Pending;
+            t.from = t.current;
+            this->queue.push_back(it.first);
+        }
+    }
+}
+
+bool Plteen::GridPathfinder::steppable(int r, int c, int dr, int dc, const Bounds& bounds) const {
+    int nr = r + dr;
+    int nc = c + dc;
+    bool okay = false;
+
+    if ((nr >= bounds.r0) && (nr <= bounds.r1) && (nc >= bounds.c0) && (nc <= bounds.c1) && this->walkable(nr, nc)) {
+        okay = ((dr == 0) || (dc == 0) || (this->walkable(nr, c) && this->walkable(r, nc)));
+    }
+
+    return okay;
+}
+
+float Plteen::GridPathfinder::heuristic(int from, int to) const {
+    int dr = std::abs(from / this->col - to / this->col);
+    int dc = std::abs(from % this->col - to % this->col);
+    float h = float(dr + dc);
+
+    if (this->diagonal) { // octile
+        h += (diagonal_cost - 2.0F) * float(std::min(dr, dc));
+    }
+
+    return h;
+}
+
+/*************************************************************************************************/
+void Plteen::GridPathfinder::begin_search(Search* s, int from, int to, bool jump, const Bounds& bounds) {
+    this->generation ++;
+
+    if (this->generation == 0U) {
+        std::fill(this->seen.begin(), this->seen.end(), 0U);
+        std::fill(this->closed.begin(), this->closed.end(), 0U);
+        this->generation = 1U;
+    }
+
+    s->from = from;
+    s->to = to;
+    s->jump = jump;
+    s->bounds = bounds;
+    s->open.clear();
+
+    this->seen[from] = this->generation;
+    this->g[from] = 0.0F;
+    this->parent[from] = from;
+    s->open.push_back({ this->heuristic(from, to), 0.0F, from });
+}
+
+int Plteen::GridPathfinder::continue_search(Search* s, size_t* budget) {
+    OpenOrder<OpenNode> order;
+
+    while (!s->open.empty()) {
+        if ((*budget) == 0U) return 0;
+
+        std::pop_heap(s->open.begin(), s->open.end(), order);
+        OpenNode node = s->open.back();
+        s->open.pop_back();
+
+        if (this->closed[node.tile] == this->generation) continue;
+
+        this->closed[node.tile] = this->generation;
+        (*budget) --;
+
+        if (node.tile == s->to) return 1;
+
+        if (s->jump) {
+            this->expand_jump_points(s, node.tile, node.g, budget);
+        } else {
+            this->expand_neighbors(s, node.tile, node.g);
+        }
+    }
+
+    return -1;
+}
+
+void Plteen::GridPathfinder::relax(Search* s, int parent, int tile, float g) {
+    if ((this->closed[tile] != this->generation) && ((this->seen[tile] != this->generation) || (g < this->g[tile]))) {
+        this->seen[tile] = this->generation;
+        this->g[tile] = g;
+        this->parent[tile] = parent;
+
+        s->open.push_back({ g + this->heuristic(tile, s->to), g, tile });
+        std::push_heap(s->open.begin(), s->open.end(), OpenOrder<OpenNode>());
+    }
+}
+
+void Plteen::GridPathfinder::expand_neighbors(Search* s, int tile, float g) {
+    int r = tile / this->col;
+    int c = tile % this->col;
+    int n = (this->diagonal ? 8 : 4);
+
+    for (int d = 0; d < n; d ++) {
+        if (this->steppable(r, c, drs[d], dcs[d], s->bounds)) {
+            this->relax(s, tile, (r + drs[d]) * this->col + (c + dcs[d]), g + ((d < 4) ? 1.0F : diagonal_cost));
+        }
+    }
+}
+
+void Plteen::GridPathfinder::expand_jump_points(Search* s, int tile, float g, size_t* budget) {
+    int r = tile / this->col;
+    int c = tile % this->col;
+    int p = this->parent[tile];
+    int dirs[8][2];
+    int n = 0;
+
+    if (p == tile) {
+        for (int d = 0; d < 8; d ++) {
+            if (this->steppable(r, c, drs[d], dcs[d], s->bounds)) {
+                dirs[n][0] = drs[d];
+                dirs[n][1] = dcs[d];
+                n ++;
+            }
+        }
+    } else { // pruned neighbors, diagonal moves never cut corners
+        int dr = sign(r - p / this->col);
+        int dc = sign(c - p % this->col);
+        auto push = [&dirs, &n](int ddr, int ddc) { dirs[n][0] = ddr; dirs[n][1] = ddc; n ++; };
+
+        if ((dr != 0) && (dc != 0)) {
+            bool v = this->walkable(r + dr, c);
+            bool h = this->walkable(r, c + dc);
+
+            if (v) push(dr, 0);
+            if (h) push(0, dc);
+            if (v && h) push(dr, dc);
+        } else if (dc != 0) {
+            bool ahead = this->walkable(r, c + dc);
+            bool up = this->walkable(r - 1, c);
+            bool down = this->walkable(r + 1, c);
+
+            if (ahead) {
+                push(0, dc);
+                if (up) push(-1, dc);
+                if (down) push(1, dc);
+            }
+
+            if (up) push(-1, 0);
+            if (down) push(1, 0);
+        } else {
+            bool ahead = this->walkable(r + dr, c);
+            bool left = this->walkable(r, c - 1);
+            bool right = this->walkable(r, c + 1);
+
+            if (ahead) {
+                push(dr, 0);
+                if (left) push(dr, -1);
+                if (right) push(dr, 1);
+            }
+
+            if (left) push(0, -1);
+            if (right) push(0, 1);
+        }
+    }
+
+    for (int i = 0; i < n; i ++) {
+        size_t steps = 0U;
+        int jp = this->jump(r, c, dirs[i][0], dirs[i][1], s->to, &steps);
+
+        // scanning is much cheaper than expanding
+        (*budget) -= std::min((*budget), steps >> 3U);
+
+        if (jp >= 0) {
+            this->relax(s, tile, jp, g + this->heuristic(tile, jp));
+        }
+    }
+}
+
+int Plteen::GridPathfinder::jump(int r, int c, int dr, int dc, int goal, size_t* steps) {
+    while (true) {
+        r += dr;
+        c += dc;
+        (*steps) ++;
+
+        if (!this->walkable(r, c)) return -1;
+
+        int tile = r * this->col + c;
+
+        if (tile == goal) return tile;
+
+        if ((dr != 0) && (dc != 0)) {
+            if ((this->jump(r, c, 0, dc, goal, steps) >= 0) || (this->jump(r, c, dr, 0, goal, steps) >= 0)) return tile;
+            if (!(this->walkable(r + dr, c) && this->walkable(r, c + dc))) return -1;
+        } else if (dc != 0) {
+            if ((this->walkable(r - 1, c) && !this->walkable(r - 1, c - dc))
+                    || (this->walkable(r + 1, c) && !this->walkable(r + 1, c - dc))) return tile;
+        } else {
+            if ((this->walkable(r, c - 1) && !this->walkable(r - dr, c - 1))
+                    || (this->walkable(r, c + 1) && !this->walkable(r - dr, c + 1))) return tile;
+        }
+    }
+}
+
+void Plteen::GridPathfinder::trace_path(int from, int to, std::vector<int>* path) {
+    std::vector<int> points;
+
+    for (int t = to; t != from; t = this->parent[t]) {
+        points.push_back(t);
+    }
+
+    path->clear();
+    path->push_back(from);
+
+    // segments between jump points are straight or diagonal
+    for (size_t i = points.size(); i > 0U; i --) {
+        int r = path->back() / this->col;
+        int c = path->back() % this->col;
+        int tr = points[i - 1U] / this->col;
+        int tc = points[i - 1U] % this->col;
+        int dr = sign(tr - r);
+        int dc = sign(tc - c);
+
+        while ((r != tr) || (c != tc)) {
+            r += dr;
+            c += dc;
+            path->push_back(r * this->col + c);
+        }
+    }
+}
+
+bool Plteen::GridPathfinder::search_path(int from, int to, bool jump, const Bounds& bounds, std::vector<int>* path, size_t* work) {
+    size_t budget = std::numeric_limits<size_t>::max();
+    Search s;
+    bool okay;
+
+    this->begin_search(&s, from, to, jump, bounds);
+    okay = (this->continue_search(&s, &budget) > 0);
+    (*work) += std::numeric_limits<size_t>::max() - budget;
+
+    if (okay) {
+        this->trace_path(from, to, path);
+    }
+
+    return okay;
+}
+
+/*************************************************************************************************/
+bool Plteen::GridPathfinder::find_hierarchical_path(int from, int to, std::vector<int>* path, size_t* work) {
+    struct AbstractNode { float f; float g; int tile; }; // `tile` is the index of the node
+    OpenOrder<AbstractNode> order;
+    std::vector<AbstractNode> open;
+    std::vector<AbstractEdge> sources, targets;
+    int cfrom, cto, N, S, T;
+
+    if (!this->abstraction_okay) {
+        this->rebuild_abstraction(nullptr);
+    }
+
+    cfrom = this->cluster_index(from);
+    cto = this->cluster_index(to);
+
+    if (cfrom == cto) {
+        if (this->search_path(from, to, false, this->cluster_bounds(cfrom), path, work)) {
+            return true;
+        }
+    }
+
+    this->connect_to_abstraction(from, sources, work);
+    this->connect_to_abstraction(to, targets, work);
+
+    // enclosed in their clusters
+    if (sources.empty() || targets.empty()) {
+        return false;
+    }
+
+    N = int(this->nodes.size());
+    S = N;
+    T = N + 1;
+
+    std::vector<float> goal_links(N, infinity);
+    std::vector<float> ag(N + 2, infinity);
+    std::vector<int> ap(N + 2, -1);
+    std::vector<bool> done(N + 2, false);
+
+    for (auto& e : targets) {
+        goal_links[e.node] = e.cost;
+    }
+
+    auto tile_of = [this, N, S, from, to](int n) { return (n < N) ? this->nodes[n] : ((n == S) ? from : to); };
+    auto relax = [&](int u, int v, float cost) {
+        float g = ag[u] + cost;
+
+        if ((!done[v]) && (g < ag[v])) {
+            ag[v] = g;
+            ap[v] = u;
+            open.push_back({ g + this->heuristic(tile_of(v), to), g, v });
+            std::push_heap(open.begin(), open.end(), order);
+        }
+    };
+
+    ag[S] = 0.0F;
+    open.push_back({ this->heuristic(from, to), 0.0F, S });
+
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), order);
+        int u = open.back().tile;
+        open.pop_back();
+
+        if (done[u]) continue;
+
+        done[u] = true;
+        (*work) ++;
+
+        if (u == T) break;
+
+        if (u == S) {
+            for (auto& e : sources) relax(u, e.node, e.cost);
+        } else {
+            int cidx = this->cluster_index(this->nodes[u]);
+            Cluster& self = this->clusters[cidx];
+            size_t n = self.entrances.size();
+            size_t i = size_t(u - self.base);
+
+            if (self.dirty) {
+                this->rebuild_cluster_costs(cidx);
+                (*work) += n * self.entrances.size();
+            }
+
+            for (size_t j = 0U; j < n; j ++) {
+                if ((j != i) && (self.costs[i * n + j] < infinity)) {
+                    relax(u, self.base + int(j), self.costs[i * n + j]);
+                }
+            }
+
+            for (auto& e : this->crossings[u]) relax(u, e.node, e.cost);
+            if (goal_links[u] < infinity) relax(u, T, goal_links[u]);
+        }
+    }
+
+    if (!done[T]) {
+        return false;
+    }
+
+    std::vector<int> waypoints;
+    std::vector<int> segment;
+
+    for (int n = T; n != S; n = ap[n]) {
+        waypoints.push_back(tile_of(n));
+    }
+
+    path->clear();
+    path->push_back(from);
+
+    // refinement, entrances of the same cluster are connected within the cluster
+    for (size_t i = waypoints.size(); i > 0U; i --) {
+        int a = path->back();
+        int b = waypoints[i - 1U];
+        int ca = this->cluster_index(a);
+
+        if (a == b) continue;
+
+        if (ca != this->cluster_index(b)) {
+            path->push_back(b);
+        } else if (this->search_path(a, b, false, this->cluster_bounds(ca), &segment, work)) {
+            path->insert(path->end(), segment.begin() + 1, segment.end());
+        } else {
+            path->clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Plteen::GridPathfinder::rebuild_abstraction(const std::vector<int>* changes) {
+    std::vector<std::pair<int, int>> pairs;
+    std::vector<std::vector<int>> entrances;
+
+    if ((changes == nullptr) || !this->abstraction_okay) {
+        this->crow = (this->row + this->csize - 1) / this->csize;
+        this->ccol = (this->col + this->csize - 1) / this->csize;
+        this->clusters.assign(size_t(this->crow * this->ccol), Cluster());
+    } else {
+        for (int tile : (*changes)) {
+            this->clusters[this->cluster_index(tile)].dirty = true;
+        }
+    }
+
+    entrances.resize(this->clusters.size());
+
+    { // entrances are cheap to find, so they are always found again
+        auto cross = [&](int a, int b) {
+            entrances[this->cluster_index(a)].push_back(a);
+            entrances[this->cluster_index(b)].push_back(b);
+            pairs.push_back({ a, b });
+        };
+
+        auto scan = [&](int count, auto near, auto far) {
+            // runs never cross clusters
+            for (int s0 = 0; s0 < count; s0 += this->csize) {
+                int s1 = std::min(count, s0 + this->csize);
+                int start = -1;
+
+                for (int i = s0; i <= s1; i ++) {
+                    if ((i < s1) && this->grid->is_passable(near(i)) && this->grid->is_passable(far(i))) {
+                        if (start < 0) start = i;
+                    } else if (start >= 0) {
+                        int end = i - 1;
+
+                        if (end - start + 1 < entrance_span) {
+                            int mid = (start + end) / 2;
+
+                            cross(near(mid), far(mid));
+                        } else {
+                            cross(near(start), far(start));
+                            cross(near(end), far(end));
+                        }
+
+                        start = -1;
+                    }
+                }
+            }
+        };
+
+        for (int cc = 1; cc < this->ccol; cc ++) {
+            int x = cc * this->csize;
+
+            scan(this->row, [=](int r) { return r * this->col + x - 1; }, [=](int r) { return r * this->col + x; });
+        }
+
+        for (int cr = 1; cr < this->crow; cr ++) {
+            int y = cr * this->csize;
+
+            scan(this->col, [=](int c) { return (y - 1) * this->col + c; }, [=](int c) { return y * this->col + c; });
+        }
+    }
+
+    for (int tile : this->nodes) {
+        this->node_indices[tile] = -1;
+    }
+
+    this->nodes.clear();
+    this->node_indices.resize(this->g.size(), -1);
+
+    // intra-cluster costs are computed on demand, clusters that are never visited cost nothing
+    for (size_t idx = 0U; idx < this->clusters.size(); idx ++) {
+        Cluster& self = this->clusters[idx];
+        std::vector<int>& es = entrances[idx];
+
+        std::sort(es.begin(), es.end());
+        es.erase(std::unique(es.begin(), es.end()), es.end());
+
+        if (self.entrances != es) {
+            self.entrances.swap(es);
+            self.dirty = true;
+        }
+
+        self.base = int(this->nodes.size());
+
+        for (int tile : self.entrances) {
+            this->node_indices[tile] = int(this->nodes.size());
+            this->nodes.push_back(tile);
+        }
+    }
+
+    this->crossings.assign(this->nodes.size(), std::vector<AbstractEdge>());
+
+    for (auto& c : pairs) {
+        int u = this->node_indices[c.first];
+        int v = this->node_indices[c.second];
+
+        this->crossings[u].push_back({ v, 1.0F });
+        this->crossings[v].push_back({ u, 1.0F });
+    }
+
+    this->abstraction_okay = true;
+}
+
+void Plteen::GridPathfinder::rebuild_cluster_costs(int cidx) {
+    Cluster& self = this->clusters[cidx];
+    Bounds bounds = this->cluster_bounds(cidx);
+    int w = bounds.c1 - bounds.c0 + 1;
+    size_t n = self.entrances.size();
+    std::vector<float> dist;
+
+    self.costs.assign(n * n, infinity);
+
+    for (size_t i = 0U; i < n; i ++) {
+        self.costs[i * n + i] = 0.0F;
+
+        // costs are symmetric
+        if (i + 1U < n) {
+            this->cluster_distances(self.entrances[i], bounds, dist);
+
+            for (size_t j = i + 1U; j < n; j ++) {
+                int e = self.entrances[j];
+                float d = dist[(e / this->col - bounds.r0) * w + (e % this->col - bounds.c0)];
+
+                self.costs[i * n + j] = d;
+                self.costs[j * n + i] = d;
+            }
+        }
+    }
+
+    self.dirty = false;
+}
+
+void Plteen::GridPathfinder::cluster_distances(int from, const Bounds& bounds, std::vector<float>& dist) {
+    typedef std::pair<float, int> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> open;
+    int w = bounds.c1 - bounds.c0 + 1;
+    int h = bounds.r1 - bounds.r0 + 1;
+    int n = (this->diagonal ? 8 : 4);
+    int local = (from / this->col - bounds.r0) * w + (from % this->col - bounds.c0);
+
+    dist.assign(size_t(w * h), infinity);
+    dist[local] = 0.0F;
+    open.push({ 0.0F, local });
+
+    while (!open.empty()) {
+        Item top = open.top();
+        int r = top.second / w + bounds.r0;
+        int c = top.second % w + bounds.c0;
+
+        open.pop();
+
+        if (top.first > dist[top.second]) continue;
+
+        for (int d = 0; d < n; d ++) {
+            if (this->steppable(r, c, drs[d], dcs[d], bounds)) {
+                int next = top.second + drs[d] * w + dcs[d];
+                float nd = top.first + ((d < 4) ? 1.0F : diagonal_cost);
+
+                if (nd < dist[next]) {
+                    dist[next] = nd;
+                    open.push({ nd, next });
+                }
+            }
+        }
+    }
+}
+
+void Plteen::GridPathfinder::connect_to_abstraction(int tile, std::vector<AbstractEdge>& edges, size_t* work) {
+    int cidx = this->cluster_index(tile);
+    Bounds bounds = this->cluster_bounds(cidx);
+    int w = bounds.c1 - bounds.c0 + 1;
+    std::vector<float> dist;
+
+    this->cluster_distances(tile, bounds, dist);
+    (*work) += dist.size();
+
+    for (int e : this->clusters[cidx].entrances) {
+        float d = dist[(e / this->col - bounds.r0) * w + (e % this->col - bounds.c0)];
+
+        if (d < infinity) {
+            edges.push_back({ this->node_indices[e], d });
+        }
+    }
+}
+
+int Plteen::GridPathfinder::cluster_index(int tile) const {
+    return (tile / this->col / this->csize) * this->ccol + (tile % this->col / this->csize);
+}
+
+GridPathfinder::Bounds Plteen::GridPathfinder::cluster_bounds(int cidx) const {
+    int r0 = (cidx / this->ccol) * this->csize;
+    int c0 = (cidx % this->ccol) * this->csize;
+
+    return { r0, c0, std::min(this->row, r0 + this->csize) - 1, std::min(this->col, c0 + this->csize) - 1 };
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "passability.hpp"
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
+
+namespace Plteen {
+    enum class PathAlgorithm { AStar, JPS, HPA };
+    enum class PathStatus { Pending, Found, Unreachable, Unknown };
+
+    /**
+     * Routes over a `PassabilityGrid`, tiles are indexed in row-major order, as `GridAtlas` does.
+     *
+     * Diagonal moves cost sqrt(2), and never cut corners, that is, both orthogonal neighbors have to be passable.
+     * Paths include both the source and the target.
+     *
+     * JPS: Harabor & Grastien, Online Graph Pruning for Pathfinding on Grid Maps, 2011,
+     *   only for 8-way movement, 4-way searches fall back to A*.
+     * HPA*: Botea, Müller & Schaeffer, Near Optimal Hierarchical Path-Finding, 2004,
+     *   paths are near-optimal but not bounded, say, up to a third longer on random grids with 25% obstacles,
+     *   but much cheaper on large maps; use A* or JPS when optimality matters.
+     *
+     * Requested paths are searched in `update`, which expands at most `budget` nodes per call,
+     *   so that many agents could ask for paths without frame spikes.
+     * Changes of the grid are caught up at the beginning of every search and `update`,
+     *   found paths that go through newly blocked tiles are replanned from where their agents are.
+     */
+    class __lambda__ GridPathfinder {
+    public:
+        GridPathfinder(const Plteen::PassabilityGrid* grid, bool diagonal = true, int cluster_size = 16);
+        virtual ~GridPathfinder() {}
+
+    public:
+        bool find_path(int from, int to, std::vector<int>* path, PathAlgorithm algorithm = PathAlgorithm::JPS);
+        bool find_path(int from_row, int from_col, int to_row, int to_col, std::vector<int>* path, PathAlgorithm algorithm = PathAlgorithm::JPS);
+
+    public:
+        uint32_t request_path(int from, int to, PathAlgorithm algorithm = PathAlgorithm::JPS);
+        Plteen::PathStatus poll_path(uint32_t ticket, std::vector<int>* path = nullptr);
+        void follow_path(uint32_t ticket, int tile); // the agent has reached `tile`, replanning starts from there
+        void release_path(uint32_t ticket);
+        size_t update(size_t budget = 4096U); // returns the number of expanded nodes
+        size_t pending_count();
+
+    public:
+        bool is_diagonal() const { return this->diagonal; }
+        int cluster_size() const { return this->csize; }
+
+    private:
+        struct OpenNode { float f; float g; int tile; };
+        struct Bounds { int r0; int c0; int r1; int c1; };
+        struct AbstractEdge { int node; float cost; };
+
+        struct Search {
+            uint32_t ticket = 0U;
+            int from = -1;
+            int to = -1;
+            bool jump = false;
+            Bounds bounds;
+            std::vector<OpenNode> open;
+        };
+
+        struct Ticket {
+            int from;
+            int to;
+            int current;
+            PathAlgorithm algorithm;
+            Plteen::PathStatus status;
+            std::vector<int> path;
+        };
+
+        struct Cluster {
+            std::vector<int> entrances;  // sorted tiles
+            std::vector<float> costs;    // entrances.size() x entrances.size(), infinity if disconnected
+            int base = 0;                // the abstract node of the first entrance
+            bool dirty = true;           // costs are computed on demand
+        };
+
+    private:
+        void synchronize();
+        void replan_tickets(const std::vector<int>& changes);
+        bool walkable(int r, int c) const { return this->grid->is_passable(r, c); }
+        bool steppable(int r, int c, int dr, int dc, const Bounds& bounds) const;
+        float heuristic(int from, int to) const;
+
+    private: // A* and JPS, resumable
+        void begin_search(Search* s, int from, int to, bool jump, const Bounds& bounds);
+        int continue_search(Search* s, size_t* budget); // 1: found; -1: unreachable; 0: unfinished
+        void relax(Search* s, int parent, int tile, float g);
+        void expand_neighbors(Search* s, int tile, float g);
+        void expand_jump_points(Search* s, int tile, float g, size_t* budget);
+        int jump(int r, int c, int dr, int dc, int goal, size_t* steps);
+        void trace_path(int from, int to, std::vector<int>* path);
+        bool search_path(int from, int to, bool jump, const Bounds& bounds, std::vector<int>* path, size_t* work);
+
+    private: // HPA*
+        bool find_hierarchical_path(int from, int to, std::vector<int>* path, size_t* work);
+        void rebuild_abstraction(const std::vector<int>* changes);
+        void rebuild_cluster_costs(int cidx);
+        void cluster_distances(int from, const Bounds& bounds, std::vector<float>& dist);
+        void connect_to_abstraction(int tile, std::vector<AbstractEdge>& edges, size_t* work);
+        int cluster_index(int tile) const;
+        Bounds cluster_bounds(int cidx) const;
+
+    private:
+        const Plteen::PassabilityGrid* grid;
+        uint64_t revision = 0U;
+        bool diagonal;
+        int row = 0;
+        int col = 0;
+
+    private: // scratch, stamped with generations, no clearing for every search
+        std::vector<float> g;
+        std::vector<int> parent;
+        std::vector<uint32_t> seen;
+        std::vector<uint32_t> closed;
+        uint32_t generation = 0U;
+
+    private:
+        std::unordered_map<uint32_t, Ticket> tickets;
+        std::deque<uint32_t> queue;
+        Search search;
+        uint32_t next_ticket = 1U;
+
+    private:
+        int csize;
+        int crow = 0;
+        int ccol = 0;
+        bool abstraction_okay = false;
+        std::vector<Cluster> clusters;
+        std::vector<int> nodes;                              // tiles of all entrances
+        std::vector<int> node_indices;                       // tile => node, or -1
+        std::vector<std::vector<AbstractEdge>> crossings;    // edges between clusters
+    };
+}
@@ -1,52 +1,195 @@
-// https://en.cppreference.com/w/cpp/named_req/RandomNumberDistribution
 #include <random>
+#include <utility>
 
 #include "random.hpp"
 
 using namespace Plteen;
 
 /*************************************************************************************************/
-// Members in <random> override the operator '()' to generate value
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = ((*x) += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+static inline float unit_float(uint64_t raw) { // the top 24 bits, in [0, 1)
+    return float(raw >> 40) * 0x1.0p-24F;
+}
+
+static inline double unit_double(uint64_t raw) { // the top 53 bits, in [0, 1)
+    return double(raw >> 11) * 0x1.0p-53;
+}
+
+/*************************************************************************************************/
+Plteen::RandomStream::RandomStream() {
+    // non-determinstic generator, only for seeding
+    std::random_device rd;
+
+    this->reseed((uint64_t(rd()) << 32U) | uint64_t(rd()));
+}
+
+void Plteen::RandomStream::reseed(uint64_t seed) {
+    uint64_t x = seed;
+
+    // splitmix64 never produces the all-zero state from any seed
+    for (size_t i = 0; i < 4; ++ i) {
+        this->state[i] = splitmix64(&x);
+    }
+
+    this->origin = seed;
+}
 
-// non-determinstic generator
-static std::random_device rd;
+uint64_t Plteen::RandomStream::next() {
+    uint64_t* s = this->state;
+    uint64_t result = rotl(s[1] * 5U, 7) * 9U;
+    uint64_t t = s[1] << 17U;
 
-// to seed mersenne twister, similar to srand() with datum better than time(nullptr);
-static std::mt19937 random_generator(rd());
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+uint32_t Plteen::RandomStream::bounded(uint64_t range) {
+    uint32_t x = uint32_t(this->next() >> 32U);
+
+    if (range > 0xFFFFFFFFULL) {
+        return x;
+    } else {
+        uint64_t m = uint64_t(x) * range;
+        uint32_t l = uint32_t(m);
+
+        // rejects the few low products that would bias the result, the modulo is rarely reached
+        if (l < range) {
+            uint32_t t = uint32_t((0x100000000ULL - range) % range);
+
+            while (l < t) {
+                x = uint32_t(this->next() >> 32U);
+                m = uint64_t(x) * range;
+                l = uint32_t(m);
+            }
+        }
+
+        return uint32_t(m >> 32U);
+    }
+}
 
 /*************************************************************************************************/
+int Plteen::RandomStream::uniform(int min, int max) {
+    if (max < min) std::swap(min, max);
+
+    return int(int64_t(min) + int64_t(this->bounded(uint64_t(int64_t(max) - int64_t(min)) + 1U)));
+}
+
+unsigned int Plteen::RandomStream::uniform(unsigned int min, unsigned int max) {
+    if (max < min) std::swap(min, max);
+
+    return min + this->bounded(uint64_t(max - min) + 1U);
+}
+
+float Plteen::RandomStream::uniform(float min, float max) {
+    return min + (max - min) * unit_float(this->next());
+}
+
+double Plteen::RandomStream::uniform(double min, double max) {
+    return min + (max - min) * unit_double(this->next());
+}
+
+bool Plteen::RandomStream::bernoulli(double p) {
+    return unit_double(this->next()) < p;
+}
+
+/*************************************************************************************************/
+void Plteen::RandomStream::uniform_fill(int* dest, size_t n, int min, int max) {
+    if (max < min) std::swap(min, max);
+
+    uint64_t range = uint64_t(int64_t(max) - int64_t(min)) + 1U;
+
+    for (size_t i = 0; i < n; ++ i) {
+        dest[i] = int(int64_t(min) + int64_t(this->bounded(range)));
+    }
+}
+
+void Plteen::RandomStream::uniform_fill(unsigned int* dest, size_t n, unsigned int min, unsigned int max) {
+    if (max < min) std::swap(min, max);
+
+    uint64_t range = uint64_t(max - min) + 1U;
+
+    for (size_t i = 0; i < n; ++ i) {
+        dest[i] = min + this->bounded(range);
+    }
+}
+
+void Plteen::RandomStream::uniform_fill(float* dest, size_t n, float min, float max) {
+    float span = max - min;
+
+    for (size_t i = 0; i < n; ++ i) {
+        dest[i] = min + span * unit_float(this->next());
+    }
+}
+
+void Plteen::RandomStream::uniform_fill(double* dest, size_t n, double min, double max) {
+    double span = max - min;
+
+    for (size_t i = 0; i < n; ++ i) {
+        dest[i] = min + span * unit_double(this->next());
+    }
+}
+
+/*************************************************************************************************/
+RandomStream& Plteen::random_thread_stream() {
+    static thread_local RandomStream stream;
+
+    return stream;
+}
+
 int Plteen::random_raw() {
-    return random_generator();
+    return int(uint32_t(random_thread_stream().next() >> 32U));
 }
 
 int Plteen::random_uniform(int min, int max) {
-    // shape data generated by a generator with a distribution for integers in [min, max] 
-    std::uniform_int_distribution<> random_dist(min, max);
-
-    return random_dist(random_generator);
+    return random_thread_stream().uniform(min, max);
 }
 
 unsigned int Plteen::random_uniform(unsigned int min, unsigned int max) {
-    // shape data generated by a generator with a distribution for integers in [min, max] 
-    std::uniform_int_distribution<unsigned int> random_dist(min, max);
-
-    return random_dist(random_generator);
+    return random_thread_stream().uniform(min, max);
 }
 
 float Plteen::random_uniform(float min, float max) {
-    std::uniform_real_distribution<float> random_dist(min, max);
-
-    return random_dist(random_generator);
+    return random_thread_stream().uniform(min, max);
 }
 
 double Plteen::random_uniform(double min, double max) {
-    std::uniform_real_distribution<double> random_dist(min, max);
-
-    return random_dist(random_generator);
+    return random_thread_stream().uniform(min, max);
 }
 
 bool Plteen::random_bernoulli(double p) {
-    std::bernoulli_distribution random_dist(p);
+    return random_thread_stream().bernoulli(p);
+}
+
+void Plteen::random_uniform_fill(int* dest, size_t n, int min, int max) {
+    random_thread_stream().uniform_fill(dest, n, min, max);
+}
+
+void Plteen::random_uniform_fill(unsigned int* dest, size_t n, unsigned int min, unsigned int max) {
+    random_thread_stream().uniform_fill(dest, n, min, max);
+}
+
+void Plteen::random_uniform_fill(float* dest, size_t n, float min, float max) {
+    random_thread_stream().uniform_fill(dest, n, min, max);
+}
 
-    return random_dist(random_generator);
+void Plteen::random_uniform_fill(double* dest, size_t n, double min, double max) {
+    random_thread_stream().uniform_fill(dest, n, min, max);
 }
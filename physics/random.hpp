@@ -1,11 +1,62 @@
 #pragma once // 确保只被 include 一次
 
+#include <cstdint>
+#include <cstddef>
+
 namespace Plteen {
+    /**
+     * xoshiro256** streams, seeded through splitmix64
+     *   https://prng.di.unimi.it/
+     *
+     * Integers in ranges are sampled with Lemire's nearly divisionless method, without bias,
+     *   reals are in [min, max), built from the high bits of the raw output.
+     *
+     * A stream is not thread-safe, every thread owns one for the free functions below,
+     *   planes own their streams as well, which could be seeded for deterministic replays.
+     */
+    class __lambda__ RandomStream {
+    public:
+        RandomStream(); // seeded from `std::random_device`
+        RandomStream(uint64_t seed) { this->reseed(seed); }
+
+    public:
+        void reseed(uint64_t seed);
+        uint64_t seed() const { return this->origin; }
+        uint64_t next();
+
+    public:
+        int uniform(int min, int max);
+        unsigned int uniform(unsigned int min, unsigned int max);
+        float uniform(float min, float max);
+        double uniform(double min = 0.0, double max = 1.0);
+        bool bernoulli(double p_true);
+
+    public:
+        void uniform_fill(int* dest, size_t n, int min, int max);
+        void uniform_fill(unsigned int* dest, size_t n, unsigned int min, unsigned int max);
+        void uniform_fill(float* dest, size_t n, float min, float max);
+        void uniform_fill(double* dest, size_t n, double min = 0.0, double max = 1.0);
+
+    private:
+        uint32_t bounded(uint64_t range); // in [0, range), for range in [1, 2^32]
+
+    private:
+        uint64_t state[4];
+        uint64_t origin;
+    };
+
+    __lambda__ Plteen::RandomStream& random_thread_stream();
+
     __lambda__ int random_raw();
     __lambda__ int random_uniform(int min, int max);
     __lambda__ unsigned int random_uniform(unsigned int min, unsigned int max);
     __lambda__ float random_uniform(float min, float max);
     __lambda__ double random_uniform(double min = 0.0, double max = 1.0);
-    
+
     __lambda__ bool random_bernoulli(double p_true);
+
+    __lambda__ void random_uniform_fill(int* dest, size_t n, int min, int max);
+    __lambda__ void random_uniform_fill(unsigned int* dest, size_t n, unsigned int min, unsigned int max);
+    __lambda__ void random_uniform_fill(float* dest, size_t n, float min, float max);
+    __lambda__ void random_uniform_fill(double* dest, size_t n, double min = 0.0, double max = 1.0);
 }
@@ -127,12 +127,17 @@ namespace Plteen {
         IMatter* bubble = nullptr;
         SpeechBubble bubble_type = SpeechBubble::Default;
         long long bubble_expiration_time = 0;
+        TimerWheel<IMatter>::Node bubble_timer;
         
         // for animation
         uint32_t local_frame_delta = 0U;
         uint32_t local_frame_count = 0U;
-        uint32_t local_elapse = 0U;
+        uint64_t local_epoch = 0U; // the plane's matter timeline when the local one starts accumulating
         int duration = 0;
+        TimerWheel<IMatter>::Node timeline_timer;
+
+        // for value bindings
+        IValuelet<double>* valuelet = nullptr;
 
         // for queued motions
         bool gliding = false;
@@ -213,8 +218,42 @@ static inline void unsafe_set_local_fps(int fps, bool restart, uint32_t& frame_d
     }
 }
 
-static inline void unsafe_set_matter_fps(MatterInfo* info, int fps, bool restart) {
-    unsafe_set_local_fps(fps, restart, info->local_frame_delta, info->local_frame_count, info->local_elapse);
+static inline void unsafe_restart_matter_timeline(MatterInfo* info, uint32_t count0, uint64_t timeline) {
+    info->local_frame_count = count0;
+    info->local_epoch = timeline;
+}
+
+static inline void unsafe_set_matter_fps(MatterInfo* info, int fps, bool restart, uint64_t timeline) {
+    info->local_frame_delta = (fps > 0) ? (1000U / fps) : 0U;
+
+    if (restart) {
+        unsafe_restart_matter_timeline(info, 0U, timeline);
+    }
+}
+
+static inline uint32_t matter_timeline_span(MatterInfo* info) {
+    return (info->duration > 0) ? uint32_t(info->duration) : info->local_frame_delta;
+}
+
+static inline void unsafe_schedule_matter_timeline(TimerWheel<IMatter>& timers, MatterInfo* info, uint64_t timeline) {
+    uint32_t span = matter_timeline_span(info);
+
+    /**
+     * The wheel runs 1ms ahead of the timeline, so that matters could be due at the very first tick.
+     * Matters without local timelines follow the global one, and are due at every tick.
+     */
+    timers.schedule(&info->timeline_timer, ((span > 0U) ? (info->local_epoch + span) : timeline) + 1U);
+}
+
+static inline void unsafe_bind_matter_value(ValueBindingRegistry<double>& registry, MatterInfo* info) {
+    if (info->valuelet != nullptr) {
+        // matters with local timelines poll their values only when they are due
+        if (matter_timeline_span(info) > 0U) {
+            registry.detach(info->valuelet);
+        } else {
+            registry.attach(info->valuelet);
+        }
+    }
 }
 
 static uint32_t local_timeline_elapse(uint32_t global_interval, uint32_t local_frame_delta, uint32_t& local_elapse, int duration) {
@@ -297,10 +336,12 @@ static inline void unsafe_location_changed(IMatter* m, MatterInfo* info, float o
     }
 }
 
-static inline MatterInfo* bind_matter_ownership(IPlane* master, IMatter* m) {
+static inline MatterInfo* bind_matter_ownership(IPlane* master, IMatter* m, uint64_t timeline) {
     auto info = new MatterInfo(master);
     
-    unsafe_set_matter_fps(info, m->preferred_local_fps(), true);
+    unsafe_set_matter_fps(info, m->preferred_local_fps(), true, timeline);
+    info->timeline_timer.datum = m;
+    info->bubble_timer.datum = m;
     m->info = info;
 
     return info;
@@ -327,11 +368,12 @@ static inline MatterInfo* plane_matter_info(IPlane* master, IMatter* m) {
     return info;
 }
 
-static inline void bubble_start(ISprite* m, MatterInfo* info, double sec, SpeechBubble type, double default_duration) {
+static inline void bubble_start(TimerWheel<IMatter>& timers, ISprite* m, MatterInfo* info, double sec, SpeechBubble type, double default_duration) {
     double duration = (sec > 0.0) ? sec : default_duration;
 
     info->bubble_type = type;            
     info->bubble_expiration_time = current_milliseconds() + fl2fx<long long>(duration * 1000.0);
+    timers.schedule(&info->bubble_timer, uint64_t(info->bubble_expiration_time));
 
     if (type == SpeechBubble::Default) {
         m->play_speaking(1);
@@ -342,6 +384,7 @@ static inline void bubble_start(ISprite* m, MatterInfo* info, double sec, Speech
 
 static inline void bubble_expire(IMatter* m, MatterInfo* info) {
     info->bubble_expiration_time = 0LL;
+    info->bubble_timer.unlink();
 }
 
 static inline bool is_matter_bubble_showing(IMatter* m, MatterInfo* info) {
@@ -394,7 +437,7 @@ static IMatter* do_search_selected_matter(IMatter* start, IMatter* terminator) {
 
 /*************************************************************************************************/
 Plane::Plane(const std::string& name) : Plane(name.c_str()) {}
-Plane::Plane(const char* name) : IPlane(name), head_matter(nullptr) {
+Plane::Plane(const char* name) : IPlane(name), head_matter(nullptr), bubble_timers(uint64_t(current_milliseconds())) {
     this->bubble_font = GameFont::Tooltip(FontSize::medium);
     this->set_bubble_duration();
 }
@@ -506,8 +549,10 @@ void Plteen::Plane::send_backward(IMatter* m, int n) {
 
 void Plteen::Plane::insert_at(IMatter* m, const Position& pos, const Port& p, const Vector& vec) {
     if (m->info == nullptr) {
-        MatterInfo* info = bind_matter_ownership(this, m);
+        MatterInfo* info = bind_matter_ownership(this, m, this->matter_timeline);
         
+        unsafe_schedule_matter_timeline(this->timeline_timers, info, this->matter_timeline);
+
         if (this->head_matter == nullptr) {
             this->head_matter = m;
             info->prev = this->head_matter;
@@ -538,9 +583,15 @@ void Plteen::Plane::insert_as_speech_bubble(IMatter* m) {
 }
 
 void Plteen::Plane::handle_new_matter(IMatter* m, MatterInfo* info, const Position& pos, const Port& p, float dx, float dy) {
+    // rangelets clamp their values in `guarded_value()`, which the registry never calls
+    if (dynamic_cast<IRangelet<double>*>(m) == nullptr) {
+        info->valuelet = dynamic_cast<IValuelet<double>*>(m);
+    }
+
     this->begin_update_sequence();
     m->construct(this->drawing_context());
     this->move_matter_to_location_via_info(m, info, pos, p, dx, dy);
+    unsafe_bind_matter_value(this->value_bindings, info);
     
     if (m->ready()) {
         this->on_matter_ready(m);
@@ -580,6 +631,13 @@ void Plteen::Plane::remove(IMatter* m, bool needs_delete) {
         if (this->focused_matter == m) {
             this->focused_matter = nullptr;
         }
+
+        this->timeline_timers.cancel(&info->timeline_timer);
+        this->bubble_timers.cancel(&info->bubble_timer);
+
+        if (info->valuelet != nullptr) {
+            this->value_bindings.detach(info->valuelet);
+        }
         
         if (needs_delete) {
             this->delete_matter(m);
@@ -1346,7 +1404,9 @@ void Plteen::Plane::set_matter_fps(IMatter* m, int fps, bool restart) {
     MatterInfo* info = plane_matter_info(this, m);
 
     if (info != nullptr) {
-        unsafe_set_matter_fps(info, fps, restart);
+        unsafe_set_matter_fps(info, fps, restart, this->matter_timeline);
+        unsafe_schedule_matter_timeline(this->timeline_timers, info, this->matter_timeline);
+        unsafe_bind_matter_value(this->value_bindings, info);
     }
 }
 
@@ -1360,43 +1420,61 @@ void Plteen::Plane::notify_matter_timeline_restart(IMatter* m, uint32_t count0,
 
     if (info != nullptr) {
         info->duration = duration;
-        reset_timeline(info->local_frame_count, info->local_elapse, count0);
+        unsafe_restart_matter_timeline(info, count0, this->matter_timeline);
+        unsafe_schedule_matter_timeline(this->timeline_timers, info, this->matter_timeline);
+        unsafe_bind_matter_value(this->value_bindings, info);
     }
 }
 
 void Plteen::Plane::on_elapse(uint64_t count, uint32_t interval, uint64_t uptime) {
+    uint64_t timeline = this->matter_timeline;
     uint32_t elapse = 0U;
 
+    /**
+     * Local timelines started from now on accumulate from the next tick,
+     *   a due matter is given the sum of intervals since its timeline started, excluding the current one.
+     */
+    this->matter_timeline += interval;
+    this->timeline_timers.advance(timeline + 1U, [&](TimerWheel<IMatter>::Node* timer) {
+        IMatter* child = timer->datum;
+        MatterInfo* info = MATTER_INFO(child);
+
+        elapse = (matter_timeline_span(info) > 0U) ? uint32_t(timeline - info->local_epoch) : interval;
+        info->local_epoch = this->matter_timeline;
+        info->duration = child->update(info->local_frame_count ++, elapse, uptime);
+        unsafe_schedule_matter_timeline(this->timeline_timers, info, this->matter_timeline);
+        unsafe_bind_matter_value(this->value_bindings, info);
+    });
+
+    this->value_bindings.refresh();
+
     if (this->head_matter != nullptr) {
         IMatter* child = this->head_matter;
         float dwidth, dheight;
 
         this->info->master->feed_client_extent(&dwidth, &dheight);
 
+        /* controlling motion via global timeline makes it more smooth */
         do {
             MatterInfo* info = MATTER_INFO(child);
-            
-            elapse = local_timeline_elapse(interval, info->local_frame_delta, info->local_elapse, info->duration);
-                
-            if (elapse > 0U) {
-                info->duration = child->update(info->local_frame_count ++, elapse, uptime);
-            }
 
-            /* controlling motion via global timeline makes it more smooth */
+            // NOTE: velocities are set on the matters directly, the plane is never told
             this->handle_queued_motion(child, info, dwidth, dheight);
-
-            if (is_matter_bubble_showing(child, info)) {
-                if (current_milliseconds() >= info->bubble_expiration_time) {
-                    bubble_expire(child, info);
-                    this->on_bubble_expired(child, info->bubble_type);
-                    this->notify_updated(child);
-                }
-            }
-
             child = info->next;
         } while (child != this->head_matter);
     }
 
+    this->bubble_timers.advance(uint64_t(current_milliseconds()), [&](TimerWheel<IMatter>::Node* timer) {
+        IMatter* child = timer->datum;
+        MatterInfo* info = MATTER_INFO(child);
+
+        if (is_matter_bubble_showing(child, info)) {
+            bubble_expire(child, info);
+            this->on_bubble_expired(child, info->bubble_type);
+            this->notify_updated(child);
+        }
+    });
+
     elapse = local_timeline_elapse(interval, this->local_frame_delta, this->local_elapse, 0);
     if (elapse > 0U) {
         this->update(this->local_frame_count ++, elapse, uptime);
@@ -1984,7 +2062,7 @@ void Plteen::Plane::say(ISprite* m, double sec, IMatter* message, SpeechBubble t
                 info->bubble = message;
             }
 
-            bubble_start(m, info, sec, type, this->bubble_second);
+            bubble_start(this->bubble_timers, m, info, sec, type, this->bubble_second);
         }
     }
 }
@@ -1996,7 +2074,7 @@ void Plteen::Plane::say(ISprite* m, double sec, const std::string& message, cons
         if (message.empty()) {
             this->shh(m);
         } else if (this->merge_bubble_text(info->bubble, message, color)) {
-            bubble_start(m, info, sec, type, this->bubble_second);
+            bubble_start(this->bubble_timers, m, info, sec, type, this->bubble_second);
         } else {
             this->say(m, sec, this->make_bubble_text(message, color), type);
         }
@@ -2095,8 +2173,8 @@ void Plteen::Plane::glide_to_random_location(double sec, IMatter* m) {
             screen->feed_client_extent(&width, &height);
 
             // TODO: deal with translation
-            rpos = { float(random_uniform(int(hinset), int(width  - hinset))),
-                     float(random_uniform(int(vinset), int(height - vinset))) };
+            rpos = { float(this->random_stream().uniform(int(hinset), int(width  - hinset))),
+                     float(this->random_stream().uniform(int(vinset), int(height - vinset))) };
 
             this->glide_to(sec, m, rpos, MatterPort::CC, Vector::O);
         }
@@ -4,6 +4,7 @@
 #include "graphics/font.hpp"
 #include "physics/color/rgba.hpp"
 #include "physics/color/names.hpp"
+#include "physics/random.hpp"
 #include "physics/algebra/vector.hpp"
 #include "physics/geometry/port.hpp"
 #include "physics/geometry/aabox.hpp"
@@ -12,6 +13,10 @@
 #include "virtualization/screen.hpp"
 #include "virtualization/position.hpp"
 
+#include "matter/graphlet.hpp"
+
+#include "datum/wheel.hpp"
+
 namespace Plteen {
     class __lambda__ IPlaneInfo {
     public:
@@ -118,6 +123,10 @@ namespace Plteen {
         void start_input_text(const char* prompt, ...);
         void log_message(Plteen::Log log, const std::string& msg);
 
+    public: // seed it to replay the randomness of the plane
+        Plteen::RandomStream& random_stream() { return this->rng; }
+        void set_random_seed(uint64_t seed) { this->rng.reseed(seed); }
+
     public:
         bool is_colliding(IMatter* m, IMatter* target);
         bool is_colliding(IMatter* m, IMatter* target, const Plteen::Port& a);
@@ -250,6 +259,7 @@ namespace Plteen {
         
     private:
         std::string caption;
+        Plteen::RandomStream rng;
     };
 
     class __lambda__ Plane : public Plteen::IPlane {
@@ -367,6 +377,13 @@ namespace Plteen {
         void mission_complete() override;
 
     protected:
+        /**
+         * NOTE: only due matters are updated, in the order of their due times,
+         *   and then in the order they were scheduled, rather than the display order;
+         *   queued motions are then handled in the display order, and bubbles expire last.
+         * Matters that depend on the update order of each other should share the same local fps,
+         *   or coordinate in the plane's own `update`, which always comes after theirs.
+         */
         void on_elapse(uint64_t count, uint32_t interval, uint64_t uptime) override;
         void on_matter_ready(IMatter* m) override {}
 
@@ -411,6 +428,14 @@ namespace Plteen {
         Plteen::Dot hovering_gm;
         Plteen::Dot hovering_lm;
 
+    private: // only due matters are visited, instead of the whole list
+        Plteen::TimerWheel<IMatter> timeline_timers;    // keyed on `matter_timeline`
+        Plteen::TimerWheel<IMatter> bubble_timers;      // keyed on `current_milliseconds`
+        uint64_t matter_timeline = 0U;                  // sum of global intervals, including the current one
+
+    private: // bound values of valuelets without local timelines are polled in one pass per tick, instead of in their own `update`s
+        Plteen::ValueBindingRegistry<double> value_bindings;
+
     private:
         // TODO: implement other transformation
         Plteen::Dot translate = {};
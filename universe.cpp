@@ -71,6 +71,52 @@ static unsigned int trigger_timer_event(unsigned int interval, void* datum) {
     return interval;
 }
 
+/*************************************************************************************************/
+static const size_t event_batch_size = 64U;
+
+/**
+ * 合并连续的同类事件，合并成功则 `self` 吸收 `next`
+ * 鼠标移动事件累加相对位移，保留最新的位置；滚轮事件累加滚动量
+ **/
+static bool coalesce_event(SDL_Event& self, const SDL_Event& next) {
+    bool okay = false;
+
+    if (self.type == next.type) {
+        switch (self.type) {
+        case SDL_MOUSEMOTION: {
+            if ((self.motion.which == next.motion.which) && (self.motion.windowID == next.motion.windowID)
+                    && (self.motion.state == next.motion.state)) {
+                self.motion.timestamp = next.motion.timestamp;
+                self.motion.x = next.motion.x;
+                self.motion.y = next.motion.y;
+                self.motion.xrel += next.motion.xrel;
+                self.motion.yrel += next.motion.yrel;
+                okay = true;
+            }
+        }; break;
+        case SDL_MOUSEWHEEL: {
+            if ((self.wheel.which == next.wheel.which) && (self.wheel.windowID == next.wheel.windowID)
+                    && (self.wheel.direction == next.wheel.direction)) {
+                self.wheel.timestamp = next.wheel.timestamp;
+                self.wheel.x += next.wheel.x;
+                self.wheel.y += next.wheel.y;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+                self.wheel.preciseX += next.wheel.preciseX;
+                self.wheel.preciseY += next.wheel.preciseY;
+#endif
+#if SDL_VERSION_ATLEAST(2, 26, 0)
+                self.wheel.mouseX = next.wheel.mouseX;
+                self.wheel.mouseY = next.wheel.mouseY;
+#endif
+                okay = true;
+            }
+        }; break;
+        }
+    }
+
+    return okay;
+}
+
 /*************************************************************************************************/
 static void game_initialize(uint32_t flags) {
     Call_With_Safe_Exit(SDL_Init(flags), "SDL 初始化失败: ", SDL_Quit, SDL_GetError);
@@ -182,6 +228,11 @@ Plteen::IUniverse::~IUniverse() {
         SDL_DestroyTexture(this->texture);
     }
 
+    // pending snapshots are saved before leaving
+    if (this->encoder != nullptr) {
+        delete this->encoder;
+    }
+
     delete this->device;
     SDL_DestroyWindow(this->window);
 }
@@ -212,49 +263,106 @@ void Plteen::IUniverse::big_bang() {
     while ((quit_time == 0UL) && !this->can_exit()) {
         if (SDL_WaitEvent(&e)) {        // 处理用户交互事件, SDL_PollEvent 多占用 4-7% CPU
             this->begin_update_sequence();
+            this->pump_events(e, &quit_time);
+            this->report_snapshots();
+            this->end_update_sequence();
+        } else {
+            this->log_message(Log::Error, make_nstring("failed to pop the event: %s", SDL_GetError()));
+        }
+    }
+}
 
-            switch (e.type) {
-            case SDL_USEREVENT: {       // 定时器到期通知，更新游戏
-                auto parcel = reinterpret_cast<timer_parcel_t*>(e.user.data1);
-
-                if (parcel->universe == this) {
-                    /** TODO
-                     * Is SDL2 really pumping duplicate events?
-                     * Why the first `count` is much larger then 1?
-                     */
-                    if (parcel->last_timestamp != parcel->uptime) {
-                        this->on_elapse(parcel->count, parcel->interval, parcel->uptime);
-                        parcel->last_timestamp = parcel->uptime;
-                    }
-                }
-            }; break;
-            case SDL_MOUSEMOTION: this->on_mouse_event(e.motion); break;
-            case SDL_MOUSEWHEEL: this->on_mouse_event(e.wheel); break;
-            case SDL_MOUSEBUTTONUP: this->on_mouse_event(e.button, false); break;
-            case SDL_MOUSEBUTTONDOWN: this->on_mouse_event(e.button, true);  break;
-            case SDL_KEYUP: this->on_keyboard_event(e.key, false); break;
-            case SDL_KEYDOWN: this->on_keyboard_event(e.key, true); break;
-            case SDL_TEXTINPUT: this->on_user_input(e.text.text); break;
-            case SDL_TEXTEDITING: this->on_editing(e.edit.text, e.edit.start, e.edit.length); break;
-            case SDL_WINDOWEVENT: {
-                switch (e.window.event) {
-                case SDL_WINDOWEVENT_RESIZED: this->on_resize(e.window.data1, e.window.data2); break;
-                }
-            }; break;
-            case SDL_QUIT: {
-                if (this->timer > 0UL) {
-                    SDL_RemoveTimer(this->timer); // 停止定时器
-                    this->timer = 0;
+/**
+ * 排空事件队列，在同一个更新序列中处理，因此每一批事件最多重绘一次
+ * 连续的鼠标移动事件和滚轮事件会被合并，累加位移
+ */
+void Plteen::IUniverse::pump_events(SDL_Event& e, uint32_t* quit_time) {
+    SDL_Event batch[event_batch_size];
+    SDL_Event pending = e;
+    size_t requested = 0U;
+    int n = 0;
+
+    do {
+        n = SDL_PeepEvents(batch, int(event_batch_size), SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+        if (n < 0) {
+            this->log_message(Log::Error, make_nstring("failed to peep events: %s", SDL_GetError()));
+            n = 0;
+        }
+
+        for (int idx = 0; idx < n; idx ++) {
+            if (coalesce_event(pending, batch[idx])) {
+                this->coalesced_events += 1U;
+            } else {
+                uint64_t requests = this->update_request_count();
+
+                this->dispatch_event(pending, quit_time);
+                pending = batch[idx];
+
+                if (this->update_request_count() > requests) {
+                    requested += 1U;
                 }
+            }
+        }
+    } while ((n == int(event_batch_size)) && ((*quit_time) == 0UL));
+
+    { // the last one
+        uint64_t requests = this->update_request_count();
+
+        this->dispatch_event(pending, quit_time);
+
+        if (this->update_request_count() > requests) {
+            requested += 1U;
+        }
+    }
+
+    if (requested > 1U) {
+        this->avoided_redraws += requested - 1U;
+    }
+}
+
+void Plteen::IUniverse::dispatch_event(SDL_Event& e, uint32_t* quit_time) {
+    // 退出之后的事件不再处理
+    if ((*quit_time) > 0UL) return;
 
-                quit_time = e.quit.timestamp;
-            }; break;
+    switch (e.type) {
+    case SDL_USEREVENT: {       // 定时器到期通知，更新游戏
+        auto parcel = reinterpret_cast<timer_parcel_t*>(e.user.data1);
+
+        if (e.user.code != 0) {  // 其他线程的唤醒通知
+            this->on_wakeup(e.user);
+        } else if (parcel->universe == this) {
+            /** TODO
+             * Is SDL2 really pumping duplicate events?
+             * Why the first `count` is much larger then 1?
+             */
+            if (parcel->last_timestamp != parcel->uptime) {
+                this->on_elapse(parcel->count, parcel->interval, parcel->uptime);
+                parcel->last_timestamp = parcel->uptime;
             }
-   
-            this->end_update_sequence();
-        } else {
-            this->log_message(Log::Error, make_nstring("failed to pop the event: %s", SDL_GetError()));
         }
+    }; break;
+    case SDL_MOUSEMOTION: this->on_mouse_event(e.motion); break;
+    case SDL_MOUSEWHEEL: this->on_mouse_event(e.wheel); break;
+    case SDL_MOUSEBUTTONUP: this->on_mouse_event(e.button, false); break;
+    case SDL_MOUSEBUTTONDOWN: this->on_mouse_event(e.button, true);  break;
+    case SDL_KEYUP: this->on_keyboard_event(e.key, false); break;
+    case SDL_KEYDOWN: this->on_keyboard_event(e.key, true); break;
+    case SDL_TEXTINPUT: this->on_user_input(e.text.text); break;
+    case SDL_TEXTEDITING: this->on_editing(e.edit.text, e.edit.start, e.edit.length); break;
+    case SDL_WINDOWEVENT: {
+        switch (e.window.event) {
+        case SDL_WINDOWEVENT_RESIZED: this->on_resize(e.window.data1, e.window.data2); break;
+        }
+    }; break;
+    case SDL_QUIT: {
+        if (this->timer > 0UL) {
+            SDL_RemoveTimer(this->timer); // 停止定时器
+            this->timer = 0;
+        }
+
+        (*quit_time) = e.quit.timestamp;
+    }; break;
     }
 }
 
@@ -520,6 +628,12 @@ void Plteen::IUniverse::toggle_window_fullscreen() {
 
 void Plteen::IUniverse::refresh() {
     this->do_redraw(this->device, 0, 0, this->window_width, this->window_height);
+
+    if ((this->encoder != nullptr) && this->encoder->is_recording()) {
+        // the frame is still in the target texture
+        this->encoder->record_frame(this->device, this->window_width, this->window_height);
+    }
+
     this->device->refresh(this->texture);
 }
 
@@ -636,13 +750,49 @@ void Plteen::IUniverse::take_snapshot() {
     path snapshot_png = (this->snapshot_rootdir.empty() ? current_path() : path(this->snapshot_rootdir))
         / path(make_nstring("%s-%s.png", basename, make_now_timestamp_utc(true).c_str()));
 
-    if (this->save_snapshot(snapshot_png.string().c_str())) { // stupid windows as it requires `string()`
-        this->log_message(Log::Info, make_nstring("A snapshot has been saved as '%s'.", snapshot_png.string().c_str()));
-    } else {
-        this->log_message(Log::Error, make_nstring("failed to save snapshot: %s", SDL_GetError()));
+    // stupid windows as it requires `string()`
+    if (!this->frame_encoder()->save_snapshot(this->device, this->window_width, this->window_height, snapshot_png.string())) {
+        this->log_message(Log::Error, make_nstring("failed to take snapshot: %s", SDL_GetError()));
     }
 }
 
+void Plteen::IUniverse::report_snapshots() {
+    std::string snapshot_png;
+    bool okay;
+
+    if (this->encoder != nullptr) {
+        while (this->encoder->poll_snapshot(&snapshot_png, &okay)) {
+            if (okay) {
+                this->log_message(Log::Info, make_nstring("A snapshot has been saved as '%s'.", snapshot_png.c_str()));
+            } else {
+                this->log_message(Log::Error, make_nstring("failed to save snapshot '%s'", snapshot_png.c_str()));
+            }
+        }
+    }
+}
+
+void Plteen::IUniverse::set_snapshot_compression(PNGCompression level) {
+    this->frame_encoder()->set_compression(level);
+}
+
+void Plteen::IUniverse::start_recording(const std::string& path, RecordingFormat format) {
+    this->frame_encoder()->start_recording(path, format, this->_fps);
+}
+
+void Plteen::IUniverse::stop_recording() {
+    if (this->encoder != nullptr) {
+        this->encoder->stop_recording();
+    }
+}
+
+FrameEncoder* Plteen::IUniverse::frame_encoder() {
+    if (this->encoder == nullptr) {
+        this->encoder = new FrameEncoder();
+    }
+
+    return this->encoder;
+}
+
 void Plteen::IUniverse::set_snapshot_folder(const char* dir) {
     this->set_snapshot_folder(std::string(dir));
 }
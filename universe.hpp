@@ -7,6 +7,7 @@
 
 #include "graphics/dc.hpp"
 #include "graphics/font.hpp"
+#include "graphics/encoder.hpp"
 #include "physics/color/rgba.hpp"
 #include "virtualization/display.hpp"
 
@@ -45,6 +46,17 @@ namespace Plteen {
         void set_usrdata_folder(const std::string& path);
         SDL_Surface* snapshot() override;
         Plteen::dc_t* drawing_context() override;
+
+    public: // 屏幕截图和录屏，在工作线程中编码
+        void set_snapshot_compression(Plteen::PNGCompression level);
+        void start_recording(const std::string& path, Plteen::RecordingFormat format = RecordingFormat::PNG);
+        void stop_recording();
+        bool is_recording() { return (this->encoder != nullptr) && this->encoder->is_recording(); }
+        uint64_t dropped_frame_count() { return (this->encoder == nullptr) ? 0U : this->encoder->dropped_frame_count(); }
+
+    public: // 事件合并统计
+        uint64_t coalesced_event_count() { return this->coalesced_events; }
+        uint64_t avoided_redraw_count() { return this->avoided_redraws; }
         
     public: // 窗体 setter 和 getter
         void set_window_title(std::string& title);
@@ -97,6 +109,9 @@ namespace Plteen {
         /* 响应定时器事件，刷新游戏世界 */
         virtual void on_elapse(uint64_t count, uint32_t interval, uint64_t uptime) = 0;
 
+        /* 响应其他线程的唤醒事件 (code 非 0 的 SDL_USEREVENT)，默认什么都不做 */
+        virtual void on_wakeup(SDL_UserEvent& wakeup) {}
+
         /* 响应鼠标事件，并按需触发单击、右击、双击、移动、滚轮事件 */
         virtual void on_mouse_event(SDL_MouseButtonEvent& mouse, bool pressed); 
         virtual void on_mouse_event(SDL_MouseMotionEvent& mouse); 
@@ -123,6 +138,10 @@ namespace Plteen {
         int cmdline_message_yposition();
         void enter_input_text();
         void popback_input_text();
+        Plteen::FrameEncoder* frame_encoder();
+        void report_snapshots();
+        void pump_events(SDL_Event& e, uint32_t* quit_time);
+        void dispatch_event(SDL_Event& e, uint32_t* quit_time);
 
     private:
         Plteen::RGBA _fgc;                   // 窗体前景色
@@ -152,7 +171,12 @@ namespace Plteen {
 
     private:
         std::string snapshot_rootdir;        // 屏幕截图位置
+        Plteen::FrameEncoder* encoder = nullptr; // 屏幕截图编码器
         std::string usrdata_rootdir;         // 用户数据保存位置
+
+    private:
+        uint64_t coalesced_events = 0U;      // 被合并的鼠标移动和滚轮事件
+        uint64_t avoided_redraws = 0U;       // 因批处理而省去的重绘
     };
 
     class __lambda__ Universe : public Plteen::IUniverse {
@@ -23,6 +23,7 @@ bool Plteen::IDisplay::save_snapshot(const char* pname) {
 void Plteen::IDisplay::notify_updated() {
     if (this->is_in_update_sequence()) {
         this->update_is_needed = true;
+        this->update_requests += 1U;
     } else {
         this->refresh();
         this->update_is_needed = false;
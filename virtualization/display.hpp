@@ -32,6 +32,7 @@ namespace Plteen {
         void end_update_sequence();
         bool should_update() { return this->update_is_needed; }
         void notify_updated();
+        uint64_t update_request_count() { return this->update_requests; } // requests within update sequences
 
     public:
         bool save_snapshot(const std::string& path);
@@ -40,5 +41,6 @@ namespace Plteen {
     private:
         int update_sequence_depth = 0;
         bool update_is_needed = false;
+        uint64_t update_requests = 0U;
     };
 }
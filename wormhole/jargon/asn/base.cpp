@@ -217,6 +217,48 @@ size_t Plteen::asn_octets_unbox(const uint8_t* basn, size_t* offset) {
     return size;
 }
 
+const uint8_t* Plteen::asn_octets_unbox_view(const uint8_t* basn, size_t* size, size_t* offset) {
+    size_t position = ((offset == nullptr) ? 0 : (*offset));
+    size_t content_size = asn_octets_unbox(basn, &position);
+
+    SET_BOX(size, content_size);
+    SET_BOX(offset, position);
+
+    return basn + (position - content_size);
+}
+
+bool Plteen::asn_octets_bounded_unbox(const uint8_t* basn, size_t end, uint8_t tag, size_t* offset, size_t* size) {
+    size_t idx = ((offset == nullptr) ? 0 : (*offset));
+    bool okay = false;
+
+    if ((idx + 2U <= end) && (basn[idx] == tag)) {
+        size_t length = basn[idx + 1];
+        size_t content_idx = idx + 2U;
+        bool length_okay = true;
+
+        if (length > 0b10000000) {
+            size_t lsize = length & 0b01111111;
+
+            length_okay = ((lsize <= sizeof(size_t)) && (content_idx + lsize <= end));
+
+            if (length_okay) {
+                fill_integer_from_bytes(&length, basn, content_idx, content_idx + lsize, false);
+                content_idx += lsize;
+            }
+        } else if (length == 0b10000000) {
+            length_okay = false; // indefinite length is not DER
+        }
+
+        if (length_okay && (content_idx <= end) && (length <= end - content_idx)) {
+            SET_BOX(offset, content_idx + length);
+            SET_BOX(size, length);
+            okay = true;
+        }
+    }
+
+    return okay;
+}
+
 /*************************************************************************************************/
 octets Plteen::asn_boolean_to_octets(bool b) {
     octets bbool(3, '\0');
@@ -543,6 +585,13 @@ std::string Plteen::asn_octets_to_ia5(const uint8_t* bia5, size_t* offset0) {
     return std::string(reinterpret_cast<const char*>(bia5 + (offset - size)), size);
 }
 
+std::string_view Plteen::asn_octets_to_ia5_view(const uint8_t* bia5, size_t* offset) {
+    size_t size = 0U;
+    const uint8_t* content = asn_octets_unbox_view(bia5, &size, offset);
+
+    return std::string_view(reinterpret_cast<const char*>(content), size);
+}
+
 size_t Plteen::asn_utf8_span(const std::string& str) {
     return str.size();
 }
@@ -574,3 +623,10 @@ std::string Plteen::asn_octets_to_utf8(const uint8_t* butf8, size_t* offset0) {
 
     return std::string(reinterpret_cast<const char*>(butf8 + (offset - size)), size);
 }
+
+std::string_view Plteen::asn_octets_to_utf8_view(const uint8_t* butf8, size_t* offset) {
+    size_t size = 0U;
+    const uint8_t* content = asn_octets_unbox_view(butf8, &size, offset);
+
+    return std::string_view(reinterpret_cast<const char*>(content), size);
+}
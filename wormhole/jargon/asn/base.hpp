@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <cinttypes>
 
 #include "../../../datum/natural.hpp"
@@ -24,6 +25,8 @@ namespace Plteen {
     __lambda__ Plteen::octets asn_octets_box(uint8_t tag, const Plteen::octets& content, size_t size);
     __lambda__ size_t asn_octets_unbox(const uint8_t* basn, size_t* offset = nullptr);
     __lambda__ inline size_t asn_octets_unbox(const Plteen::octets& basn, size_t* offset = nullptr) { return asn_octets_unbox(basn.c_str(), offset); }
+    __lambda__ const uint8_t* asn_octets_unbox_view(const uint8_t* basn, size_t* size, size_t* offset = nullptr);
+    __lambda__ bool asn_octets_bounded_unbox(const uint8_t* basn, size_t end, uint8_t tag, size_t* offset, size_t* size = nullptr);
     __lambda__ Plteen::octets asn_int64_to_octets(int64_t integer, Plteen::ASNPrimitive id = ASNPrimitive::Integer);
     __lambda__ size_t asn_int64_into_octets(int64_t integer, uint8_t* octets, size_t offset, Plteen::ASNPrimitive id = ASNPrimitive::Integer);
 
@@ -64,12 +67,16 @@ namespace Plteen {
     __lambda__ size_t asn_ia5_into_octets(const std::string& ia5_str, uint8_t* octets, size_t offset = 0);
     __lambda__ std::string asn_octets_to_ia5(const uint8_t* bia5, size_t* offset = nullptr);
     __lambda__ inline std::string asn_octets_to_ia5(const Plteen::octets& bia5, size_t* offset = nullptr) { return asn_octets_to_ia5(bia5.c_str(), offset); }
+    __lambda__ std::string_view asn_octets_to_ia5_view(const uint8_t* bia5, size_t* offset = nullptr);
 
     __lambda__ size_t asn_utf8_span(const std::string& nstr);
     __lambda__ Plteen::octets asn_utf8_to_octets(const std::string& nstr);
     __lambda__ size_t asn_utf8_into_octets(const std::string& nstr, uint8_t* octets, size_t offset = 0);
     __lambda__ std::string asn_octets_to_utf8(const uint8_t* butf8, size_t* offset = nullptr);
     __lambda__ inline std::string asn_octets_to_utf8(const Plteen::octets& butf8, size_t* offset = nullptr) { return asn_octets_to_utf8(butf8.c_str(), offset); }
+    __lambda__ std::string_view asn_octets_to_utf8_view(const uint8_t* butf8, size_t* offset = nullptr);
+
+    // NOTE: `asn_octets_to_xxx_view` returns views into the input octets, which must outlive the views.
 
     __lambda__ inline size_t asn_span(size_t payload_span) { return 1 + asn_length_span(payload_span) + payload_span; }
 
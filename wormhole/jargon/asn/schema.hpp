@@ -0,0 +1,384 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+#include <string_view>
+#include <type_traits>
+
+#include "base.hpp"
+#include "identifier.hpp"
+#include "enumerated.hpp"
+
+/**
+ * Compile-time counterpart of `IASNSequence`
+ *
+ * A message declares its fields as a list of field specs,
+ *   say, `ASNSchema<ASNFixnum, ASNFlonum, ASNUTF8>`,
+ *   and the values are stored in a plain `std::tuple`.
+ *
+ * Spans, encoder and decoder are instantiated per message type,
+ *   no virtual calls, spans of fixed-size fields are folded into constants.
+ *
+ * The encoder measures the tree once, and writes it backwards,
+ *   so that nested sequences are never re-measured.
+ * The decoder checks tags and boundaries before reading anything.
+ */
+
+namespace Plteen {
+    struct ASNBoolean {};
+    struct ASNNull {};
+    struct ASNFixnum {};
+    struct ASNFlonum {};
+    struct ASNNatural {};
+    struct ASNUTF8 {};
+    struct ASNUTF8View {}; // decodes as a view into the input octets
+    struct ASNIA5 {};
+    template<typename E> struct ASNEnum {};
+    template<typename... Fields> class ASNSchema;
+
+    /*********************************************************************************************/
+    template<typename Spec> struct ASNFieldCodec;
+
+    template<typename T, typename Span, typename Into>
+    inline size_t asn_field_backward(const T& v, uint8_t* octets, size_t end, Span span, Into into) {
+        size_t start = end - asn_span(span(v));
+
+        into(v, octets, start);
+
+        return start;
+    }
+
+    template<>
+    struct ASNFieldCodec<ASNBoolean> {
+        typedef bool value_type;
+        static constexpr size_t fixed_span = 3U;
+
+        static size_t span(const bool& v) { return fixed_span; }
+
+        static size_t backward(const bool& v, uint8_t* octets, size_t end) {
+            asn_boolean_into_octets(v, octets, end - fixed_span);
+            return end - fixed_span;
+        }
+
+        static bool from(const uint8_t* basn, size_t end, size_t* offset, bool* v) {
+            size_t cursor = (*offset);
+            size_t size = 0U;
+            bool okay = asn_octets_bounded_unbox(basn, end, asn_primitive_identifier_octet(ASNPrimitive::Boolean), &cursor, &size)
+                            && (size == 1U);
+
+            if (okay) {
+                (*v) = asn_octets_to_boolean(basn, offset);
+            }
+
+            return okay;
+        }
+    };
+
+    template<>
+    struct ASNFieldCodec<ASNNull> {
+        typedef std::nullptr_t value_type;
+        static constexpr size_t fixed_span = 2U;
+
+        static size_t span(const std::nullptr_t& v) { return fixed_span; }
+
+        static size_t backward(const std::nullptr_t& v, uint8_t* octets, size_t end) {
+            asn_null_into_octets(nullptr, octets, end - fixed_span);
+            return end - fixed_span;
+        }
+
+        static bool from(const uint8_t* basn, size_t end, size_t* offset, std::nullptr_t* v) {
+            size_t size = 0U;
+
+            return asn_octets_bounded_unbox(basn, end, asn_primitive_identifier_octet(ASNPrimitive::Null), offset, &size)
+                    && (size == 0U);
+        }
+    };
+
+    template<>
+    struct ASNFieldCodec<ASNFixnum> {
+        typedef int64_t value_type;
+        static constexpr size_t fixed_span = 0U;
+
+        static size_t span(const int64_t& v) { return asn_span(asn_fixnum_span(v)); }
+
+        static size_t backward(const int64_t& v, uint8_t* octets, size_t end) {
+            return asn_field_backward(v, octets, end, asn_fixnum_span, asn_fixnum_into_octets);
+        }
+
+        static bool from(const uint8_t* basn, size_t end, size_t* offset, int64_t* v) {
+            size_t cursor = (*offset);
+            size_t size = 0U;
+            bool okay = asn_octets_bounded_unbox(basn, end, asn_primitive_identifier_octet(ASNPrimitive::Integer), &cursor, &size)
+                            && (size > 0U) && (size <= sizeof(int64_t));
+
+            if (okay) {
+                (*v) = asn_octets_to_fixnum(basn, offset);
+            }
+
+            return okay;
+        }
+    };
+
+    template<typename E>
+    struct ASNFieldCodec<ASNEnum<E>> {
+        typedef E value_type;
+        static constexpr size_t fixed_span = 0U;
+
+        static size_t span(const E& v) { return asn_span(asn_enum_span(v)); }
+
+        static size_t backward(const E& v, uint8_t* octets, size_t end) {
+            size_t start = end - span(v);
+
+            asn_enum_into_octets(v, octets, start);
+
+            return start;
+        }
+
+        static bool from(const uint8_t* basn, size_t end, size_t* offset, E* v) {
+            size_t cursor = (*offset);
+            size_t size = 0U;
+            bool okay = asn_octets_bounded_unbox(basn, end, asn_primitive_identifier_octet(ASNPrimitive::Enumerated), &cursor, &size)
+                            && (size > 0U) && (size <= sizeof(int64_t));
+
+            if (okay) {
+                (*v) = asn_octets_to_enum<E>(basn, offset);
+            }
+
+            return okay;
+        }
+    };
+
+    template<>
+    struct ASNFieldCodec<ASNFlonum> {
+        typedef double value_type;
+        static constexpr size_t fixed_span = 0U;
+
+        static size_t span(const double& v) { return asn_span(asn_flonum_span(v)); }
+
+        static size_t backward(const double& v, uint8_t* octets, size_t end) {
+            return asn_field_backward(v, octets, end, asn_flonum_span, asn_flonum_into_octets);
+        }
+
+        static bool from(const uint8_t* basn, size_t end, size_t* offset, double* v) {
+            size_t cursor = (*offset);
+            size_t size = 0U;
+            bool okay = asn_octets_bounded_unbox(basn, end, asn_primitive_identifier_octet(ASNPrimitive::Real), &cursor, &size);
+
+            if (okay && (size > 0U)) {
+                uint8_t infoctet = basn[cursor - size];
+
+                // the exponent length octet of the binary encoding
+                if (((infoctet & 0b10000000) > 0U) && ((infoctet & 0b11) == 0b11)) {
+                    okay = (size >= 2U) && (basn[cursor - size + 1] <= size - 2U);
+                } else {
+                    okay = (size <= 1U + sizeof(int64_t) * 2U);
+                }
+            }
+
+            if (okay) {
+                (*v) = asn_octets_to_flonum(basn, offset);
+            }
+
+            return okay;
+        }
+    };
+
+    template<>
+    struct ASNFieldCodec<ASNNatural> {
+        typedef Plteen::Natural value_type;
+        static constexpr size_t fixed_span = 0U;
+
+        static size_t span(const Natural& v) { return asn_span(asn_natural_span(const_cast<Natural&>(v))); }
+
+        static size_t backward(const Natural& v, uint8_t* octets, size_t end) {
+            size_t start = end - span(v);
+
+            asn_natural_into_octets(const_cast<Natural&>(v), octets, start);
+
+            return start;
+        }
+
+        static bool from(const uint8_t* basn, size_t end, size_t* offset, Natural* v) {
+            size_t cursor = (*offset);
+            bool okay = asn_octets_bounded_unbox(basn, end, asn_primitive_identifier_octet(ASNPrimitive::Integer), &cursor);
+
+            if (okay) {
+                (*v) = asn_octets_to_natural(basn, offset);
+            }
+
+            return okay;
+        }
+    };
+
+    template<ASNPrimitive id, typename S>
+    struct ASNStringCodec {
+        typedef S value_type;
+        static constexpr size_t fixed_span = 0U;
+
+        static size_t span(const S& v) { return asn_span(v.size()); }
+
+        static size_t backward(const S& v, uint8_t* octets, size_t end) {
+            size_t size = v.size();
+            size_t start = end - asn_span(size);
+
+            octets[start] = asn_primitive_identifier_octet(id);
+            memcpy(octets + asn_length_into_octets(size, octets, start + 1), v.data(), size);
+
+            return start;
+        }
+
+        static bool from(const uint8_t* basn, size_t end, size_t* offset, S* v) {
+            size_t size = 0U;
+            bool okay = asn_octets_bounded_unbox(basn, end, asn_primitive_identifier_octet(id), offset, &size);
+
+            if (okay) {
+                (*v) = S(reinterpret_cast<const char*>(basn + ((*offset) - size)), size);
+            }
+
+            return okay;
+        }
+    };
+
+    template<> struct ASNFieldCodec<ASNUTF8> : public ASNStringCodec<ASNPrimitive::UTF8_String, std::string> {};
+    template<> struct ASNFieldCodec<ASNUTF8View> : public ASNStringCodec<ASNPrimitive::UTF8_String, std::string_view> {};
+    template<> struct ASNFieldCodec<ASNIA5> : public ASNStringCodec<ASNPrimitive::IA5_String, std::string> {};
+
+    template<typename... Fields>
+    struct ASNFieldCodec<ASNSchema<Fields...>> {
+        typedef ASNSchema<Fields...> value_type;
+        static constexpr size_t fixed_span = value_type::fixed_octets_span;
+
+        static size_t span(const value_type& v) { return v.octets_span(); }
+        static size_t backward(const value_type& v, uint8_t* octets, size_t end) { return v.backward(octets, end); }
+        static bool from(const uint8_t* basn, size_t end, size_t* offset, value_type* v) { return v->decode(basn, end, offset); }
+    };
+
+    /*********************************************************************************************/
+    template<typename... Fields>
+    class ASNSchema {
+    public:
+        typedef std::tuple<typename ASNFieldCodec<Fields>::value_type...> tuple_type;
+        static constexpr size_t field_count = sizeof...(Fields);
+        static constexpr bool is_fixed = ((ASNFieldCodec<Fields>::fixed_span > 0U) && ... && true);
+        static constexpr size_t fixed_payload_span = (ASNFieldCodec<Fields>::fixed_span + ... + 0U);
+
+        // only meaningful if all fields are fixed, the length of the sequence itself is no more than 127
+        static constexpr size_t fixed_octets_span = (is_fixed && (fixed_payload_span <= 127U)) ? (fixed_payload_span + 2U) : 0U;
+
+    public:
+        ASNSchema() = default;
+        ASNSchema(const typename ASNFieldCodec<Fields>::value_type&... values) : fields(values...) {}
+
+    public:
+        template<size_t idx> auto& field() { return std::get<idx>(this->fields); }
+        template<size_t idx> const auto& field() const { return std::get<idx>(this->fields); }
+
+    public:
+        size_t span() const {
+            if constexpr (is_fixed) {
+                return fixed_payload_span;
+            } else {
+                return fixed_payload_span + this->variable_span(std::index_sequence_for<Fields...>());
+            }
+        }
+
+        size_t octets_span() const {
+            if constexpr (fixed_octets_span > 0U) {
+                return fixed_octets_span;
+            } else {
+                return asn_span(this->span());
+            }
+        }
+
+        Plteen::octets to_octets() const {
+            size_t ospan = this->octets_span();
+            Plteen::octets basn(ospan, '\0');
+
+            this->backward(const_cast<uint8_t*>(basn.c_str()), ospan);
+
+            return basn;
+        }
+
+        /**
+         * Encodes the whole message into the caller-provided buffer.
+         * Returns the end offset, or 0 if the buffer is insufficient.
+         */
+        size_t encode(uint8_t* octets, size_t capacity, size_t offset = 0) const {
+            size_t end = offset + this->octets_span();
+
+            if (end <= capacity) {
+                this->backward(octets, end);
+            } else {
+                end = 0U;
+            }
+
+            return end;
+        }
+
+        // NOTE: this does not check the boundary, and returns the start of the encoded octets
+        size_t backward(uint8_t* octets, size_t end) const {
+            size_t start = this->fields_backward<field_count>(octets, end);
+            size_t payload = end - start;
+
+            start -= (1U + asn_length_span(payload));
+            octets[start] = asn_constructed_identifier_octet(ASNConstructed::Sequence);
+            asn_length_into_octets(payload, octets, start + 1);
+
+            return start;
+        }
+
+    public:
+        /**
+         * Decodes the message in `[offset, end)` of `basn`.
+         * Returns false, and leaves `offset` untouched, if the octets are malformed or truncated,
+         *   fields decoded before the failure are not rolled back.
+         */
+        bool decode(const uint8_t* basn, size_t end, size_t* offset = nullptr) {
+            size_t cursor = ((offset == nullptr) ? 0U : (*offset));
+            size_t size = 0U;
+            bool okay = asn_octets_bounded_unbox(basn, end, asn_constructed_identifier_octet(ASNConstructed::Sequence), &cursor, &size);
+
+            if (okay) {
+                size_t position = cursor - size;
+
+                okay = this->fields_from(basn, cursor, &position, std::index_sequence_for<Fields...>())
+                        && (position == cursor);
+            }
+
+            if (okay && (offset != nullptr)) {
+                (*offset) = cursor;
+            }
+
+            return okay;
+        }
+
+        bool decode(const Plteen::octets& basn, size_t* offset = nullptr) {
+            return this->decode(basn.c_str(), basn.size(), offset);
+        }
+
+    public:
+        tuple_type fields;
+
+    private:
+        template<size_t... idx>
+        size_t variable_span(std::index_sequence<idx...>) const {
+            return ((ASNFieldCodec<Fields>::fixed_span > 0U ? 0U : ASNFieldCodec<Fields>::span(std::get<idx>(this->fields))) + ... + 0U);
+        }
+
+        template<size_t n>
+        size_t fields_backward(uint8_t* octets, size_t end) const {
+            if constexpr (n == 0U) {
+                return end;
+            } else {
+                typedef ASNFieldCodec<std::tuple_element_t<n - 1U, std::tuple<Fields...>>> Codec;
+
+                return this->fields_backward<n - 1U>(octets, Codec::backward(std::get<n - 1U>(this->fields), octets, end));
+            }
+        }
+
+        template<size_t... idx>
+        bool fields_from(const uint8_t* basn, size_t end, size_t* position, std::index_sequence<idx...>) {
+            return (ASNFieldCodec<Fields>::from(basn, end, position, &std::get<idx>(this->fields)) && ... && true);
+        }
+    };
+}
@@ -1,22 +1,60 @@
 #include "sequence.hpp"
 #include "../../../datum/box.hpp"
 
+#include <atomic>
+
 using namespace Plteen;
 
+/*************************************************************************************************/
+// epochs are unique across threads, so that memos written by one thread are never taken by another
+static std::atomic<uint64_t> asn_epoch_counter { 0U };
+static thread_local uint64_t asn_encoding_epoch = 0U;
+static thread_local size_t asn_encoding_depth = 0U;
+
+namespace {
+    /**
+     * Fields are not allowed to be changed during encoding,
+     *   so, within the outermost session, each sequence is measured once.
+     */
+    struct ASNEncodingSession {
+        ASNEncodingSession() {
+            if (asn_encoding_depth == 0U) {
+                asn_encoding_epoch = asn_epoch_counter.fetch_add(1U) + 1U;
+            }
+
+            asn_encoding_depth ++;
+        }
+
+        ~ASNEncodingSession() noexcept {
+            asn_encoding_depth --;
+        }
+    };
+}
+
 /*************************************************************************************************/
 Plteen::IASNSequence::IASNSequence(size_t count) : count(count) {}
 
 size_t Plteen::IASNSequence::span() {
     size_t payload = 0;
 
-    for (size_t idx = 0; idx < this->count; idx++) {        
-        payload += asn_span(this->field_payload_span(idx));
+    if ((asn_encoding_depth > 0U) && (this->span_epoch == asn_encoding_epoch)) {
+        payload = this->span_memo;
+    } else {
+        for (size_t idx = 0; idx < this->count; idx++) {        
+            payload += asn_span(this->field_payload_span(idx));
+        }
+
+        if (asn_encoding_depth > 0U) {
+            this->span_memo = payload;
+            this->span_epoch = asn_encoding_epoch;
+        }
     }
 
     return payload;
 }
 
 octets Plteen::IASNSequence::to_octets() {
+    ASNEncodingSession session;
     size_t ospan = asn_span(this->span());
     octets basn(ospan, '\0');
 
@@ -25,7 +63,21 @@ octets Plteen::IASNSequence::to_octets() {
     return basn;
 }
 
+size_t Plteen::IASNSequence::encode(uint8_t* octets, size_t capacity, size_t offset) {
+    ASNEncodingSession session;
+    size_t end = offset + asn_span(this->span());
+
+    if (end <= capacity) {
+        end = this->into_octets(octets, offset);
+    } else {
+        end = 0U;
+    }
+
+    return end;
+}
+
 size_t Plteen::IASNSequence::into_octets(uint8_t* octets, size_t offset) {
+    ASNEncodingSession session;
     size_t pay_span = this->span();
 
     octets[offset++] = asn_constructed_identifier_octet(ASNConstructed::Sequence);
@@ -10,8 +10,16 @@ namespace Plteen {
 
     public:
         size_t span();
+        size_t octets_span() { return asn_span(this->span()); }
         Plteen::octets to_octets();
         size_t into_octets(uint8_t* octets, size_t offset = 0);
+
+        /**
+         * Encodes the whole message into the caller-provided buffer,
+         *   the tree is measured only once, no heap allocation happens here.
+         * Returns the end offset, or 0 if the buffer is insufficient.
+         */
+        size_t encode(uint8_t* octets, size_t capacity, size_t offset = 0);
         void from_octets(const uint8_t* basn, size_t* offset = nullptr);
         inline void from_octets(const Plteen::octets& basn, size_t* offset = nullptr) { this->from_octets(basn.c_str(), offset); }
 
@@ -22,5 +30,9 @@ namespace Plteen {
 
     private:
         size_t count;
+
+    private: // spans are memoized within the same encoding session, so that nested sequences are measured once
+        size_t span_memo = 0U;
+        uint64_t span_epoch = 0U;
     };
 }
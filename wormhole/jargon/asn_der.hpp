@@ -4,3 +4,4 @@
 #include "asn/identifier.hpp"
 #include "asn/enumerated.hpp"
 #include "asn/sequence.hpp"
+#include "asn/schema.hpp"
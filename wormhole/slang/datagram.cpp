@@ -32,12 +32,27 @@ const char* Plteen::UserDatagramPacket::hostname() {
     return SDLNet_ResolveIP(&this->self->address);
 }
 
+unsigned char* Plteen::UserDatagramPacket::data() {
+    return this->self->data;
+}
+
+void Plteen::UserDatagramPacket::set_received(size_t size, uint32_t host, uint16_t port) {
+    this->self->len = int(size);
+    this->self->address.host = host;
+    this->self->address.port = port;
+}
+
+uint32_t Plteen::UserDatagramPacket::host() {
+    return this->self->address.host;
+}
+
 uint16_t Plteen::UserDatagramPacket::port() {
     return this->self->address.port;
 }
 
 const unsigned char* Plteen::UserDatagramPacket::unbox(uint8_t* type, uint16_t* transaction, uint16_t* response_port, size_t* size) {
     unsigned char* payload = nullptr;
+    char host[16];
     
     if (is_slang_message(this->self->data)) {
         if (slang_message_validate(this->self->data, this->self->len)) {
@@ -57,11 +72,13 @@ const unsigned char* Plteen::UserDatagramPacket::unbox(uint8_t* type, uint16_t*
             payload = this->self->data + cursor;
             SET_BOX(size, static_cast<size_t>(this->self->len) - cursor);
         } else {
+            datagram_numeric_host(host, this->host());
         	fprintf(stderr, "%s:%d: slang message has been modified. [CHECKSUM: %x]\n",
-                    this->hostname(), this->port(), checksum_ipv4(this->self->data, 0, this->self->len));
+                    host, SDLNet_Read16(&this->self->address.port), checksum_ipv4(this->self->data, 0, this->self->len));
 		}
     } else {
-        fprintf(stderr, "%s:%d: not a slang message, ignored.\n", this->hostname(), this->port());
+        datagram_numeric_host(host, this->host());
+        fprintf(stderr, "%s:%d: not a slang message, ignored.\n", host, SDLNet_Read16(&this->self->address.port));
     }
 
     if (payload == nullptr) {
@@ -80,3 +97,151 @@ int Plteen::UserDatagramPacket::recv(UDPsocket udp) {
 
     return rsize;
 }
+
+int Plteen::UserDatagramPacket::send(UDPsocket udp, const IPaddress& target, const unsigned char* message, size_t size) {
+    int ssize = -1;
+
+    if ((this->capacity() >= size) || (this->resize(size) >= size)) {
+        memcpy(this->self->data, message, size);
+        this->self->len = int(size);
+        this->self->address = target;
+
+        if (SDLNet_UDP_Send(udp, -1, this->self) > 0) {
+            ssize = int(size);
+        }
+    }
+
+    return ssize;
+}
+
+/*************************************************************************************************/
+Plteen::DatagramLease::DatagramLease(const DatagramLease& lease) noexcept : slot(lease.slot) {
+    if (this->slot != nullptr) {
+        this->slot->refcount.fetch_add(1U, std::memory_order_relaxed);
+    }
+}
+
+Plteen::DatagramLease::DatagramLease(DatagramLease&& lease) noexcept : slot(lease.slot) {
+    lease.slot = nullptr;
+}
+
+Plteen::DatagramLease::~DatagramLease() noexcept {
+    this->reset();
+}
+
+DatagramLease& Plteen::DatagramLease::operator=(const DatagramLease& lease) noexcept {
+    if (this->slot != lease.slot) {
+        this->reset();
+        this->slot = lease.slot;
+
+        if (this->slot != nullptr) {
+            this->slot->refcount.fetch_add(1U, std::memory_order_relaxed);
+        }
+    }
+
+    return (*this);
+}
+
+DatagramLease& Plteen::DatagramLease::operator=(DatagramLease&& lease) noexcept {
+    if (this != &lease) {
+        this->reset();
+        this->slot = lease.slot;
+        lease.slot = nullptr;
+    }
+
+    return (*this);
+}
+
+uint32_t Plteen::DatagramLease::use_count() const noexcept {
+    return (this->slot == nullptr) ? 0U : this->slot->refcount.load(std::memory_order_relaxed);
+}
+
+void Plteen::DatagramLease::reset() noexcept {
+    if (this->slot != nullptr) {
+        // the last owner hands the slot back, `acquire_release` publishes the reading of payload
+        this->slot->refcount.fetch_sub(1U, std::memory_order_acq_rel);
+        this->slot = nullptr;
+    }
+}
+
+/*************************************************************************************************/
+Plteen::UserDatagramPool::UserDatagramPool(size_t packet_size, size_t slot_count) : packet_size(packet_size) {
+    this->count = (slot_count == 0U) ? 1U : slot_count;
+    this->slots = new UserDatagramSlot[this->count];
+
+    for (size_t idx = 0; idx < this->count; idx++) {
+        this->slots[idx].packet = new UserDatagramPacket(packet_size);
+    }
+}
+
+Plteen::UserDatagramPool::~UserDatagramPool() noexcept {
+    for (size_t idx = 0; idx < this->count; idx++) {
+        delete this->slots[idx].packet;
+    }
+
+    delete [] this->slots;
+}
+
+UserDatagramSlot* Plteen::UserDatagramPool::acquire() {
+    UserDatagramSlot* slot = nullptr;
+
+    /**
+     * Only the network thread acquires, it starts from where it left last time,
+     *   hence it's usually the very first slot to be checked.
+     */
+    for (size_t n = 0; n < this->count; n++) {
+        UserDatagramSlot* self = &this->slots[(this->cursor + n) % this->count];
+        uint32_t idle = 0U;
+
+        if (self->refcount.compare_exchange_strong(idle, 1U, std::memory_order_acquire, std::memory_order_relaxed)) {
+            size_t size = this->packet_size.load(std::memory_order_relaxed);
+
+            if (self->packet->capacity() != size) {
+                self->packet->resize(size);
+            }
+
+            this->cursor = (this->cursor + n + 1) % this->count;
+            slot = self;
+            break;
+        }
+    }
+
+    return slot;
+}
+
+void Plteen::UserDatagramPool::release(UserDatagramSlot* slot) {
+    if (slot != nullptr) {
+        slot->refcount.fetch_sub(1U, std::memory_order_acq_rel);
+    }
+}
+
+shared_datagram_t Plteen::UserDatagramPool::lease(UserDatagramSlot* slot) {
+    return DatagramLease(slot);
+}
+
+size_t Plteen::UserDatagramPool::resize(size_t new_size) {
+    // leased packets are resized the next time they are acquired
+    this->packet_size.store(new_size, std::memory_order_relaxed);
+
+    return new_size;
+}
+
+size_t Plteen::UserDatagramPool::available() {
+    size_t n = 0;
+
+    for (size_t idx = 0; idx < this->count; idx++) {
+        if (this->slots[idx].refcount.load(std::memory_order_relaxed) == 0U) {
+            n++;
+        }
+    }
+
+    return n;
+}
+
+/*************************************************************************************************/
+void Plteen::datagram_numeric_host(char (&host)[16], uint32_t ipv4) {
+    // `ipv4` is in network byte order, so its bytes are already in the dotted order
+    const uint8_t* octets = reinterpret_cast<const uint8_t*>(&ipv4);
+
+    snprintf(host, sizeof(host), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+}
@@ -2,20 +2,20 @@
 
 #include <SDL2/SDL_net.h>
 #include <string>
-#include <memory>
+#include <atomic>
 
 namespace Plteen {
     struct __lambda__ Datagram {
         int64_t timestamp;
-        const char* remote_host;
+        uint32_t remote_ipv4;   // network byte order, the same as `IPaddress::host`
+        char remote_host[16];   // numeric dotted-quad, no reverse DNS on the receiving path
+        uint16_t remote_port;
         uint16_t respond_port;
         uint16_t transaction;
         const unsigned char* payload;
         size_t payload_size;
     };
 
-    typedef std::shared_ptr<Datagram> shared_datagram_t;
-
     /*********************************************************************************************/
     class __lambda__ UserDatagramPacket {
     public:
@@ -24,6 +24,11 @@ namespace Plteen {
 
     public:
         int recv(UDPsocket udp);
+        int send(UDPsocket udp, const IPaddress& target, const unsigned char* message, size_t size);
+
+    public: // for receivers that fill the buffer on their own, say, `recvmmsg`
+        unsigned char* data();
+        void set_received(size_t size, uint32_t host, uint16_t port);
 
     public:
         const unsigned char* unbox(uint8_t* type, uint16_t* transaction, uint16_t* response_port, size_t* size);
@@ -32,9 +37,83 @@ namespace Plteen {
         size_t capacity();
         size_t resize(size_t new_size);
         const char* hostname();
+        uint32_t host();
         uint16_t port();
 
     private:
         UDPpacket* self;
     };
+
+    /*********************************************************************************************/
+    struct __lambda__ UserDatagramSlot {
+        Plteen::UserDatagramPacket* packet = nullptr;
+        Plteen::Datagram datagram;
+        std::atomic<uint32_t> refcount { 0U };
+    };
+
+    /**
+     * A refcounted handle to a pooled datagram,
+     *   the payload stays valid until the last handle is gone,
+     *   after that the slot goes back to the pool silently.
+     *
+     * NOTE: handles must not outlive the daemon that owns the pool.
+     */
+    class __lambda__ DatagramLease {
+    public:
+        DatagramLease() noexcept : slot(nullptr) {}
+        DatagramLease(const Plteen::DatagramLease& lease) noexcept;
+        DatagramLease(Plteen::DatagramLease&& lease) noexcept;
+        ~DatagramLease() noexcept;
+
+    public:
+        Plteen::DatagramLease& operator=(const Plteen::DatagramLease& lease) noexcept;
+        Plteen::DatagramLease& operator=(Plteen::DatagramLease&& lease) noexcept;
+
+    public:
+        Plteen::Datagram* operator->() const noexcept { return &this->slot->datagram; }
+        Plteen::Datagram& operator*() const noexcept { return this->slot->datagram; }
+        explicit operator bool() const noexcept { return this->slot != nullptr; }
+        uint32_t use_count() const noexcept;
+        void reset() noexcept;
+
+    private:
+        friend class UserDatagramPool;
+        DatagramLease(Plteen::UserDatagramSlot* slot) noexcept : slot(slot) {} // adopts the reference
+
+    private:
+        Plteen::UserDatagramSlot* slot;
+    };
+
+    typedef DatagramLease shared_datagram_t;
+
+    /*********************************************************************************************/
+    class __lambda__ UserDatagramPool {
+    public:
+        UserDatagramPool(size_t packet_size = 512, size_t slot_count = 64);
+        virtual ~UserDatagramPool() noexcept;
+
+    public:
+        /**
+         * Lock-free, the network thread acquires slots and any thread may release them.
+         * Returns `nullptr` if all slots are leased.
+         */
+        Plteen::UserDatagramSlot* acquire();
+        void release(Plteen::UserDatagramSlot* slot);
+        Plteen::shared_datagram_t lease(Plteen::UserDatagramSlot* slot);
+
+    public:
+        size_t size() { return this->count; }
+        size_t capacity() { return this->packet_size; }
+        size_t resize(size_t new_size);
+        size_t available();
+
+    private:
+        Plteen::UserDatagramSlot* slots;
+        size_t count;
+        size_t cursor = 0;
+        std::atomic<size_t> packet_size;
+    };
+
+    /*********************************************************************************************/
+    __lambda__ void datagram_numeric_host(char (&host)[16], uint32_t ipv4);
 }
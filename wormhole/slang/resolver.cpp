@@ -0,0 +1,159 @@
+#include "resolver.hpp"
+#include "datagram.hpp"
+#include "network.hpp"
+
+#include "../../datum/box.hpp"
+#include "../../datum/time.hpp"
+
+#include <SDL2/SDL_net.h>
+
+using namespace Plteen;
+
+/*************************************************************************************************/
+Plteen::HostnameResolver::HostnameResolver(long long ttl_ms, size_t capacity) : ttl(ttl_ms), capacity(capacity) {
+    network_initialize();
+
+    if (this->capacity == 0U) {
+        this->capacity = 1U;
+    }
+}
+
+Plteen::HostnameResolver::~HostnameResolver() noexcept {
+    if (this->worker != nullptr) {
+        {
+            std::unique_lock<std::mutex> guard(this->lock);
+            
+            this->stopping = true;
+        }
+
+        this->wakeup.notify_one();
+        this->worker->join();
+        delete this->worker;
+    }
+}
+
+/*************************************************************************************************/
+bool Plteen::HostnameResolver::lookup(uint32_t ipv4, std::string* hostname) {
+    std::unique_lock<std::mutex> guard(this->lock);
+    auto it = this->entries.find(ipv4);
+    bool okay = false;
+
+    if ((it != this->entries.end()) && it->second.resolved) {
+        SET_BOX(hostname, it->second.hostname);
+        okay = true;
+
+        if (!it->second.refreshing && (it->second.expiration < current_milliseconds())) {
+            // serve the stale name, and refresh it in the background
+            it->second.refreshing = true;
+            this->requests.push_back(ipv4);
+            this->wakeup.notify_one();
+        }
+    }
+
+    guard.unlock();
+
+    if (!okay) {
+        this->prefetch(ipv4);
+    }
+
+    return okay;
+}
+
+void Plteen::HostnameResolver::prefetch(uint32_t ipv4) {
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    if (this->entries.find(ipv4) == this->entries.end()) {
+        if (this->entries.size() >= this->capacity) {
+            this->evict_oldest();
+        }
+
+        this->entries[ipv4].timestamp = current_milliseconds();
+        this->requests.push_back(ipv4);
+
+        if (this->worker == nullptr) {
+            this->worker = new std::thread(&HostnameResolver::resolve_loop, this);
+        }
+
+        this->wakeup.notify_one();
+    }
+}
+
+size_t Plteen::HostnameResolver::size() {
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    return this->entries.size();
+}
+
+/*************************************************************************************************/
+void Plteen::HostnameResolver::resolve_loop() {
+    std::unique_lock<std::mutex> guard(this->lock);
+
+    while (!this->stopping) {
+        if (this->requests.empty()) {
+            this->wakeup.wait(guard);
+        } else {
+            uint32_t ipv4 = this->requests.front();
+            IPaddress addr;
+            std::string name;
+            
+            this->requests.pop_front();
+
+            if (this->entries.find(ipv4) == this->entries.end()) {
+                continue;
+            }
+
+            guard.unlock();
+
+            addr.host = ipv4;
+            addr.port = 0;
+
+            /* the blocking part, `SDLNet_ResolveIP` is only called by this thread */ {
+                const char* resolved = SDLNet_ResolveIP(&addr);
+
+                if (resolved != nullptr) {
+                    name = resolved;
+                } else {
+                    char host[16];
+
+                    datagram_numeric_host(host, ipv4);
+                    name = host;
+                }
+            }
+
+            guard.lock();
+
+            auto it = this->entries.find(ipv4);
+
+            if (it != this->entries.end()) {
+                it->second.hostname = name;
+                it->second.timestamp = current_milliseconds();
+                it->second.expiration = it->second.timestamp + this->ttl;
+                it->second.resolved = true;
+                it->second.refreshing = false;
+            }
+        }
+    }
+}
+
+void Plteen::HostnameResolver::evict_oldest() {
+    auto victim = this->entries.end();
+
+    // pending ones included, or a flood of unresolvable addresses would never be bounded
+    for (auto it = this->entries.begin(); it != this->entries.end(); it++) {
+        if ((victim == this->entries.end()) || (it->second.timestamp < victim->second.timestamp)) {
+            victim = it;
+        }
+    }
+
+    if (victim != this->entries.end()) {
+        // every queued request has its entry, so that the queue is bounded as well
+        for (auto it = this->requests.begin(); it != this->requests.end(); it++) {
+            if ((*it) == victim->first) {
+                this->requests.erase(it);
+                break;
+            }
+        }
+
+        this->entries.erase(victim);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace Plteen {
+    /**
+     * Reverse DNS off the receiving path,
+     *   lookups never block, misses are resolved by a background thread,
+     *   and the names are kept for `ttl_ms` milliseconds.
+     *
+     * Stale names are still served while they are being refreshed,
+     *   at most `capacity` addresses are cached, the least recent one goes first, resolved or not.
+     */
+    class __lambda__ HostnameResolver {
+    public:
+        HostnameResolver(long long ttl_ms = 300000LL, size_t capacity = 256U);
+        virtual ~HostnameResolver() noexcept;
+
+    public:
+        bool lookup(uint32_t ipv4, std::string* hostname);
+        void prefetch(uint32_t ipv4);
+        size_t size();
+
+    private:
+        void resolve_loop();
+        void evict_oldest();
+
+    private:
+        struct Entry {
+            std::string hostname;
+            long long expiration = 0LL;
+            long long timestamp = 0LL;  // requested or resolved
+            bool resolved = false;
+            bool refreshing = false;
+        };
+
+    private:
+        std::map<uint32_t, Entry> entries;
+        std::deque<uint32_t> requests;
+        std::mutex lock;
+        std::condition_variable wakeup;
+        std::thread* worker = nullptr;
+        bool stopping = false;
+
+    private:
+        long long ttl;
+        size_t capacity;
+    };
+}
@@ -3,10 +3,46 @@
 
 #include "../../datum/time.hpp"
 
+#include <algorithm>
+
+/**
+ * SDL_net does not expose the underlying descriptor,
+ *   the leading fields of its private `struct _UDPsocket` (SDLnetUDP.c) are mirrored below,
+ *   which are only trusted for the pinned versions, 2.0 through 2.2,
+ *   others fall back to `SDLNet_UDP_Recv` and `SDLNet_UDP_Send`.
+ */
+#if defined(__linux__) && defined(SDL_NET_MAJOR_VERSION) && (SDL_NET_MAJOR_VERSION == 2) && (SDL_NET_MINOR_VERSION <= 2)
+#define __udp_mmsg__
+#endif
+
+#if defined(__udp_mmsg__)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
 using namespace Plteen;
 
 /*************************************************************************************************/
-Plteen::IUDPDaemon::IUDPDaemon(IUDPLocalPeer* peer, uint16_t port, int packet_size) {
+#if defined(__udp_mmsg__)
+static const size_t udp_mmsg_max_batch = 64U;
+
+struct sdlnet_udpsocket_prefix {
+    int ready;
+    int channel;
+};
+
+static inline int udp_socket_descriptor(UDPsocket udp) {
+    return reinterpret_cast<sdlnet_udpsocket_prefix*>(udp)->channel;
+}
+
+static inline void udp_socket_consumed(UDPsocket udp) {
+    // what `SDLNet_UDP_Recv` does, otherwise `SDLNet_SocketReady` keeps reporting it
+    reinterpret_cast<sdlnet_udpsocket_prefix*>(udp)->ready = 0;
+}
+#endif
+
+/*************************************************************************************************/
+Plteen::IUDPDaemon::IUDPDaemon(IUDPLocalPeer* peer, uint16_t port, int packet_size, int pool_size) {
     network_initialize();
 
     this->peer = peer;
@@ -24,7 +60,8 @@ Plteen::IUDPDaemon::IUDPDaemon(IUDPLocalPeer* peer, uint16_t port, int packet_si
             fprintf(stderr, "Error in binding UDP Address: %s!\n", SDLNet_GetError());
         }
 
-        this->packet = new UserDatagramPacket(packet_size);
+        this->pool = new UserDatagramPool(packet_size, (pool_size <= 0) ? 1 : pool_size);
+        this->reserve = new UserDatagramPacket(packet_size);
     }
 }
 
@@ -34,11 +71,16 @@ Plteen::IUDPDaemon::~IUDPDaemon() noexcept {
         this->self = nullptr;
     }
 
-    if (this->packet != nullptr) {
-        delete this->packet;
+    if (this->pool != nullptr) {
+        this->pool->release(this->pending);
+        delete this->pool;
+    }
+
+    if (this->reserve != nullptr) {
+        delete this->reserve;
     }
 
-    /* `this->peer` is managed by itself */
+    /* `this->peer` and `this->resolver` are managed by themselves */
 }
 
 bool Plteen::IUDPDaemon::okay() {
@@ -71,16 +113,17 @@ void Plteen::IUDPDaemon::unregister_from(SDLNet_SocketSet master) {
 
 /*************************************************************************************************/
 size_t Plteen::IUDPDaemon::packet_capacity() {
-    if (this->packet != nullptr) {
-        return this->packet->capacity();
+    if (this->pool != nullptr) {
+        return this->pool->capacity();
     } else {
         return 0;
     }
 }
 
 size_t Plteen::IUDPDaemon::packet_resize(size_t new_size) {
-    if (this->packet != nullptr) {
-        return this->packet->resize(new_size);
+    if (this->pool != nullptr) {
+        this->reserve->resize(new_size);
+        return this->pool->resize(new_size);
     } else {
         return 0;
     }
@@ -91,28 +134,154 @@ bool Plteen::IUDPDaemon::ready() {
 }
 
 bool Plteen::IUDPDaemon::recv_packet() {
-    if (this->okay() && (this->packet != nullptr)) {
-        return this->packet->recv(this->self);
-    } else {
-        return false;
+    bool okay = false;
+
+    if (this->okay() && (this->pool != nullptr)) {
+        if (this->pending == nullptr) {
+            this->pending = this->pool->acquire();
+        }
+
+        if (this->pending != nullptr) {
+            okay = (this->pending->packet->recv(this->self) > 0);
+        } else if (this->reserve->recv(this->self) > 0) {
+            // all slots are still leased by the peer, drain the socket anyway
+            this->dropped += 1U;
+        }
     }
+
+    return okay;
+}
+
+size_t Plteen::IUDPDaemon::recv_dispatch_packets(size_t batch) {
+    size_t total = 0U;
+
+    if (this->okay() && (this->pool != nullptr)) {
+#if defined(__udp_mmsg__)
+        int fd = udp_socket_descriptor(this->self);
+        UserDatagramSlot* slots[udp_mmsg_max_batch];
+        struct mmsghdr msgs[udp_mmsg_max_batch];
+        struct iovec iovs[udp_mmsg_max_batch];
+        struct sockaddr_in addrs[udp_mmsg_max_batch];
+        bool drained = false;
+
+        udp_socket_consumed(this->self);
+
+        while ((total < batch) && !drained) {
+            size_t quota = std::min(batch - total, udp_mmsg_max_batch);
+            size_t leased = 0U;
+            int received = 0;
+
+            while (leased < quota) {
+                UserDatagramSlot* slot = (this->pending != nullptr) ? this->pending : this->pool->acquire();
+
+                this->pending = nullptr;
+
+                if (slot == nullptr) {
+                    break;
+                }
+
+                slots[leased] = slot;
+                iovs[leased].iov_base = slot->packet->data();
+                iovs[leased].iov_len = slot->packet->capacity();
+                memset(&msgs[leased], 0, sizeof(struct mmsghdr));
+                msgs[leased].msg_hdr.msg_name = &addrs[leased];
+                msgs[leased].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+                msgs[leased].msg_hdr.msg_iov = &iovs[leased];
+                msgs[leased].msg_hdr.msg_iovlen = 1;
+                leased++;
+            }
+
+            if (leased > 0U) {
+                received = recvmmsg(fd, msgs, (unsigned int)(leased), MSG_DONTWAIT, nullptr);
+            } else if (this->reserve->recv(this->self) > 0) {
+                // all slots are still leased by the peer, drain the socket anyway
+                this->dropped += 1U;
+            }
+
+            if (received < int(leased)) {
+                drained = true;
+            }
+
+            for (int idx = 0; idx < received; idx++) {
+                slots[idx]->packet->set_received(msgs[idx].msg_len, addrs[idx].sin_addr.s_addr, addrs[idx].sin_port);
+                this->dispatch_slot(slots[idx]);
+            }
+
+            for (size_t idx = ((received > 0) ? received : 0); idx < leased; idx++) {
+                this->pool->release(slots[idx]);
+            }
+
+            if (leased == 0U) {
+                drained = true;
+            } else if (received > 0) {
+                total += received;
+            }
+        }
+#else
+        // SDL_net sockets are non-blocking, drain them up to the batch size within one wakeup
+        while ((total < batch) && this->recv_packet()) {
+            this->dispatch_packet();
+            total++;
+        }
+#endif
+    }
+
+    return total;
 }
 
 /*************************************************************************************************/
 void Plteen::IUDPDaemon::dispatch_packet() {
-    if ((this->peer != nullptr) && (!this->peer->absent())) {    
-        if (this->packet != nullptr) {
-            shared_datagram_t datagram = std::make_shared<Datagram>();
-            uint8_t type;
-        
-            datagram->timestamp = current_milliseconds();
-            datagram->remote_host = this->packet->hostname();
-            datagram->payload = this->packet->unbox(&type, &datagram->transaction, &datagram->respond_port, &datagram->payload_size);
+    if (this->pending != nullptr) {
+        UserDatagramSlot* slot = this->pending;
+
+        if ((this->peer != nullptr) && (!this->peer->absent())) {
+            this->pending = nullptr;
+            this->dispatch_slot(slot);
+        } else {
+            // the slot is kept for the next packet
+        }
+    }
+}
+
+void Plteen::IUDPDaemon::dispatch_slot(UserDatagramSlot* slot) {
+    if ((this->peer != nullptr) && (!this->peer->absent())) {
+        UserDatagramPacket* packet = slot->packet;
+        Datagram* datagram = &slot->datagram;
+        uint16_t port = packet->port();
+        uint8_t type;
+
+        datagram->timestamp = current_milliseconds();
+        datagram->remote_ipv4 = packet->host();
+        datagram->remote_port = SDLNet_Read16(&port);
+        datagram_numeric_host(datagram->remote_host, datagram->remote_ipv4);
+        datagram->payload = packet->unbox(&type, &datagram->transaction, &datagram->respond_port, &datagram->payload_size);
     
-            if (datagram->payload != nullptr) {
-                this->peer->on_user_datagram(this->service(), type, datagram);
+        if (datagram->payload != nullptr) {
+            if (this->resolver != nullptr) {
+                this->resolver->prefetch(datagram->remote_ipv4);
+            }
+
+            if (this->mailbox == nullptr) {
+                // the lease adopts the reference taken by `acquire()`
+                this->peer->on_user_datagram(this->service(), type, this->pool->lease(slot));
+            } else {
+                UDPMail mail;
+
+                mail.peer = this->peer;
+                mail.service = this->service();
+                mail.type = type;
+                mail.datagram = this->pool->lease(slot);
+
+                // the peer will be invoked by the game loop, see `SocketDaemon::deliver_mails()`
+                if (!this->mailbox->push(std::move(mail))) {
+                    this->dropped += 1U;
+                }
             }
+        } else {
+            this->pool->release(slot);
         }
+    } else {
+        this->pool->release(slot);
     }
 }
 
@@ -159,3 +328,76 @@ size_t Plteen::IUDPClient::packet_resize(size_t new_size) {
         return 0;
     }
 }
+
+/*************************************************************************************************/
+bool Plteen::IUDPClient::connect(const char* host, uint16_t port) {
+    // NOTE: this might block on DNS, resolve once and send many times
+    this->connected = (SDLNet_ResolveHost(&this->addrv4, host, port) == 0);
+
+    if (!this->connected) {
+        fprintf(stderr, "Error in resolving '%s:%d': %s!\n", host, port, SDLNet_GetError());
+    }
+
+    return this->connected;
+}
+
+bool Plteen::IUDPClient::send(const bytes& message) {
+    return (this->send_batch(&message, 1U) == 1U);
+}
+
+size_t Plteen::IUDPClient::send_batch(const bytes* messages, size_t count) {
+    size_t total = 0U;
+
+    if (this->okay() && this->connected) {
+#if defined(__udp_mmsg__)
+        int fd = udp_socket_descriptor(this->self);
+        struct mmsghdr msgs[udp_mmsg_max_batch];
+        struct iovec iovs[udp_mmsg_max_batch];
+        struct sockaddr_in target;
+
+        memset(&target, 0, sizeof(struct sockaddr_in));
+        target.sin_family = AF_INET;
+        target.sin_addr.s_addr = this->addrv4.host;
+        target.sin_port = this->addrv4.port;
+
+        while (total < count) {
+            size_t quota = std::min(count - total, udp_mmsg_max_batch);
+            int sent = 0;
+
+            for (size_t idx = 0; idx < quota; idx++) {
+                const bytes& message = messages[total + idx];
+
+                iovs[idx].iov_base = const_cast<unsigned char*>(message.data());
+                iovs[idx].iov_len = message.size();
+                memset(&msgs[idx], 0, sizeof(struct mmsghdr));
+                msgs[idx].msg_hdr.msg_name = &target;
+                msgs[idx].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+                msgs[idx].msg_hdr.msg_iov = &iovs[idx];
+                msgs[idx].msg_hdr.msg_iovlen = 1;
+            }
+
+            sent = sendmmsg(fd, msgs, (unsigned int)(quota), 0);
+
+            if (sent <= 0) {
+                perror("UDP send_batch");
+                break;
+            }
+
+            total += sent;
+        }
+#else
+        if (this->packet != nullptr) {
+            for (; total < count; total++) {
+                const bytes& message = messages[total];
+
+                if (this->packet->send(this->self, this->addrv4, message.data(), message.size()) < 0) {
+                    fprintf(stderr, "Error in sending UDP packet: %s!\n", SDLNet_GetError());
+                    break;
+                }
+            }
+        }
+#endif
+    }
+
+    return total;
+}
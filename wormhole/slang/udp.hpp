@@ -2,8 +2,13 @@
 
 #include <SDL2/SDL_net.h>
 #include <memory>
+#include <vector>
 
 #include "datagram.hpp"
+#include "resolver.hpp"
+
+#include "../../datum/bytes.hpp"
+#include "../../datum/queue.hpp"
 
 namespace Plteen {
     class __lambda__ IUDPLocalPeer {
@@ -14,10 +19,19 @@ namespace Plteen {
         virtual void on_user_datagram(uint16_t service, int type, const shared_datagram_t& datagram) = 0;
     };
 
+    struct __lambda__ UDPMail {
+        Plteen::IUDPLocalPeer* peer = nullptr;
+        uint16_t service = 0U;
+        int type = 0;
+        Plteen::shared_datagram_t datagram;
+    };
+
+    typedef Plteen::SPSCQueue<Plteen::UDPMail> UDPMailbox;
+
     /*********************************************************************************************/
     class __lambda__ IUDPDaemon {
     public:
-        IUDPDaemon(IUDPLocalPeer* peer, uint16_t service, int packet_size);
+        IUDPDaemon(IUDPLocalPeer* peer, uint16_t service, int packet_size, int pool_size = 64);
         virtual ~IUDPDaemon() noexcept;
 
     public:
@@ -35,12 +49,26 @@ namespace Plteen {
         size_t packet_resize(size_t new_size);
         bool recv_packet();
         void dispatch_packet();
+        size_t recv_dispatch_packets(size_t batch);
+
+    public:
+        void set_hostname_resolver(Plteen::HostnameResolver* resolver) { this->resolver = resolver; }
+        void set_mailbox(Plteen::UDPMailbox* mailbox) { this->mailbox = mailbox; }
+        uint64_t dropped_packet_count() { return this->dropped; }
+
+    private:
+        void dispatch_slot(Plteen::UserDatagramSlot* slot);
 
     private:
         UDPsocket self;
         IPaddress addrv4;
-        Plteen::UserDatagramPacket* packet = nullptr;
+        Plteen::UserDatagramPool* pool = nullptr;
+        Plteen::UserDatagramSlot* pending = nullptr;
+        Plteen::UserDatagramPacket* reserve = nullptr;
+        Plteen::HostnameResolver* resolver = nullptr;
+        Plteen::UDPMailbox* mailbox = nullptr;
         Plteen::IUDPLocalPeer* peer;
+        uint64_t dropped = 0U;
     };
 
     typedef std::shared_ptr<IUDPDaemon> shared_udp_daemon_t;
@@ -55,10 +83,17 @@ namespace Plteen {
         size_t packet_capacity();
         size_t packet_resize(size_t new_size);
 
+    public:
+        bool connect(const char* host, uint16_t port);
+        bool send(const Plteen::bytes& message);
+        size_t send_batch(const Plteen::bytes* messages, size_t count);
+        size_t send_batch(const std::vector<Plteen::bytes>& messages) { return this->send_batch(messages.data(), messages.size()); }
+
     private:
         UDPsocket self;
         IPaddress addrv4;
         Plteen::UserDatagramPacket* packet = nullptr;
+        bool connected = false;
     };
 
     /*********************************************************************************************/
@@ -76,8 +111,8 @@ namespace Plteen {
     template<typename E>
     class __lambda__ UDPDaemon : public Plteen::IUDPDaemon {
     public:
-        UDPDaemon(UDPLocalPeer<E>* peer, uint16_t service, int packet_size)
-            : IUDPDaemon(peer, service, packet_size) {}
+        UDPDaemon(UDPLocalPeer<E>* peer, uint16_t service, int packet_size, int pool_size = 64)
+            : IUDPDaemon(peer, service, packet_size, pool_size) {}
         virtual ~UDPDaemon() noexcept { /* do nothing */ }
     };
 }
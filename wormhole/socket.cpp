@@ -6,9 +6,11 @@
 using namespace Plteen;
 
 /*************************************************************************************************/
-Plteen::SocketDaemon::SocketDaemon(int maxsockets) {
+Plteen::SocketDaemon::SocketDaemon(int maxsockets, int max_batch) {
     int msckt = (maxsockets <= 0) ? 1 : maxsockets;
 
+    this->batch = (max_batch <= 0) ? 1U : size_t(max_batch);
+
     network_initialize();
     this->master = SDLNet_AllocSocketSet(msckt);
     this->fallback_timeout = msckt;
@@ -31,6 +33,11 @@ Plteen::SocketDaemon::~SocketDaemon() noexcept {
         SDLNet_FreeSocketSet(shadow);
     }
 
+    if (this->mailbox != nullptr) {
+        // undelivered leases have to be returned before the pools are gone
+        delete this->mailbox;
+    }
+
     this->udp_deamons.clear();
 }
 
@@ -42,6 +49,8 @@ bool Plteen::SocketDaemon::udp_listen(IUDPDaemon* daemon) {
         shared_udp_daemon_t udp(daemon);
         
         if (udp->okay()) {
+            udp->set_mailbox(this->mailbox);
+
             if (udp->register_to(this->master)) {
                 this->udp_deamons[service] = udp;
             } else {
@@ -71,15 +80,90 @@ void Plteen::SocketDaemon::wait_read_process_loop(int timeout_ms) {
         ready = SDLNet_CheckSockets(this->master, timeout);
 
         if (ready > 0) {
+            size_t total = 0U;
+
             for (auto it : this->udp_deamons) {
                 if (it.second->ready()) {
-                    if (it.second->recv_packet()) {
-                        it.second->dispatch_packet();
-                    }
+                    // drain the burst within one wakeup
+                    total += it.second->recv_dispatch_packets(this->batch);
                 }
             }
+
+            if ((total > 0U) && (this->mailbox != nullptr)) {
+                this->notify_mails_arrived();
+            }
         } else if (ready < 0) {
             perror("WaitReadProcessLoop");
         }
     }
 }
+
+/*************************************************************************************************/
+bool Plteen::SocketDaemon::enable_mailbox(size_t capacity, bool wakeup) {
+    // NOTE: the mailbox should be enabled before the loop starts 
+    if ((this->mailbox == nullptr) && (this->wrpl == nullptr)) {
+        this->mailbox = new UDPMailbox((capacity == 0U) ? 1U : capacity);
+        this->mailbox_wakeup = wakeup;
+        this->mailbox_idle = wakeup;
+
+        for (auto it : this->udp_deamons) {
+            it.second->set_mailbox(this->mailbox);
+        }
+    }
+
+    return (this->mailbox != nullptr);
+}
+
+size_t Plteen::SocketDaemon::deliver_mails(size_t budget) {
+    size_t total = 0U;
+
+    if (this->mailbox != nullptr) {
+        UDPMail mail;
+
+        while (((budget == 0U) || (total < budget)) && this->mailbox->pop(&mail)) {
+            if ((mail.peer != nullptr) && !mail.peer->absent()) {
+                mail.peer->on_user_datagram(mail.service, mail.type, mail.datagram);
+            }
+
+            mail.datagram.reset();
+            total ++;
+        }
+
+        if (this->mailbox_wakeup) {
+            if (this->mailbox->empty()) {
+                this->mailbox_idle.store(true);
+
+                // mails might arrive right before going idle
+                if (!this->mailbox->empty()) {
+                    this->notify_mails_arrived();
+                }
+            } else {
+                // out of budget, still busy, no one else would wake the game loop up for the rest
+                this->post_mailbox_wakeup();
+            }
+        }
+    }
+
+    return total;
+}
+
+size_t Plteen::SocketDaemon::undelivered_mail_count() {
+    return (this->mailbox == nullptr) ? 0U : this->mailbox->size();
+}
+
+void Plteen::SocketDaemon::notify_mails_arrived() {
+    if (this->mailbox_idle.exchange(false)) {
+        this->post_mailbox_wakeup();
+    }
+}
+
+void Plteen::SocketDaemon::post_mailbox_wakeup() {
+    SDL_Event wakeup;
+
+    SDL_zero(wakeup);
+    wakeup.type = SDL_USEREVENT;
+    wakeup.user.code = socket_mailbox_wakeup_code;
+    wakeup.user.data1 = this;
+    
+    SDL_PushEvent(&wakeup);
+}
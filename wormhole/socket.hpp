@@ -3,26 +3,35 @@
 #include <SDL2/SDL_net.h>
 
 #include <thread>
+#include <atomic>
 #include <map>
 
 #include "slang/udp.hpp"
 
 /**************************************************************************************************/
 namespace Plteen {
+    // the `code` of the `SDL_USEREVENT` that wakes up an idle game loop when mails arrive
+    static const int32_t socket_mailbox_wakeup_code = 0x4D41494C; // 'MAIL'
+
     class __lambda__ SocketDaemon {
     public:
-        SocketDaemon(int maxsockets = 16);
+        SocketDaemon(int maxsockets = 16, int max_batch = 32);
         virtual ~SocketDaemon() noexcept;
 
     public:
         template<typename E>
-        bool udp_listen(Plteen::UDPLocalPeer<E>* peer, uint16_t service, int packet_capacity = 512) {
-            return this->udp_listen(new Plteen::UDPDaemon<E>(peer, service, packet_capacity));
+        bool udp_listen(Plteen::UDPLocalPeer<E>* peer, uint16_t service, int packet_capacity = 512, int pool_size = 64) {
+            return this->udp_listen(new Plteen::UDPDaemon<E>(peer, service, packet_capacity, pool_size));
         }
 
     public:
         void start_wait_read_process_loop(int timeout_ms);
 
+    public: // hand datagrams over to the game loop instead of invoking peers in the network thread
+        bool enable_mailbox(size_t capacity = 1024U, bool wakeup = false);
+        size_t deliver_mails(size_t budget = 0U);
+        size_t undelivered_mail_count();
+
     private:
         void wait_read_process_loop(int timeout_ms);
 
@@ -33,8 +42,18 @@ namespace Plteen {
         SDLNet_SocketSet master = nullptr;
         std::map<uint16_t, shared_udp_daemon_t> udp_deamons;
 
+    private:
+        void notify_mails_arrived();
+        void post_mailbox_wakeup();
+
+    private:
+        Plteen::UDPMailbox* mailbox = nullptr;
+        std::atomic<bool> mailbox_idle { false };
+        bool mailbox_wakeup = false;
+
     private:
         std::thread* wrpl = nullptr;
         int fallback_timeout = 1;
+        size_t batch = 1U;
     };
 }